@@ -0,0 +1,20 @@
+# Regra compartilhada pelo firmware e pela simulação (host/): tools/gen_display_assets.py
+# converte inc/font.txt e inc/screens.txt em generated/display_assets.{c,h} no
+# diretório de build. O Pico SDK já exige Python 3.
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(DISPLAY_ASSETS_SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR})
+set(DISPLAY_ASSETS_DIR ${CMAKE_CURRENT_BINARY_DIR}/generated)
+
+add_custom_command(
+    OUTPUT ${DISPLAY_ASSETS_DIR}/display_assets.c ${DISPLAY_ASSETS_DIR}/display_assets.h
+    COMMAND ${Python3_EXECUTABLE} ${DISPLAY_ASSETS_SOURCE_DIR}/tools/gen_display_assets.py
+            --font ${DISPLAY_ASSETS_SOURCE_DIR}/inc/font.txt
+            --screens ${DISPLAY_ASSETS_SOURCE_DIR}/inc/screens.txt
+            --out-dir ${DISPLAY_ASSETS_DIR}
+    DEPENDS ${DISPLAY_ASSETS_SOURCE_DIR}/tools/gen_display_assets.py
+            ${DISPLAY_ASSETS_SOURCE_DIR}/inc/font.txt
+            ${DISPLAY_ASSETS_SOURCE_DIR}/inc/screens.txt
+    COMMENT "Gerando fonte e telas do display"
+    VERBATIM
+)
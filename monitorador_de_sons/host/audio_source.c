@@ -0,0 +1,147 @@
+#include <string.h>
+#include "audio_source.h"
+
+#define WAVE_FORMAT_PCM 1
+#define WAVE_FORMAT_FLOAT 3
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+static uint32_t le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t le16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+// Procura os blocos "fmt " e "data"; deixa o arquivo no início das amostras
+static bool parse_wav_header(audio_source_t *src) {
+    uint8_t riff[12];
+    if (fread(riff, 1, 12, src->file) != 12 || memcmp(riff, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4)) {
+        fprintf(stderr, "sim: arquivo não é RIFF/WAVE\n");
+        return false;
+    }
+
+    bool have_fmt = false;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, src->file) == 8) {
+        uint32_t size = le32(chunk + 4);
+        if (!memcmp(chunk, "fmt ", 4)) {
+            uint8_t fmt[40] = {0};
+            uint32_t n = size < sizeof(fmt) ? size : sizeof(fmt);
+            if (size < 16 || fread(fmt, 1, n, src->file) != n) return false;
+            fseek(src->file, (long)(size - n + (size & 1)), SEEK_CUR);
+            src->format = le16(fmt);
+            src->channels = le16(fmt + 2);
+            src->rate = le32(fmt + 4);
+            src->bits = le16(fmt + 14);
+            if (src->format == WAVE_FORMAT_EXTENSIBLE && size >= 26) src->format = le16(fmt + 24);
+            have_fmt = true;
+        } else if (!memcmp(chunk, "data", 4)) {
+            if (!have_fmt) break;
+            src->data_left = size;
+            src->frame_bytes = src->channels * (src->bits / 8);
+            bool supported = (src->format == WAVE_FORMAT_PCM && (src->bits == 8 || src->bits == 16 || src->bits == 24 || src->bits == 32))
+                          || (src->format == WAVE_FORMAT_FLOAT && src->bits == 32);
+            if (!supported || src->channels == 0) {
+                fprintf(stderr, "sim: formato WAV não suportado (formato %u, %u bits)\n", src->format, src->bits);
+                return false;
+            }
+            return true;
+        } else {
+            fseek(src->file, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fprintf(stderr, "sim: WAV sem blocos fmt/data\n");
+    return false;
+}
+
+bool audio_source_open(audio_source_t *src, const char *path, bool raw, double gain) {
+    memset(src, 0, sizeof(*src));
+    src->file = fopen(path, "rb");
+    if (!src->file) {
+        perror(path);
+        return false;
+    }
+    src->raw = raw;
+    src->gain = gain;
+    src->step = 1.0;
+    if (raw) {
+        src->frame_bytes = 2;
+        src->data_left = UINT64_MAX;
+        return true;
+    }
+    return parse_wav_header(src);
+}
+
+// Taxa do ADC simulado. Entradas brutas já estão nessa taxa.
+void audio_source_set_output_rate(audio_source_t *src, double rate) {
+    src->step = src->raw ? 1.0 : src->rate / rate;
+}
+
+static const uint8_t *read_frame(audio_source_t *src) {
+    if (src->data_left < src->frame_bytes) return NULL;
+    if (src->buffer_len - src->buffer_pos < src->frame_bytes) {
+        size_t keep = src->buffer_len - src->buffer_pos;
+        memmove(src->buffer, src->buffer + src->buffer_pos, keep);
+        src->buffer_len = keep + fread(src->buffer + keep, 1, AUDIO_SOURCE_BUFFER - keep, src->file);
+        src->buffer_pos = 0;
+        if (src->buffer_len < src->frame_bytes) return NULL;
+    }
+    const uint8_t *frame = src->buffer + src->buffer_pos;
+    src->buffer_pos += src->frame_bytes;
+    src->data_left -= src->frame_bytes;
+    return frame;
+}
+
+// Próxima amostra de entrada como código do ADC (ainda sem arredondar)
+static bool read_sample(audio_source_t *src, double *value) {
+    const uint8_t *p = read_frame(src);
+    if (!p) return false;
+    if (src->raw) {
+        *value = le16(p) & 0x0FFF;
+        return true;
+    }
+
+    double x;
+    switch (src->bits) {
+        case 8: x = (p[0] - 128) / 128.0; break;
+        case 16: x = (int16_t)le16(p) / 32768.0; break;
+        case 24: x = ((int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8) / 8388608.0; break;
+        default:
+            if (src->format == WAVE_FORMAT_FLOAT) {
+                float f;
+                uint32_t u = le32(p);
+                memcpy(&f, &u, sizeof(f));
+                x = f;
+            } else {
+                x = (int32_t)le32(p) / 2147483648.0;
+            }
+    }
+    *value = 2048.0 + x * 2048.0 * src->gain;
+    return true;
+}
+
+bool audio_source_next(audio_source_t *src, uint16_t *adc_value) {
+    if (!src->primed) {
+        if (!read_sample(src, &src->prev)) return false;
+        if (!read_sample(src, &src->next)) src->next = src->prev;
+        src->primed = true;
+    }
+    while (src->phase >= 1.0) {
+        src->prev = src->next;
+        if (!read_sample(src, &src->next)) return false;
+        src->phase -= 1.0;
+    }
+
+    double value = src->prev + (src->next - src->prev) * src->phase;
+    src->phase += src->step;
+    if (value < 0) value = 0;
+    if (value > 4095) value = 4095;
+    *adc_value = (uint16_t)(value + 0.5);
+    return true;
+}
+
+void audio_source_close(audio_source_t *src) {
+    if (src->file) fclose(src->file);
+    src->file = NULL;
+}
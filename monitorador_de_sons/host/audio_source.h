@@ -0,0 +1,42 @@
+#ifndef AUDIO_SOURCE_H
+#define AUDIO_SOURCE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Fonte de amostras do ADC simulado: arquivo WAV (PCM inteiro de 8/16/24/32 bits
+ou float de 32 bits, só o primeiro canal) ou bruto (uint16 little-endian com os
+códigos de 12 bits do ADC, já na taxa do firmware).
+
+WAVs em outra taxa são reamostrados por interpolação linear. Um WAV em fundo de
+escala com `gain` 1.0 ocupa toda a faixa do ADC em torno de 2048.
+*/
+
+#define AUDIO_SOURCE_BUFFER 65536
+
+typedef struct {
+    FILE *file;
+    bool raw;
+    uint16_t format, channels, bits;
+    uint32_t rate;
+    uint32_t frame_bytes;
+    uint64_t data_left;  // Bytes restantes no bloco "data"
+    double gain;
+
+    // Reamostragem
+    double step, phase;
+    double prev, next;
+    bool primed;
+
+    uint8_t buffer[AUDIO_SOURCE_BUFFER];
+    size_t buffer_len, buffer_pos;
+} audio_source_t;
+
+bool audio_source_open(audio_source_t *src, const char *path, bool raw, double gain);
+void audio_source_set_output_rate(audio_source_t *src, double rate);
+bool audio_source_next(audio_source_t *src, uint16_t *adc_value);
+void audio_source_close(audio_source_t *src);
+
+#endif
@@ -0,0 +1,661 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "hardware/uart.h"
+#include "tusb.h"
+#include "hal_sim.h"
+
+#define SIM_MAX_ALARMS 16
+#define ADC_CLOCK_HZ 48000000.0
+#define ADC_TEMPERATURE_CODE 876  // 0,706 V: 27 °C no sensor do RP2040
+#define OLED_WIDTH 128
+#define OLED_PAGES 8
+#define CDC_FIFO_BYTES 256
+#define CDC_BYTES_PER_MS 1000  // Vazão típica de bulk em full speed
+
+static sim_options_t options;
+static audio_source_t *source;
+static uint64_t now_us = 0;
+static struct timespec wall_start;
+
+// ---------------------------------------------------------------------------
+// Estatísticas da simulação
+
+static uint64_t adc_blocks = 0, adc_samples = 0;
+static uint32_t alerts = 0, display_frames = 0, led_frames = 0;
+static uint64_t display_bytes = 0;
+static uint64_t telemetry_bytes = 0;
+static FILE *telemetry_file = NULL;
+static uint64_t stream_bytes = 0;
+static FILE *stream_file = NULL;
+static uint32_t flash_erases = 0, flash_programs = 0;
+
+static void format_time(uint64_t us, char *out, size_t len) {
+    uint64_t ms = us / 1000;
+    snprintf(out, len, "%02u:%02u:%02u.%03u", (uint)(ms / 3600000), (uint)(ms / 60000 % 60), (uint)(ms / 1000 % 60), (uint)(ms % 1000));
+}
+
+// ---------------------------------------------------------------------------
+// Tempo e alarmes
+
+typedef struct {
+    alarm_id_t id;
+    uint64_t due_us;
+    alarm_callback_t callback;
+    void *user_data;
+} sim_alarm_t;
+
+static sim_alarm_t alarms[SIM_MAX_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+
+absolute_time_t get_absolute_time(void) { return now_us; }
+uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+uint64_t time_us_64(void) { return now_us; }
+uint32_t time_us_32(void) { return (uint32_t)now_us; }
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    if (us == 0 && !fire_if_past) return 0;
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        if (alarms[i].id != 0) continue;
+        alarms[i] = (sim_alarm_t){next_alarm_id++, now_us + us, callback, user_data};
+        if (next_alarm_id <= 0) next_alarm_id = 1;
+        return alarms[i].id;
+    }
+    return -1;
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_in_us((uint64_t)ms * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        if (alarms[i].id == id) {
+            alarms[i].id = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void fire_alarm(sim_alarm_t *alarm) {
+    sim_alarm_t copy = *alarm;
+    alarm->id = 0;
+    int64_t again = copy.callback(copy.id, copy.user_data);
+    if (again == 0) return;
+    // Mesma semântica do SDK: > 0 a partir do prazo anterior, < 0 a partir de agora
+    copy.due_us = again > 0 ? copy.due_us + (uint64_t)again : now_us - again;
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        if (alarms[i].id == 0) {
+            alarms[i] = copy;
+            return;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Periféricos simples
+
+void stdio_init_all(void) {}
+int getchar_timeout_us(uint32_t timeout_us) {
+    if (!options.serial_input || !*options.serial_input) return PICO_ERROR_TIMEOUT;
+    return (unsigned char)*options.serial_input++;
+}
+void gpio_init(uint gpio) {}
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_pull_up(uint gpio) {}
+bool gpio_get(uint gpio) { return true; }
+void gpio_set_function(uint gpio, enum gpio_function fn) {}
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback) {}
+
+uint32_t clock_get_hz(enum clock_index clk_index) { return 125000000; }
+
+void multicore_launch_core1(void (*entry)(void)) {
+    fprintf(stderr, "sim: o core 1 não é simulado; compile com ANALYSIS_ON_CORE1=0\n");
+    exit(2);
+}
+
+static irq_handler_t dma_irq0_handler = NULL;
+static bool dma_irq0_enabled = false;
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num == DMA_IRQ_0) dma_irq0_handler = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num == DMA_IRQ_0) dma_irq0_enabled = enabled;
+}
+
+static bool buzzers_on = false;
+static uint64_t buzzers_on_since = 0;
+
+uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1) & 7; }
+void pwm_set_clkdiv(uint slice_num, float divider) {}
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {}
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) {}
+
+// Só o slice dos buzzers é ligado e desligado pelo firmware em execução
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    if (enabled == buzzers_on) return;
+    char t[16];
+    format_time(now_us, t, sizeof(t));
+    if (enabled) {
+        alerts++;
+        buzzers_on_since = now_us;
+        fprintf(stderr, "[%s] alerta: buzzers ligados\n", t);
+    } else {
+        fprintf(stderr, "[%s] alerta: buzzers desligados após %u ms\n", t, (uint)((now_us - buzzers_on_since) / 1000));
+    }
+    buzzers_on = enabled;
+}
+
+pio_hw_t pio0_hw;
+int pio_claim_unused_sm(PIO pio, bool required) { return 0; }
+uint pio_add_program(PIO pio, const pio_program_t *program) { return 0; }
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {}
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) { return sm; }
+
+struct uart_inst { uart_hw_t hw; };
+static struct uart_inst uart_instances[2];
+uart_inst_t *const uart0 = &uart_instances[0];
+uart_inst_t *const uart1 = &uart_instances[1];
+
+uint uart_init(uart_inst_t *uart, uint baudrate) { return baudrate; }
+uart_hw_t *uart_get_hw(uart_inst_t *uart) { return &uart->hw; }
+uint uart_get_dreq(uart_inst_t *uart, bool is_tx) { return uart == uart0 ? DREQ_UART0_TX : DREQ_UART1_TX; }
+
+// ---------------------------------------------------------------------------
+// CDC do USB: o FIFO esvazia conforme o tempo virtual passa, então um envio
+// que não acompanhe a vazão do USB perde blocos como no hardware
+
+static uint32_t cdc_fifo_used = 0;
+static uint64_t cdc_drained_at_us = 0;
+
+static void cdc_drain(void) {
+    uint64_t drained = (now_us - cdc_drained_at_us) * CDC_BYTES_PER_MS / 1000;
+    if (drained == 0) return;
+    cdc_fifo_used = drained >= cdc_fifo_used ? 0 : cdc_fifo_used - (uint32_t)drained;
+    cdc_drained_at_us = now_us;
+}
+
+bool tud_cdc_connected(void) { return stream_file != NULL; }
+
+uint32_t tud_cdc_write_available(void) {
+    cdc_drain();
+    return CDC_FIFO_BYTES - cdc_fifo_used;
+}
+
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize) {
+    uint32_t n = tud_cdc_write_available();
+    if (n > bufsize) n = bufsize;
+    if (stream_file) fwrite(buffer, 1, n, stream_file);
+    cdc_fifo_used += n;
+    stream_bytes += n;
+    return n;
+}
+
+uint32_t tud_cdc_write_flush(void) { return 0; }
+
+// ---------------------------------------------------------------------------
+// Flash
+
+uint8_t hal_sim_flash[PICO_FLASH_SIZE_BYTES];
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "sim: apagamento fora do alinhamento de setor (0x%x, %zu)\n", flash_offs, count);
+        exit(3);
+    }
+    memset(hal_sim_flash + flash_offs, 0xFF, count);
+    flash_erases++;
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "sim: programação fora do alinhamento de página (0x%x, %zu)\n", flash_offs, count);
+        exit(3);
+    }
+    for (size_t i = 0; i < count; i++) hal_sim_flash[flash_offs + i] &= data[i];
+    flash_programs++;
+}
+
+static void flash_load(void) {
+    memset(hal_sim_flash, 0xFF, sizeof(hal_sim_flash));
+    FILE *f = options.flash_path ? fopen(options.flash_path, "rb") : NULL;
+    if (!f) return;  // Ainda não existe: flash apagada
+    if (fread(hal_sim_flash, 1, sizeof(hal_sim_flash), f) != sizeof(hal_sim_flash)) {
+        fprintf(stderr, "sim: imagem da flash %s incompleta\n", options.flash_path);
+        exit(2);
+    }
+    fclose(f);
+}
+
+static void flash_save(void) {
+    FILE *f = options.flash_path ? fopen(options.flash_path, "wb") : NULL;
+    if (!f) return;
+    fwrite(hal_sim_flash, 1, sizeof(hal_sim_flash), f);
+    fclose(f);
+}
+
+// ---------------------------------------------------------------------------
+// SSD1306 simulado
+
+static struct {
+    uint8_t ram[OLED_PAGES][OLED_WIDTH];
+    bool in_transaction, expect_control, single_byte, data_mode, wrote_data;
+    uint8_t command[8], command_len, command_need;
+    uint8_t mode, col0, col1, page0, page1, col, page;
+} oled = {.mode = 2, .col1 = OLED_WIDTH - 1, .page1 = OLED_PAGES - 1};
+
+static void oled_write_pbm(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return;
+    }
+    fprintf(f, "P4\n%d %d\n", OLED_WIDTH, OLED_PAGES * 8);
+    for (int y = 0; y < OLED_PAGES * 8; y++) {
+        for (int x = 0; x < OLED_WIDTH; x += 8) {
+            uint8_t row = 0;
+            for (int b = 0; b < 8; b++) {
+                if (oled.ram[y >> 3][x + b] & (1 << (y & 7))) row |= 0x80 >> b;
+            }
+            fputc(row, f);
+        }
+    }
+    fclose(f);
+}
+
+static uint8_t oled_command_args(uint8_t command) {
+    switch (command) {
+        case 0x21: case 0x22: return 2;
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+        default: return 0;
+    }
+}
+
+static void oled_execute(void) {
+    switch (oled.command[0]) {
+        case 0x20: oled.mode = oled.command[1] & 3; break;
+        case 0x21: oled.col = oled.col0 = oled.command[1] & 0x7F; oled.col1 = oled.command[2] & 0x7F; break;
+        case 0x22: oled.page = oled.page0 = oled.command[1] & 7; oled.page1 = oled.command[2] & 7; break;
+    }
+}
+
+static void oled_data(uint8_t byte) {
+    oled.ram[oled.page][oled.col] = byte;
+    oled.wrote_data = true;
+    if (oled.mode == 1) {  // Vertical
+        if (++oled.page > oled.page1) {
+            oled.page = oled.page0;
+            if (++oled.col > oled.col1) oled.col = oled.col0;
+        }
+    } else if (oled.mode == 0) {  // Horizontal
+        if (++oled.col > oled.col1) {
+            oled.col = oled.col0;
+            if (++oled.page > oled.page1) oled.page = oled.page0;
+        }
+    } else {
+        oled.col = (oled.col + 1) & 0x7F;
+    }
+}
+
+static void oled_frame_done(void) {
+    display_frames++;
+    if (!options.display_dir) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%06u_%010llu.pbm", options.display_dir, display_frames, (unsigned long long)(now_us / 1000));
+    oled_write_pbm(path);
+}
+
+// Um byte da transação I2C; o primeiro de cada transação é o byte de controle
+static void oled_byte(uint8_t byte, bool stop) {
+    if (!oled.in_transaction || oled.expect_control) {
+        if (!oled.in_transaction) oled.wrote_data = false;
+        oled.in_transaction = true;
+        oled.expect_control = false;
+        oled.data_mode = byte & 0x40;
+        oled.single_byte = byte & 0x80;  // Co = 1: só o próximo byte usa este controle
+    } else {
+        if (oled.data_mode) {
+            oled_data(byte);
+        } else {
+            if (oled.command_len == 0) oled.command_need = 1 + oled_command_args(byte);
+            oled.command[oled.command_len++] = byte;
+            if (oled.command_len == oled.command_need) {
+                oled_execute();
+                oled.command_len = 0;
+            }
+        }
+        if (oled.single_byte) oled.expect_control = true;
+    }
+    if (stop) {
+        oled.in_transaction = false;
+        oled.expect_control = false;
+        if (oled.wrote_data) oled_frame_done();
+    }
+}
+
+struct i2c_inst { i2c_hw_t hw; };
+static struct i2c_inst i2c_instances[2] = {
+    {.hw = {.status = I2C_IC_STATUS_TFE_BITS}},
+    {.hw = {.status = I2C_IC_STATUS_TFE_BITS}}
+};
+i2c_inst_t *const i2c0 = &i2c_instances[0];
+i2c_inst_t *const i2c1 = &i2c_instances[1];
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) { return baudrate; }
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) { return &i2c->hw; }
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) { return i2c == i2c0 ? DREQ_I2C0_TX : DREQ_I2C1_TX; }
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    for (size_t i = 0; i < len; i++) oled_byte(src[i], i == len - 1 && !nostop);
+    return (int)len;
+}
+
+// ---------------------------------------------------------------------------
+// ADC
+
+static adc_hw_t adc_regs;
+adc_hw_t *const adc_hw = &adc_regs;
+static bool adc_running = false;
+static double adc_period_us = 1.0 / 48.0 * 96.0;  // Padrão do RP2040: 500 kS/s
+static uint64_t adc_run_start_us = 0, adc_run_start_sample = 0;
+static uint adc_input = 0, adc_rr_mask = 0;
+static uint16_t adc_audio_value = 0;
+
+// A fonte de áudio anda uma amostra por volta do rodízio
+static uint adc_inputs_per_frame(void) {
+    return adc_rr_mask ? (uint)__builtin_popcount(adc_rr_mask) : 1;
+}
+
+static void adc_update_source_rate(void) {
+    audio_source_set_output_rate(source, 1e6 / adc_period_us / adc_inputs_per_frame());
+}
+
+void adc_init(void) {}
+void adc_gpio_init(uint gpio) {}
+void adc_select_input(uint input) { adc_input = input; }
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {}
+void adc_fifo_drain(void) {}
+void adc_set_temp_sensor_enabled(bool enable) {}
+
+void adc_set_round_robin(uint input_mask) {
+    adc_rr_mask = input_mask & 0x1F;
+    adc_update_source_rate();
+}
+
+void adc_set_clkdiv(float clkdiv) {
+    double period_cycles = clkdiv < 96 ? 96 : 1.0 + clkdiv;
+    adc_period_us = period_cycles * 1e6 / ADC_CLOCK_HZ;
+    adc_update_source_rate();
+}
+
+// Uma conversão na entrada atual, avançando o rodízio como o hardware (ordem crescente)
+static uint16_t adc_convert(void) {
+    uint input = adc_input;
+    uint mics = adc_rr_mask & 0xF;
+    if (adc_rr_mask) {
+        uint next = (input + 1) % 5;
+        while (!(adc_rr_mask & (1u << next))) next = (next + 1) % 5;
+        adc_input = next;
+    }
+    if (input == 4) return ADC_TEMPERATURE_CODE;
+    if (!mics || input == (uint)__builtin_ctz(mics)) {
+        if (!audio_source_next(source, &adc_audio_value)) hal_sim_finish();
+    }
+    return adc_audio_value;
+}
+
+void adc_run(bool run) {
+    if (run && !adc_running) {
+        adc_run_start_us = now_us;
+        adc_run_start_sample = adc_samples;
+    }
+    adc_running = run;
+}
+
+// Instante em que a amostra de índice `sample` fica pronta
+static uint64_t adc_sample_time(uint64_t sample) {
+    return adc_run_start_us + (uint64_t)((sample - adc_run_start_sample + 1) * adc_period_us);
+}
+
+// ---------------------------------------------------------------------------
+// DMA
+
+typedef struct {
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+    bool busy, irq0;
+} sim_dma_channel_t;
+
+static sim_dma_channel_t channels[NUM_DMA_CHANNELS];
+static uint claimed_channels = 0;
+static dma_hw_t dma_regs;
+dma_hw_t *const dma_hw = &dma_regs;
+
+static void dma_trigger(uint channel);
+
+int dma_claim_unused_channel(bool required) {
+    if (claimed_channels < NUM_DMA_CHANNELS) return claimed_channels++;
+    if (required) {
+        fprintf(stderr, "sim: sem canais de DMA livres\n");
+        exit(2);
+    }
+    return -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    return (dma_channel_config){.size = DMA_SIZE_32, .read_increment = true, .write_increment = false, .dreq = DREQ_FORCE, .chain_to = channel};
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) { c->size = size; }
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) { c->read_increment = incr; }
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) { c->write_increment = incr; }
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) { c->dreq = dreq; }
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) { c->chain_to = chain_to; }
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr, const volatile void *read_addr, uint transfer_count, bool trigger) {
+    sim_dma_channel_t *ch = &channels[channel];
+    ch->config = *config;
+    ch->write_addr = write_addr;
+    ch->read_addr = read_addr;
+    ch->count = transfer_count;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+    channels[channel].write_addr = write_addr;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    channels[channel].read_addr = read_addr;
+    channels[channel].count = transfer_count;
+    dma_trigger(channel);
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    channels[channel].irq0 = enabled;
+    if (enabled) dma_regs.inte0 |= 1u << channel;
+    else dma_regs.inte0 &= ~(1u << channel);
+    dma_regs.ints0 = dma_regs.intr & dma_regs.inte0;
+}
+
+bool dma_channel_get_irq0_status(uint channel) { return dma_regs.ints0 & (1u << channel); }
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    dma_regs.intr &= ~(1u << channel);
+    dma_regs.ints0 = dma_regs.intr & dma_regs.inte0;
+}
+
+bool dma_channel_is_busy(uint channel) { return channels[channel].busy; }
+void dma_channel_abort(uint channel) { channels[channel].busy = false; }
+void dma_channel_wait_for_finish_blocking(uint channel) {}
+
+// O abort escrito direto em dma_hw é concluído na primeira espera do firmware
+void tight_loop_contents(void) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (dma_regs.abort & (1u << ch)) channels[ch].busy = false;
+    }
+    dma_regs.abort = 0;
+}
+
+static uint32_t dma_read(const volatile void *addr, uint8_t size) {
+    switch (size) {
+        case DMA_SIZE_8: return *(const volatile uint8_t *)addr;
+        case DMA_SIZE_16: return *(const volatile uint16_t *)addr;
+        default: return *(const volatile uint32_t *)addr;
+    }
+}
+
+// Escrita do DMA em um registrador: entrega o valor ao periférico simulado
+static void dma_write_peripheral(volatile void *addr, uint32_t value) {
+    if (addr == &i2c0->hw.data_cmd || addr == &i2c1->hw.data_cmd) {
+        display_bytes++;
+        oled_byte(value & 0xFF, value & I2C_IC_DATA_CMD_STOP_BITS);
+    } else if (addr == &uart0->hw.dr || addr == &uart1->hw.dr) {
+        telemetry_bytes++;
+        if (telemetry_file) fputc(value & 0xFF, telemetry_file);
+    }
+}
+
+static void dma_complete(uint channel) {
+    sim_dma_channel_t *ch = &channels[channel];
+    ch->busy = false;
+    dma_regs.intr |= 1u << channel;
+    dma_regs.ints0 = dma_regs.intr & dma_regs.inte0;
+    if ((volatile void *)ch->write_addr >= (volatile void *)pio0_hw.txf && (volatile void *)ch->write_addr < (volatile void *)(pio0_hw.txf + 4)) led_frames++;
+    if (ch->config.chain_to != channel) dma_trigger(ch->config.chain_to);
+}
+
+// Canais do ADC ficam ocupados até o tempo virtual chegar ao fim do bloco; os
+// demais transferem tudo na hora.
+static void dma_trigger(uint channel) {
+    sim_dma_channel_t *ch = &channels[channel];
+    ch->busy = true;
+    if (ch->config.dreq == DREQ_ADC) return;
+
+    uint8_t step = 1 << ch->config.size;
+    const volatile uint8_t *read = ch->read_addr;
+    volatile uint8_t *write = ch->write_addr;
+    for (uint32_t i = 0; i < ch->count; i++) {
+        uint32_t value = dma_read(read, ch->config.size);
+        if (ch->config.write_increment) {
+            memcpy((void *)write, &value, step);
+            write += step;
+        } else {
+            dma_write_peripheral(write, value);
+        }
+        if (ch->config.read_increment) read += step;
+    }
+    dma_complete(channel);
+}
+
+static int adc_dma_channel(void) {
+    for (uint i = 0; i < claimed_channels; i++) {
+        if (channels[i].busy && channels[i].config.dreq == DREQ_ADC) return i;
+    }
+    return -1;
+}
+
+// Enche o bloco do canal do ADC com a fonte de áudio e sinaliza o término
+static void adc_dma_finish_block(uint channel) {
+    sim_dma_channel_t *ch = &channels[channel];
+    volatile uint16_t *write = ch->write_addr;
+    for (uint32_t i = 0; i < ch->count; i++) {
+        write[i] = adc_convert();
+        adc_samples++;
+    }
+    adc_blocks++;
+    dma_complete(channel);
+    if (dma_irq0_enabled && dma_irq0_handler && dma_regs.ints0) dma_irq0_handler();
+}
+
+// ---------------------------------------------------------------------------
+// Sono: avança o relógio virtual até o próximo evento
+
+void __wfi(void) {
+    sim_alarm_t *alarm = NULL;
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        if (alarms[i].id != 0 && (!alarm || alarms[i].due_us < alarm->due_us)) alarm = &alarms[i];
+    }
+    int adc_channel = adc_running ? adc_dma_channel() : -1;
+    uint64_t adc_due = adc_channel >= 0 ? adc_sample_time(adc_samples + channels[adc_channel].count - 1) : UINT64_MAX;
+
+    if (!alarm && adc_channel < 0) {
+        fprintf(stderr, "sim: nenhum evento pendente, o firmware dormiria para sempre\n");
+        hal_sim_finish();
+    }
+
+    if (adc_channel >= 0 && (!alarm || adc_due <= alarm->due_us)) {
+        if (adc_due > now_us) now_us = adc_due;
+        adc_dma_finish_block(adc_channel);
+    } else {
+        if (alarm->due_us > now_us) now_us = alarm->due_us;
+        fire_alarm(alarm);
+    }
+
+    if (options.max_seconds > 0 && now_us >= (uint64_t)(options.max_seconds * 1e6)) hal_sim_finish();
+}
+
+// ---------------------------------------------------------------------------
+
+void hal_sim_start(const sim_options_t *opts, audio_source_t *src) {
+    options = *opts;
+    source = src;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    flash_load();
+    if (options.telemetry_path) {
+        telemetry_file = fopen(options.telemetry_path, "wb");
+        if (!telemetry_file) {
+            perror(options.telemetry_path);
+            exit(2);
+        }
+    }
+    if (options.stream_path) {
+        stream_file = fopen(options.stream_path, "wb");
+        if (!stream_file) {
+            perror(options.stream_path);
+            exit(2);
+        }
+    }
+}
+
+void hal_sim_finish(void) {
+    struct timespec wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    double wall = (wall_end.tv_sec - wall_start.tv_sec) + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+    double simulated = now_us / 1e6;
+
+    fflush(stdout);
+    char t[16];
+    format_time(now_us, t, sizeof(t));
+    fprintf(stderr, "sim: %s de áudio simulados em %.2f s (%.0fx o tempo real)\n", t, wall, wall > 0 ? simulated / wall : 0.0);
+    fprintf(stderr, "sim: %llu blocos do ADC, %u alertas, %u quadros no display (%llu bytes de I2C), %u na matriz, %llu bytes de telemetria\n",
+            (unsigned long long)adc_blocks, alerts, display_frames, (unsigned long long)display_bytes, led_frames,
+            (unsigned long long)telemetry_bytes);
+
+    if (stream_file) fprintf(stderr, "sim: %llu bytes gravados pelo CDC do USB\n", (unsigned long long)stream_bytes);
+    fprintf(stderr, "sim: flash com %u setores apagados e %u páginas programadas\n", flash_erases, flash_programs);
+
+    if (options.display_path) oled_write_pbm(options.display_path);
+    flash_save();
+    if (telemetry_file) fclose(telemetry_file);
+    if (stream_file) fclose(stream_file);
+    audio_source_close(source);
+    exit(0);
+}
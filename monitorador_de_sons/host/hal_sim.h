@@ -0,0 +1,43 @@
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include <stdbool.h>
+#include "audio_source.h"
+
+/*
+Implementação do substituto do Pico SDK (shim/) sobre um relógio virtual.
+
+O tempo só anda quando o firmware dorme em __wfi(): o relógio salta direto para
+o próximo alarme ou para o fim do bloco que o DMA do ADC está enchendo, e a
+interrupção correspondente é executada ali. Como o processamento em si não
+consome tempo virtual, horas de áudio passam em segundos.
+
+- ADC + DMA: amostras da fonte de áudio, no ritmo de adc_set_clkdiv; canais
+  encadeados e a IRQ de término se comportam como no RP2040.
+- I2C: um SSD1306 simulado interpreta comandos e dados e guarda o quadro.
+- UART: bytes da telemetria vão para um arquivo.
+- PWM: liga/desliga dos buzzers é registrado como alerta.
+- PIO: quadros da matriz de LEDs são contados.
+- Flash: vetor em RAM com semântica de NOR, carregado e salvo em arquivo para
+  que o registro persistente sobreviva entre execuções.
+- USB: os caracteres de `serial_input` são entregues a getchar_timeout_us, e
+  os bytes do CDC (captura bruta) passam por um FIFO esvaziado a ~1 MB/s e
+  vão para um arquivo.
+
+Transferências de DMA que não são do ADC terminam no instante em que começam.
+*/
+
+typedef struct {
+    const char *telemetry_path;  // Bytes enviados pela UART (NULL: descartados)
+    const char *display_path;    // Último quadro do display em PBM ao terminar
+    const char *display_dir;     // Um PBM por quadro enviado ao display
+    const char *flash_path;      // Imagem da flash carregada na partida e salva ao terminar
+    const char *serial_input;    // Comandos recebidos pelo USB, um caractere por leitura
+    const char *stream_path;     // Bytes binários escritos no CDC do USB (NULL: sem terminal)
+    double max_seconds;          // 0: até acabar a fonte de áudio
+} sim_options_t;
+
+void hal_sim_start(const sim_options_t *options, audio_source_t *source);
+void hal_sim_finish(void);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef SHIM_HARDWARE_ADC_H
+#define SHIM_HARDWARE_ADC_H
+
+#include "pico/stdlib.h"
+
+// Conversões vêm da fonte de áudio da simulação, no ritmo definido por adc_set_clkdiv.
+// No rodízio todos os microfones recebem a mesma amostra e o sensor de
+// temperatura (entrada 4) lê um valor fixo equivalente a 27 °C.
+typedef struct {
+    volatile uint32_t cs, result, fcs, fifo, div;
+} adc_hw_t;
+
+extern adc_hw_t *const adc_hw;
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_set_clkdiv(float clkdiv);
+void adc_run(bool run);
+void adc_fifo_drain(void);
+void adc_set_round_robin(uint input_mask);
+void adc_set_temp_sensor_enabled(bool enable);
+
+#endif
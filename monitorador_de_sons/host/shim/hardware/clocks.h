@@ -0,0 +1,10 @@
+#ifndef SHIM_HARDWARE_CLOCKS_H
+#define SHIM_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+enum clock_index { clk_sys = 5 };
+
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef SHIM_HARDWARE_DMA_H
+#define SHIM_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+
+#define NUM_DMA_CHANNELS 12
+#define DREQ_UART0_TX 20
+#define DREQ_UART1_TX 22
+#define DREQ_I2C0_TX 32
+#define DREQ_I2C1_TX 34
+#define DREQ_ADC 36
+#define DREQ_FORCE 0x3f
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+typedef struct {
+    uint8_t size;
+    bool read_increment, write_increment;
+    uint8_t dreq;
+    uint8_t chain_to;
+} dma_channel_config;
+
+typedef struct {
+    volatile uint32_t intr, inte0, ints0, abort;
+} dma_hw_t;
+
+extern dma_hw_t *const dma_hw;
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr, const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger);
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count);
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_abort(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef SHIM_HARDWARE_FLASH_H
+#define SHIM_HARDWARE_FLASH_H
+
+#include <stddef.h>
+#include "pico/stdlib.h"
+
+// Flash NOR simulada em RAM: apagar leva os bytes a 0xFF e programar só zera
+// bits. XIP_BASE aponta para o vetor, então leituras mapeadas funcionam.
+#define FLASH_PAGE_SIZE 256u
+#define FLASH_SECTOR_SIZE 4096u
+#define PICO_FLASH_SIZE_BYTES (2u * 1024u * 1024u)
+
+extern uint8_t hal_sim_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)hal_sim_flash)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef SHIM_HARDWARE_I2C_H
+#define SHIM_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Escritas no data_cmd (via DMA) e i2c_write_blocking vão para um SSD1306 simulado
+typedef struct {
+    volatile uint32_t con, tar, data_cmd, enable, status, raw_intr_stat, clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *const i2c0, *const i2c1;
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_STATUS_ACTIVITY_BITS 0x00000001u
+#define I2C_IC_STATUS_TFE_BITS 0x00000004u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif
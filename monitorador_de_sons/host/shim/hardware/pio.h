@@ -0,0 +1,22 @@
+#ifndef SHIM_HARDWARE_PIO_H
+#define SHIM_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+// Quadros enviados à matriz de LEDs são apenas contados
+typedef struct {
+    volatile uint32_t txf[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+typedef struct { int unused; } pio_program_t;
+
+extern pio_hw_t pio0_hw;
+#define pio0 (&pio0_hw)
+
+int pio_claim_unused_sm(PIO pio, bool required);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+
+#endif
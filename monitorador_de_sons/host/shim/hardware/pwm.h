@@ -0,0 +1,15 @@
+#ifndef SHIM_HARDWARE_PWM_H
+#define SHIM_HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+enum { PWM_CHAN_A = 0, PWM_CHAN_B = 1 };
+
+// Só registra quando os buzzers ligam e desligam
+uint pwm_gpio_to_slice_num(uint gpio);
+void pwm_set_clkdiv(uint slice_num, float divider);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level);
+void pwm_set_enabled(uint slice_num, bool enabled);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SHIM_HARDWARE_STRUCTS_SYSTICK_H
+#define SHIM_HARDWARE_STRUCTS_SYSTICK_H
+
+#include <stdint.h>
+
+// Registradores do SysTick (um por core no RP2040); no computador quem os
+// define e move é o teste que liga inc/profiling.c
+typedef struct {
+    volatile uint32_t csr;
+    volatile uint32_t rvr;
+    volatile uint32_t cvr;
+    volatile uint32_t calib;
+} systick_hw_t;
+
+extern systick_hw_t systick_sim;
+#define systick_hw (&systick_sim)
+
+#endif
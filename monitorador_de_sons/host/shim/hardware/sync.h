@@ -0,0 +1,16 @@
+#ifndef SHIM_HARDWARE_SYNC_H
+#define SHIM_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// Um único fluxo de execução: as "interrupções" só rodam dentro de __wfi()
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+static inline void __mem_fence_acquire(void) {}
+static inline void __mem_fence_release(void) {}
+
+void __wfi(void);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SHIM_HARDWARE_UART_H
+#define SHIM_HARDWARE_UART_H
+
+#include "pico/stdlib.h"
+
+// Bytes escritos no dr vão para o arquivo de telemetria da simulação, se houver
+typedef struct {
+    volatile uint32_t dr;
+} uart_hw_t;
+
+typedef struct uart_inst uart_inst_t;
+extern uart_inst_t *const uart0, *const uart1;
+
+uint uart_init(uart_inst_t *uart, uint baudrate);
+uart_hw_t *uart_get_hw(uart_inst_t *uart);
+uint uart_get_dreq(uart_inst_t *uart, bool is_tx);
+
+#endif
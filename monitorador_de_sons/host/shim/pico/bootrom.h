@@ -0,0 +1,6 @@
+#ifndef SHIM_PICO_BOOTROM_H
+#define SHIM_PICO_BOOTROM_H
+
+#include "pico/stdlib.h"
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef SHIM_PICO_MULTICORE_H
+#define SHIM_PICO_MULTICORE_H
+
+#include "pico/stdlib.h"
+
+// A simulação roda a análise no core 0 (ANALYSIS_ON_CORE1=0); lançar o core 1 é erro
+void multicore_launch_core1(void (*entry)(void));
+
+// Só há um fluxo de execução, então não há o que reter durante a gravação da flash
+static inline void multicore_lockout_victim_init(void) {}
+static inline void multicore_lockout_start_blocking(void) {}
+static inline void multicore_lockout_end_blocking(void) {}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SHIM_PICO_STDLIB_H
+#define SHIM_PICO_STDLIB_H
+
+// Substituto mínimo do Pico SDK para a simulação no computador (ver host/hal_sim.c)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+typedef unsigned int uint;
+
+#define PICO_ERROR_TIMEOUT -1
+
+#define GPIO_IN 0
+#define GPIO_OUT 1
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define GPIO_IRQ_EDGE_RISE 0x8u
+
+enum gpio_function { GPIO_FUNC_UART = 2, GPIO_FUNC_I2C = 3, GPIO_FUNC_PWM = 4 };
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t events);
+
+uint get_core_num(void);  // Definido por quem liga inc/profiling.c (só os testes)
+void stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);  // Não há entrada: sempre PICO_ERROR_TIMEOUT
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+bool gpio_get(uint gpio);  // Botões sempre soltos (nível alto pelo pull-up)
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+
+// Espera ativa: conclui o que o hardware faria sozinho (ex.: abort do DMA)
+void tight_loop_contents(void);
+
+#endif
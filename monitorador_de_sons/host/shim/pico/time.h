@@ -0,0 +1,20 @@
+#ifndef SHIM_PICO_TIME_H
+#define SHIM_PICO_TIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Tempo virtual: só avança quando o firmware dorme em __wfi()
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+
+#endif
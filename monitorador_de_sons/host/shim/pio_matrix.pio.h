@@ -0,0 +1,13 @@
+#ifndef SHIM_PIO_MATRIX_PIO_H
+#define SHIM_PIO_MATRIX_PIO_H
+
+// Substitui o cabeçalho gerado por pico_generate_pio_header
+#include "hardware/pio.h"
+
+static const pio_program_t pio_matrix_program = {0};
+
+static inline void pio_matrix_program_init(PIO pio, uint sm, uint offset, uint pin) {
+    (void)pio; (void)sm; (void)offset; (void)pin;
+}
+
+#endif
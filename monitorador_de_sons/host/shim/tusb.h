@@ -0,0 +1,14 @@
+#ifndef SHIM_TUSB_H
+#define SHIM_TUSB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// CDC do USB: os bytes vão para o arquivo --stream da simulação, passando por
+// um FIFO de 256 bytes esvaziado no ritmo de um USB full speed
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+
+#endif
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal_sim.h"
+
+// main() do firmware, renomeada na compilação (ver CMakeLists.txt)
+void firmware_main(void);
+
+static void usage(const char *program) {
+    fprintf(stderr,
+        "Uso: %s [opções] entrada.wav\n"
+        "  --raw             entrada com códigos do ADC (uint16 LE) na taxa do firmware\n"
+        "  --gain G          escala do WAV; 1.0 leva o fundo de escala ao fundo do ADC\n"
+        "  --seconds S       limita o tempo simulado\n"
+        "  --telemetry F     grava a telemetria binária da UART em F\n"
+        "  --display F       grava o último quadro do display em F (PBM)\n"
+        "  --display-dir D   grava cada quadro enviado ao display em D\n"
+        "  --flash F         carrega a flash de F (se existir) e a salva ao terminar\n"
+        "  --input TEXTO     comandos seriais entregues na partida (ex.: l lista o registro)\n"
+        "  --stream F        grava em F o que o firmware escreve no CDC do USB (ex.: --input s)\n"
+        "Relatórios saem na saída padrão; alertas e o resumo na saída de erro.\n",
+        program);
+}
+
+int main(int argc, char **argv) {
+    sim_options_t options = {0};
+    const char *input = NULL;
+    bool raw = false;
+    double gain = 1.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--raw")) raw = true;
+        else if (!strcmp(arg, "--gain") && has_value) gain = atof(argv[++i]);
+        else if (!strcmp(arg, "--seconds") && has_value) options.max_seconds = atof(argv[++i]);
+        else if (!strcmp(arg, "--telemetry") && has_value) options.telemetry_path = argv[++i];
+        else if (!strcmp(arg, "--display") && has_value) options.display_path = argv[++i];
+        else if (!strcmp(arg, "--display-dir") && has_value) options.display_dir = argv[++i];
+        else if (!strcmp(arg, "--flash") && has_value) options.flash_path = argv[++i];
+        else if (!strcmp(arg, "--input") && has_value) options.serial_input = argv[++i];
+        else if (!strcmp(arg, "--stream") && has_value) options.stream_path = argv[++i];
+        else if (arg[0] != '-' && !input) input = arg;
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!input) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    static audio_source_t source;
+    if (!audio_source_open(&source, input, raw, gain)) return 1;
+    hal_sim_start(&options, &source);
+    firmware_main();  // Só retorna via hal_sim_finish(), que encerra o processo
+    return 0;
+}
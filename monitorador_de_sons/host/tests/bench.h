@@ -0,0 +1,54 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+Medição de tempo dos benchmarks do host: nanossegundos pelo relógio monotônico
+e, em x86, ciclos pelo TSC. Os números servem para comparar versões no mesmo
+computador; os ciclos do M0+ vêm do perfil no alvo (inc/profiling.h e o
+comando `k`). Com o argumento --quick (usado pelo ctest) as repetições caem
+para uma fração, o suficiente para conferir os resultados.
+*/
+
+typedef struct {
+    struct timespec start;
+    uint64_t start_cycles;
+} bench_timer_t;
+
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static inline void bench_start(bench_timer_t *t) {
+    clock_gettime(CLOCK_MONOTONIC, &t->start);
+    t->start_cycles = bench_cycles();
+}
+
+// Tempo por repetição desde bench_start, em ns; `cycles` recebe os ciclos por repetição (0 sem TSC)
+static inline double bench_stop(const bench_timer_t *t, uint32_t reps, double *cycles) {
+    uint64_t end_cycles = bench_cycles();
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double ns = (end.tv_sec - t->start.tv_sec) * 1e9 + (end.tv_nsec - t->start.tv_nsec);
+    if (cycles) *cycles = t->start_cycles ? (double)(end_cycles - t->start_cycles) / reps : 0;
+    return ns / reps;
+}
+
+static inline uint32_t bench_reps(int argc, char **argv, uint32_t full) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--quick")) return full / 100 ? full / 100 : 1;
+    }
+    return full;
+}
+
+#endif
@@ -0,0 +1,32 @@
+// Tempo do decimador (inc/decimator.h) por bloco de análise (DMA_BUFFER_SIZE
+// saídas) em cada razão, e por amostra do ADC.
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "test.h"
+#include "decimator.h"
+
+#define BLOCK_LEN 79
+
+int main(int argc, char **argv) {
+    uint32_t reps = bench_reps(argc, argv, 20000);
+    static decimator_t dec;
+    static uint16_t input[BLOCK_LEN * DECIMATOR_MAX_RATIO];
+    static uint16_t output[BLOCK_LEN];
+    srand(5);
+    for (uint32_t i = 0; i < BLOCK_LEN * DECIMATOR_MAX_RATIO; i++) input[i] = (uint16_t)(1548 + rand() % 1000);
+
+    for (uint32_t ratio = 4; ratio <= DECIMATOR_MAX_RATIO; ratio *= 2) {
+        CHECK(decimator_init(&dec, ratio, 2048));
+        uint32_t len = BLOCK_LEN * ratio, produced = 0;
+        bench_timer_t t;
+        double cycles;
+        bench_start(&t);
+        for (uint32_t r = 0; r < reps; r++) produced += decimator_process(&dec, input, len, output);
+        double ns = bench_stop(&t, reps, &cycles);
+        printf("Razão %2u: %.0f ns (%.0f ciclos) por bloco, %.2f ns por amostra do ADC\n", ratio, ns, cycles,
+               ns / len);
+        CHECK_EQ(produced, (uint64_t)reps * BLOCK_LEN);
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,57 @@
+// Tempo por transformada da FFT real Q15 de 256 pontos (fft_q15_real_power) e
+// do quadro completo do modo de espectro (spectrum_analyze: FFT + bandas).
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "test.h"
+#include "spectrum.h"
+#include "fft_tables.h"
+
+int main(int argc, char **argv) {
+    uint32_t reps = bench_reps(argc, argv, 200000);
+    int16_t input[FFT_TABLE_SIZE], data[FFT_TABLE_SIZE];
+    uint32_t power[FFT_TABLE_SIZE / 2];
+    srand(3);
+    for (uint32_t i = 0; i < FFT_TABLE_SIZE; i++) input[i] = (int16_t)(rand() % 8192 - 4096);
+
+    // A cópia da entrada faz parte do laço (a FFT é in-place); é medida à parte e descontada
+    bench_timer_t t;
+    volatile uint32_t sink = 0;
+    bench_start(&t);
+    for (uint32_t r = 0; r < reps; r++) {
+        memcpy(data, input, sizeof data);
+        sink += (uint16_t)data[r & (FFT_TABLE_SIZE - 1)];
+    }
+    double copy_cycles, copy_ns = bench_stop(&t, reps, &copy_cycles);
+
+    bench_start(&t);
+    for (uint32_t r = 0; r < reps; r++) {
+        memcpy(data, input, sizeof data);
+        fft_q15_real_power(data, power);
+        sink += power[r & (FFT_TABLE_SIZE / 2 - 1)];
+    }
+    double fft_cycles, fft_ns = bench_stop(&t, reps, &fft_cycles);
+
+    spectrum_t spectrum;
+    spectrum_init(&spectrum, 0, 4);
+    bench_start(&t);
+    for (uint32_t r = 0; r < reps; r++) {
+        memcpy(spectrum.frame, input, sizeof input);
+        spectrum_analyze(&spectrum);
+    }
+    double frame_cycles, frame_ns = bench_stop(&t, reps, &frame_cycles);
+
+    printf("FFT real Q15 de %u pontos: %.0f ns, %.0f ciclos por transformada\n", FFT_TABLE_SIZE,
+           fft_ns - copy_ns, fft_cycles - copy_cycles);
+    printf("Quadro do espectro (FFT + %u bandas): %.0f ns, %.0f ciclos\n", SPECTRUM_BANDS,
+           frame_ns - copy_ns, frame_cycles - copy_cycles);
+
+    // Resultado conferido: o mesmo quadro dá sempre as mesmas bandas
+    uint64_t first = spectrum.band_power[2];
+    memcpy(spectrum.frame, input, sizeof input);
+    spectrum_analyze(&spectrum);
+    CHECK_EQ(spectrum.band_power[2], first);
+    CHECK_EQ(spectrum.frames, reps + 1);
+    (void)sink;
+    return TEST_RESULT();
+}
@@ -0,0 +1,67 @@
+// Tempo por chamada das primitivas de desenho do ssd1306 (o raster do display) e
+// do envio das alterações, com o barramento simulado de mock_i2c.c. As primitivas
+// que ganharam caminhos por palavra aparecem lado a lado com a versão original
+// pixel a pixel (ssd1306_reference.c), que test_ssd1306_raster confere byte a byte.
+#include <stdio.h>
+#include "bench.h"
+#include "test.h"
+#include "mock_i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_reference.h"
+
+static ssd1306_t ssd;
+static uint32_t reps;
+
+#define TIME(call, ns, cycles) do { \
+    bench_timer_t t_; \
+    bench_start(&t_); \
+    for (uint32_t r = 0; r < reps; r++) { call; } \
+    ns = bench_stop(&t_, reps, &cycles); \
+} while (0)
+
+#define BENCH(name, call) do { \
+    double ns_, cycles_; \
+    TIME(call, ns_, cycles_); \
+    printf("%-28s %8.1f ns %8.0f ciclos\n", name, ns_, cycles_); \
+} while (0)
+
+// Versão atual e original com os mesmos argumentos; `ref` é o nome sem o prefixo
+#define BENCH_PAIR(name, fn, ...) do { \
+    double ns_, cycles_, ref_ns_, ref_cycles_; \
+    TIME(ssd1306_##fn(&ssd, __VA_ARGS__), ns_, cycles_); \
+    TIME(ssd1306_reference_##fn(&ssd, __VA_ARGS__), ref_ns_, ref_cycles_); \
+    printf("%-28s %8.1f ns %8.0f ciclos | original %8.1f ns %8.0f ciclos | %5.1fx\n", name, ns_, cycles_, \
+           ref_ns_, ref_cycles_, ns_ > 0 ? ref_ns_ / ns_ : 0.0); \
+} while (0)
+
+int main(int argc, char **argv) {
+    reps = bench_reps(argc, argv, 200000);
+    mock_i2c_reset();
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_send_data(&ssd);
+
+    // `r & 1` alterna o valor para que cada chamada realmente altere a RAM
+    BENCH_PAIR("pixel", pixel, r & 127, r & 63, r & 1);
+    BENCH_PAIR("hline 128", hline, 0, WIDTH - 1, r & 63, r & 1);
+    BENCH_PAIR("hline 20, y desalinhado", hline, 50, 69, 8 * (r & 7) + 3, r & 1);
+    BENCH_PAIR("vline 64", vline, r & 127, 0, HEIGHT - 1, r & 1);
+    BENCH_PAIR("vline 5-44 (duas palavras)", vline, r & 127, 5, 44, r & 1);
+    BENCH("line diagonal", ssd1306_line(&ssd, 0, 0, WIDTH - 1, HEIGHT - 1, r & 1));
+    BENCH_PAIR("rect 100x40 cheio", rect, 12, 14, 100, 40, r & 1, true);
+    BENCH_PAIR("rect 100x40 contorno", rect, 12, 14, 100, 40, r & 1, false);
+    BENCH("column", ssd1306_column(&ssd, r & 127, r, ~r));
+    BENCH_PAIR("fill", fill, r & 1);
+    BENCH_PAIR("draw_char alinhado", draw_char, 'A' + (r & 15), (r & 15) * 8, 24);
+    BENCH_PAIR("draw_char desalinhado", draw_char, 'A' + (r & 15), (r & 15) * 8, 27);
+    BENCH("draw_string 16 caracteres", ssd1306_draw_string(&ssd, "Nivel: 63.5 dB  ", 0, (r & 7) * 8 + (r & 1)));
+    BENCH("envio de uma coluna", (ssd1306_vline(&ssd, r & 127, 0, HEIGHT - 1, r & 1), ssd1306_send_data_async(&ssd)));
+    BENCH("envio de texto", (ssd1306_draw_string(&ssd, (r & 1) ? "60 dB" : "61 dB", 40, 24),
+                             ssd1306_send_data_async(&ssd)));
+
+    // O painel simulado terminou com o que foi desenhado (as versões originais não
+    // marcam as páginas alteradas: vai o quadro inteiro)
+    ssd.full_refresh = true;
+    ssd1306_send_data(&ssd);
+    CHECK(memcmp(mock_panel.ram, ssd.ram_buffer, ssd.bufsize) == 0);
+    return TEST_RESULT();
+}
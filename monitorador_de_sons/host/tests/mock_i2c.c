@@ -0,0 +1,114 @@
+// Ver mock_i2c.h
+#include <string.h>
+#include "mock_i2c.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+
+mock_panel_t mock_panel;
+
+struct i2c_inst { i2c_hw_t hw; };
+static struct i2c_inst mock_i2c0 = {.hw = {.status = I2C_IC_STATUS_TFE_BITS}};
+i2c_inst_t *const i2c0 = &mock_i2c0, *const i2c1 = &mock_i2c0;
+
+// Estado do decodificador do protocolo do SSD1306
+static struct {
+    bool in_transaction, expect_control, data;
+    uint8_t command[3];
+    uint8_t command_len;
+    uint8_t col0, col1, page0, page1, col, page;
+} bus;
+
+void mock_i2c_reset(void) {
+    memset(&mock_panel, 0, sizeof mock_panel);
+    memset(&bus, 0, sizeof bus);
+    bus.col1 = 127;
+    bus.page1 = 7;
+    mock_i2c0.hw.raw_intr_stat = 0;
+}
+
+void mock_i2c_set_abort(void) {
+    mock_i2c0.hw.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+}
+
+static void panel_command(uint8_t byte) {
+    bus.command[bus.command_len++] = byte;
+    uint8_t op = bus.command[0];
+    uint8_t needed = (op == 0x21 || op == 0x22) ? 3 : (op == 0x20 || op == 0x81 || op == 0xA8 || op == 0xD3
+                     || op == 0xDA || op == 0xD5 || op == 0xD9 || op == 0xDB || op == 0x8D) ? 2 : 1;
+    if (bus.command_len < needed) return;
+    if (op == 0x21) {
+        bus.col0 = bus.col = bus.command[1];
+        bus.col1 = bus.command[2];
+    } else if (op == 0x22) {
+        bus.page0 = bus.page = bus.command[1];
+        bus.page1 = bus.command[2];
+    }
+    bus.command_len = 0;
+}
+
+// Modo vertical: a página avança primeiro e, ao passar de page1, a coluna
+static void panel_data(uint8_t byte) {
+    mock_panel.ram[(bus.col << 3) + bus.page] = byte;
+    mock_panel.data_bytes++;
+    if (bus.page++ == bus.page1) {
+        bus.page = bus.page0;
+        bus.col = bus.col == bus.col1 ? bus.col0 : bus.col + 1;
+    }
+}
+
+static void bus_byte(uint8_t byte, bool stop) {
+    if (!bus.in_transaction) {
+        bus.in_transaction = true;
+        bus.expect_control = true;
+        mock_panel.transactions++;
+        mock_panel.wire_bytes++;  // Endereço
+    }
+    mock_panel.wire_bytes++;
+    if (bus.expect_control) {
+        bus.expect_control = false;
+        bus.data = byte & 0x40;
+        bus.command_len = 0;
+    } else if (bus.data) {
+        panel_data(byte);
+    } else {
+        panel_command(byte);
+    }
+    if (stop) bus.in_transaction = false;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) { return &i2c->hw; }
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) { (void)i2c; (void)is_tx; return DREQ_I2C0_TX; }
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c; (void)addr;
+    for (size_t i = 0; i < len; i++) bus_byte(src[i], i == len - 1 && !nostop);
+    return (int)len;
+}
+
+// O canal do ssd1306 escreve palavras no IC_DATA_CMD: byte + bit de STOP
+int dma_claim_unused_channel(bool required) { (void)required; return 0; }
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    return (dma_channel_config){.size = DMA_SIZE_32, .read_increment = true, .dreq = DREQ_FORCE, .chain_to = channel};
+}
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) { c->size = size; }
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) { c->read_increment = incr; }
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) { c->write_increment = incr; }
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) { c->dreq = dreq; }
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    (void)channel; (void)config; (void)write_addr; (void)read_addr; (void)transfer_count; (void)trigger;
+}
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    (void)channel;
+    const volatile uint16_t *words = read_addr;
+    for (uint32_t i = 0; i < transfer_count; i++)
+        bus_byte(words[i] & 0xFF, words[i] & I2C_IC_DATA_CMD_STOP_BITS);
+}
+bool dma_channel_is_busy(uint channel) { (void)channel; return false; }
+// No RP2040 a leitura de clr_tx_abrt limpa o aborto; aqui o ssd1306_busy só o lê
+// depois de abortar o canal, então a limpeza fica no abort
+void dma_channel_abort(uint channel) {
+    (void)channel;
+    mock_i2c0.hw.raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+}
+void tight_loop_contents(void) {}
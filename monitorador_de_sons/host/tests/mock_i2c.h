@@ -0,0 +1,25 @@
+#ifndef MOCK_I2C_H
+#define MOCK_I2C_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Barramento I2C e DMA de mentira para testar inc/ssd1306.c sem o hal_sim.c: cada
+transferência termina na hora e os bytes vão para um SSD1306 simulado (modo de
+endereçamento vertical), que guarda a RAM do painel e conta o tráfego.
+*/
+
+typedef struct {
+    uint8_t ram[128 * 8];    // RAM do painel, no mesmo formato de ram_buffer
+    size_t wire_bytes;       // Bytes no fio, contando o de endereço de cada transação
+    size_t transactions;
+    size_t data_bytes;       // Bytes gravados na RAM do painel
+} mock_panel_t;
+
+extern mock_panel_t mock_panel;
+
+void mock_i2c_reset(void);
+void mock_i2c_set_abort(void);  // O próximo ssd1306_busy vê TX_ABRT (ex.: NACK)
+
+#endif
@@ -0,0 +1,69 @@
+#include "ssd1306_reference.h"
+#include "display_assets.h"
+
+void ssd1306_reference_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint16_t index = (y >> 3) + (x << 3);
+  uint8_t pixel = (y & 0b111);
+  if (value)
+    ssd->ram_buffer[index] |= (1 << pixel);
+  else
+    ssd->ram_buffer[index] &= ~(1 << pixel);
+}
+
+void ssd1306_reference_fill(ssd1306_t *ssd, bool value) {
+    // Itera por todas as posições do display
+    for (uint8_t y = 0; y < ssd->height; ++y) {
+        for (uint8_t x = 0; x < ssd->width; ++x) {
+            ssd1306_reference_pixel(ssd, x, y, value);
+        }
+    }
+}
+
+void ssd1306_reference_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value,
+                            bool fill) {
+  for (uint8_t x = left; x < left + width; ++x) {
+    ssd1306_reference_pixel(ssd, x, top, value);
+    ssd1306_reference_pixel(ssd, x, top + height - 1, value);
+  }
+  for (uint8_t y = top; y < top + height; ++y) {
+    ssd1306_reference_pixel(ssd, left, y, value);
+    ssd1306_reference_pixel(ssd, left + width - 1, y, value);
+  }
+
+  if (fill) {
+    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
+      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
+        ssd1306_reference_pixel(ssd, x, y, value);
+      }
+    }
+  }
+}
+
+void ssd1306_reference_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+  for (uint8_t x = x0; x <= x1; ++x)
+    ssd1306_reference_pixel(ssd, x, y, value);
+}
+
+void ssd1306_reference_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  for (uint8_t y = y0; y <= y1; ++y)
+    ssd1306_reference_pixel(ssd, x, y, value);
+}
+
+void ssd1306_reference_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  uint8_t code = (uint8_t)c;
+  if (code < FONT_FIRST || code > FONT_LAST)
+    code = FONT_FIRST;
+  const uint8_t *glyph = font_glyphs[code - FONT_FIRST];
+
+  for (uint8_t i = 0; i < 8; ++i)
+  {
+    uint8_t line = glyph[i];
+    for (uint8_t j = 0; j < 8; ++j)
+    {
+      ssd1306_reference_pixel(ssd, x + i, y + j, line & (1 << j));
+    }
+  }
+}
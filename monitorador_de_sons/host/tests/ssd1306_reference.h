@@ -0,0 +1,27 @@
+#ifndef SSD1306_REFERENCE_H
+#define SSD1306_REFERENCE_H
+
+#include "ssd1306.h"
+
+/*
+Primitivas de desenho do ssd1306 como eram antes dos caminhos por palavra: um
+ssd1306_pixel por pixel, nos mesmos laços de 8 bits da versão original. Servem
+de referência para test_ssd1306_raster (o ram_buffer tem de sair igual, byte a
+byte) e de linha de base para bench_ssd1306.
+
+Duas adaptações ao ssd1306 atual, sem mudar quais pixels são escritos: o pixel
+usa o layout de hoje (sem o byte 0x40 no início do ram_buffer) e ignora
+coordenadas fora do display, e o glifo vem da fonte gerada (display_assets.h).
+Como na versão original, os laços não terminam se o último x ou y for 255, e um
+glifo com x ou y acima de 248 dá a volta para a outra borda.
+*/
+
+void ssd1306_reference_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
+void ssd1306_reference_fill(ssd1306_t *ssd, bool value);
+void ssd1306_reference_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value,
+                            bool fill);
+void ssd1306_reference_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
+void ssd1306_reference_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+void ssd1306_reference_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
+
+#endif
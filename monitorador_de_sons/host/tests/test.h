@@ -0,0 +1,48 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Verificações mínimas dos testes do host (ctest). Cada falha imprime arquivo,
+linha e os valores comparados; o teste continua e TEST_RESULT() devolve o
+código de saída (0 sem falhas).
+*/
+
+static int test_failures = 0;
+static int test_checks = 0;
+
+#define CHECK(cond) do { \
+    test_checks++; \
+    if (!(cond)) { \
+        test_failures++; \
+        fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long check_a_ = (long long)(a), check_b_ = (long long)(b); \
+    test_checks++; \
+    if (check_a_ != check_b_) { \
+        test_failures++; \
+        fprintf(stderr, "%s:%d: falhou: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, check_a_, check_b_); \
+    } \
+} while (0)
+
+// |a - b| <= tol, para valores em décimos de dB, ms etc.
+#define CHECK_NEAR(a, b, tol) do { \
+    double check_a_ = (double)(a), check_b_ = (double)(b); \
+    test_checks++; \
+    if (check_a_ - check_b_ > (tol) || check_b_ - check_a_ > (tol)) { \
+        test_failures++; \
+        fprintf(stderr, "%s:%d: falhou: %s ~ %s (%g vs %g, tolerância %g)\n", __FILE__, __LINE__, #a, #b, \
+                check_a_, check_b_, (double)(tol)); \
+    } \
+} while (0)
+
+#define TEST_RESULT() (printf("%s: %d verificações, %d falhas\n", __FILE__, test_checks, test_failures), \
+                       test_failures ? 1 : 0)
+
+#endif
@@ -0,0 +1,74 @@
+// Máquina de estados dos alertas (inc/alert.h) com relógio simulado: ticks em
+// ms escolhidos pelo teste, sem o laço do firmware.
+#include "test.h"
+#include "alert.h"
+
+static const alert_pattern_t beep = {.duration_ms = 100, .buzzer_on_ms = 10, .buzzer_off_ms = 30, .blink_ms = 25};
+static const alert_pattern_t steady = {.duration_ms = 50, .buzzer_on_ms = 20, .buzzer_off_ms = 0, .blink_ms = 0};
+
+static void test_alert_pattern(void) {
+    alert_t alert;
+    alert_init(&alert);
+    CHECK_EQ(alert_tick(&alert, 0), 0);
+    CHECK(alert_schedule(&alert, &beep));
+    CHECK(alert_busy(&alert));
+
+    // Tick a cada ms: registra em que instante cada evento aparece
+    int show = -1, restore = -1, buzzer_on = 0, buzzer_off = 0, border = 0;
+    int last_on = -1, last_off = -1;
+    for (uint32_t now = 1000; now < 1200; now++) {
+        uint8_t events = alert_tick(&alert, now);
+        int t = (int)(now - 1000);
+        if (events & ALERT_EVT_SHOW) show = t;
+        if (events & ALERT_EVT_RESTORE) restore = t;
+        if (events & ALERT_EVT_BUZZER_ON) buzzer_on++, last_on = t;
+        if (events & ALERT_EVT_BUZZER_OFF) buzzer_off++, last_off = t;
+        if (events & ALERT_EVT_BORDER) border++;
+    }
+    CHECK_EQ(show, 0);
+    CHECK_EQ(restore, 100);
+    // Ligado em 0, 40 e 80 (10 ms ligado, 30 desligado); desligado em 10, 50, 90 e no fim
+    CHECK_EQ(buzzer_on, 3);
+    CHECK_EQ(last_on, 80);
+    CHECK_EQ(buzzer_off, 3);
+    CHECK_EQ(last_off, 90);
+    // Borda: acende em 0, troca em 25, 50 e 75, apaga no fim (sem evento de borda no RESTORE)
+    CHECK_EQ(border, 4);
+    CHECK(!alert.border_on);
+    CHECK(!alert_busy(&alert));
+}
+
+static void test_alert_queue(void) {
+    alert_t alert;
+    alert_init(&alert);
+    CHECK(alert_schedule(&alert, &steady));
+    CHECK(alert_schedule(&alert, &beep));
+    CHECK(alert_schedule(&alert, &steady));
+    CHECK(alert_schedule(&alert, &steady));
+    CHECK(!alert_schedule(&alert, &steady));  // Fila cheia
+
+    // Padrões em sequência sem voltar à tela de monitoramento entre eles
+    int shows = 0, restores = 0;
+    uint32_t restored_at = 0;
+    for (uint32_t now = 0; now < 400; now++) {
+        uint8_t events = alert_tick(&alert, now);
+        shows += (events & ALERT_EVT_SHOW) != 0;
+        if (events & ALERT_EVT_RESTORE) restores++, restored_at = now;
+        if (now == 49) CHECK(alert.buzzer_on);  // Buzzer contínuo no padrão sem buzzer_off_ms
+    }
+    CHECK_EQ(shows, 4);
+    CHECK_EQ(restores, 1);
+    CHECK_EQ(restored_at, 50 + 100 + 50 + 50);
+
+    // O relógio de 32 bits dá a volta no meio de um padrão
+    CHECK(alert_schedule(&alert, &steady));
+    CHECK(alert_tick(&alert, UINT32_MAX - 9) & ALERT_EVT_SHOW);
+    CHECK(!(alert_tick(&alert, 30) & ALERT_EVT_RESTORE));
+    CHECK(alert_tick(&alert, 40) & ALERT_EVT_RESTORE);
+}
+
+int main(void) {
+    test_alert_pattern();
+    test_alert_queue();
+    return TEST_RESULT();
+}
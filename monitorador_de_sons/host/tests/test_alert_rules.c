@@ -0,0 +1,140 @@
+// Regras de alerta (inc/alert_rules.h) com relógio simulado: blocos de 1 ms
+// com o nível e a classe escolhidos pelo teste, sem o laço do firmware.
+#include <string.h>
+#include "test.h"
+#include "alert_rules.h"
+#include "sound_class.h"
+
+#define LOUD_MS (1ull << 40)
+#define QUIET_MS (1ull << 20)
+
+static meter_t meter;
+static alert_rules_t rules;
+
+// Blocos de 1 ms: 1000 amostras/s, uma amostra por bloco
+static void rules_setup(void) {
+    memset(&meter, 0, sizeof meter);
+    alert_rules_init(&rules, 1000, 1);
+}
+
+// Um bloco com o mesmo nível em block_ms (LEQ) e fast_ms (LAF dos eventos)
+static uint32_t feed(uint64_t ms, uint8_t block_class) {
+    meter.block_ms = meter.fast_ms = ms;
+    return alert_rules_update(&rules, &meter, block_class);
+}
+
+static void test_leq_window(void) {
+    rules_setup();
+    alert_rule_config_t leq = {.kind = ALERT_RULE_LEQ, .window_ms = 100, .enter = 10000, .exit = 0};
+    CHECK_EQ(alert_rules_add(&rules, &leq), 0);
+    CHECK_EQ(rules.rules[0].slot_len, 5);
+
+    // Nível constante: o LEQ é o próprio nível
+    for (int i = 0; i < 200; i++) feed(LOUD_MS, SOUND_CLASS_STEADY);
+    CHECK_EQ(rules.rules[0].value, metering_db_x10(&meter, LOUD_MS));
+
+    // Metade da janela em silêncio (quase zero): cai 3 dB
+    for (int i = 0; i < 50; i++) feed(0, SOUND_CLASS_QUIET);
+    CHECK_NEAR(rules.rules[0].value, metering_db_x10(&meter, LOUD_MS) - 30, 1);
+}
+
+// Quantos blocos um bloco alto continua na janela, entrando na posição `phase` da fatia
+static int events_lifetime(int phase) {
+    rules_setup();
+    alert_rule_config_t events = {.kind = ALERT_RULE_EVENTS, .window_ms = 100, .event_db_x10 = 0,
+                                  .enter = 1000, .exit = 0};
+    alert_rules_add(&rules, &events);
+    int32_t threshold = metering_db_x10(&meter, LOUD_MS) - 10;
+    rules.rules[0].config.event_db_x10 = threshold;
+
+    for (int i = 0; i < 5 * 7 + phase; i++) feed(QUIET_MS, SOUND_CLASS_QUIET);
+    feed(LOUD_MS, SOUND_CLASS_IMPULSE);
+    int lifetime = 1;
+    while (rules.rules[0].value == 1 && lifetime < 1000) {
+        feed(QUIET_MS, SOUND_CLASS_QUIET);
+        lifetime++;
+    }
+    return lifetime - 1;
+}
+
+static void test_window_slots(void) {
+    // Janela efetiva de 19 a 20 fatias de 5 blocos: de 96 a 100 blocos
+    CHECK_EQ(events_lifetime(0), 100);
+    CHECK_EQ(events_lifetime(1), 99);
+    CHECK_EQ(events_lifetime(4), 96);
+}
+
+static void test_hysteresis_and_cooldown(void) {
+    rules_setup();
+    alert_rule_config_t events = {.kind = ALERT_RULE_EVENTS, .window_ms = 20, .enter = 5, .exit = 2,
+                                  .cooldown_ms = 10};
+    alert_rules_add(&rules, &events);
+    rules.rules[0].config.event_db_x10 = metering_db_x10(&meter, LOUD_MS) - 10;
+
+    // Entra no 5º bloco alto e dispara; enquanto ativa volta a disparar a cada 10
+    // blocos, também depois que os blocos altos acabam
+    int fired_at[8], fires = 0, block = 0;
+    for (int i = 0; i < 20; i++, block++) {
+        if (feed(LOUD_MS, SOUND_CLASS_IMPULSE) && fires < 8) fired_at[fires++] = block;
+    }
+    // Abaixo de `enter` mas acima de `exit`: continua ativa (histerese)
+    for (int i = 0; i < 17; i++, block++) {
+        if (feed(QUIET_MS, SOUND_CLASS_QUIET) && fires < 8) fired_at[fires++] = block;
+    }
+    CHECK_EQ(fires, 4);
+    CHECK_EQ(fired_at[0], 4);
+    CHECK_EQ(fired_at[1], 14);
+    CHECK_EQ(fired_at[2], 24);
+    CHECK_EQ(fired_at[3], 34);
+    CHECK_EQ(rules.rules[0].value, 3);
+    CHECK(rules.rules[0].active);
+    feed(QUIET_MS, SOUND_CLASS_QUIET);
+    block++;
+    CHECK_EQ(rules.rules[0].value, 2);
+    CHECK(!rules.rules[0].active);
+
+    // Reentrada só ao chegar de novo a `enter`, ainda dentro do cooldown do disparo
+    // do bloco 34: entra em alerta, mas só dispara quando ele acaba (bloco 44)
+    for (int i = 0; i < 4; i++, block++) CHECK(!feed(LOUD_MS, SOUND_CLASS_IMPULSE));
+    CHECK(!rules.rules[0].active);
+    CHECK(!feed(LOUD_MS, SOUND_CLASS_IMPULSE));
+    CHECK_EQ(block++, 42);
+    CHECK(rules.rules[0].active);
+    CHECK(!feed(LOUD_MS, SOUND_CLASS_IMPULSE));
+    CHECK(feed(LOUD_MS, SOUND_CLASS_IMPULSE));
+
+    // Reentrada com o cooldown vencido: dispara na hora
+    for (int i = 0; i < 20; i++) feed(QUIET_MS, SOUND_CLASS_QUIET);
+    CHECK(!rules.rules[0].active);
+    for (int i = 0; i < 4; i++) CHECK(!feed(LOUD_MS, SOUND_CLASS_IMPULSE));
+    CHECK(feed(LOUD_MS, SOUND_CLASS_IMPULSE));
+    CHECK_EQ(rules.rules[0].fired, 7);  // 4, 14, 24, 34, 44, 54 (ainda ativa no silêncio) e este
+}
+
+static void test_class_mask(void) {
+    rules_setup();
+    alert_rule_config_t speech = {.kind = ALERT_RULE_EVENTS, .window_ms = 20,
+                                  .class_mask = 1u << SOUND_CLASS_SPEECH, .enter = 1000};
+    alert_rule_config_t leq = {.kind = ALERT_RULE_LEQ, .window_ms = 20,
+                               .class_mask = 1u << SOUND_CLASS_STEADY, .enter = 10000};
+    alert_rules_add(&rules, &speech);
+    alert_rules_add(&rules, &leq);
+    rules.rules[0].config.event_db_x10 = metering_db_x10(&meter, LOUD_MS) - 10;
+
+    // Os impulsos altos não contam para nenhuma das duas regras
+    for (int i = 0; i < 10; i++) feed(LOUD_MS, SOUND_CLASS_IMPULSE);
+    for (int i = 0; i < 4; i++) feed(LOUD_MS, SOUND_CLASS_SPEECH);
+    for (int i = 0; i < 6; i++) feed(QUIET_MS, SOUND_CLASS_STEADY);
+    CHECK_EQ(rules.rules[0].value, 4);
+    // O LEQ é só dos blocos estáveis, sem diluir nos demais
+    CHECK_EQ(rules.rules[1].value, metering_db_x10(&meter, QUIET_MS));
+    CHECK_EQ(rules.rules[1].total_blocks, 6);
+}
+
+int main(void) {
+    test_leq_window();
+    test_window_slots();
+    test_hysteresis_and_cooldown();
+    test_class_mask();
+    return TEST_RESULT();
+}
@@ -0,0 +1,107 @@
+// block_stats_compute (SWAR) contra block_stats_reference (escalar): mesmos
+// campos, bit a bit, para todo shift usado, comprimentos pares e ímpares,
+// início alinhado e desalinhado, extremos da faixa de 12 + shift bits e blocos
+// longos o bastante para encher os acumuladores por faixa.
+#include <string.h>
+#include "test.h"
+#include "block_stats.h"
+
+#define MAX_LEN 4100
+
+static uint16_t buffer[MAX_LEN + 2] __attribute__((aligned(4)));
+static uint32_t rng_state = 12345;
+static uint32_t mismatches = 0;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void compare(const uint16_t *samples, uint32_t len, uint16_t offset, uint8_t shift, uint16_t loud_level) {
+    block_stats_t swar, scalar;
+    block_stats_compute(samples, len, offset, shift, loud_level, &swar);
+    block_stats_reference(samples, len, offset, shift, loud_level, &scalar);
+    if (swar.sum == scalar.sum && swar.square_sum == scalar.square_sum && swar.peak == scalar.peak
+        && swar.loud == scalar.loud) return;
+    if (mismatches++ < 10) {
+        fprintf(stderr, "len %u, início %s, offset %u, shift %u, limiar %u: "
+                "SWAR %u/%llu/%u/%u, escalar %u/%llu/%u/%u\n",
+                len, ((uintptr_t)samples & 2u) ? "desalinhado" : "alinhado", offset, shift, loud_level,
+                swar.sum, (unsigned long long)swar.square_sum, swar.peak, swar.loud,
+                scalar.sum, (unsigned long long)scalar.square_sum, scalar.peak, scalar.loud);
+    }
+}
+
+// Amostras aleatórias em [0, max]: todos os comprimentos até 200, os dois inícios
+static void test_random_blocks(void) {
+    for (uint8_t shift = 0; shift <= 4; shift++) {
+        uint32_t max = (1u << (12 + shift)) - 1;
+        for (uint32_t len = 0; len <= 200; len++) {
+            for (uint8_t start = 0; start < 2; start++) {
+                for (uint32_t i = 0; i < len + 2; i++) buffer[i] = (uint16_t)(rng() % (max + 1));
+                uint16_t offset = (uint16_t)(rng() % (max + 1));
+                uint16_t loud_level = (uint16_t)(rng() % 4097);
+                compare(buffer + start, len, offset, shift, loud_level);
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+// Extremos: offset nos limites, amostras todas 0 ou todas no máximo, alternando
+// entre os dois (as duas faixas da palavra com sinais opostos) e o limiar
+// exatamente na amplitude
+static void test_edges(void) {
+    static const uint32_t lens[] = { 1, 2, 3, 31, 32, 33, 64, 79, 80, 81 };
+    for (uint8_t shift = 0; shift <= 4; shift++) {
+        uint16_t max = (uint16_t)((1u << (12 + shift)) - 1);
+        const uint16_t offsets[] = { 0, 1, (uint16_t)(max / 2), (uint16_t)(max / 2 + 1), (uint16_t)(max - 1), max };
+        for (size_t o = 0; o < sizeof offsets / sizeof offsets[0]; o++) {
+            for (uint8_t pattern = 0; pattern < 4; pattern++) {
+                for (uint32_t i = 0; i < 84; i++) {
+                    buffer[i] = pattern == 0 ? 0 : pattern == 1 ? max
+                              : pattern == 2 ? (i & 1 ? max : 0) : (uint16_t)(offsets[o] ^ (i & 1));
+                }
+                uint16_t amplitude = (uint16_t)((offsets[o] > max - offsets[o] ? offsets[o] : max - offsets[o]) >> shift);
+                const uint16_t levels[] = { 0, 1, amplitude, (uint16_t)(amplitude + 1), 4095, 4096 };
+                for (size_t l = 0; l < sizeof levels / sizeof levels[0]; l++) {
+                    for (size_t n = 0; n < sizeof lens / sizeof lens[0]; n++) {
+                        compare(buffer, lens[n], offsets[o], shift, levels[l]);
+                        compare(buffer + 1, lens[n], offsets[o], shift, levels[l]);
+                    }
+                }
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+// Amplitude máxima em blocos longos: cada trecho de BLOCK_STATS_CHUNK_WORDS
+// palavras chega ao limite da faixa de 16 bits, e a soma total passa de 2^24
+static void test_long_full_scale(void) {
+    for (uint8_t shift = 0; shift <= 4; shift++) {
+        uint16_t max = (uint16_t)((1u << (12 + shift)) - 1);
+        for (uint32_t i = 0; i < MAX_LEN + 2; i++) buffer[i] = i % 3 == 2 ? 0 : max;
+        compare(buffer, MAX_LEN, 0, shift, 4095);
+        compare(buffer + 1, MAX_LEN - 1, max, shift, 1);
+        for (uint32_t i = 0; i < MAX_LEN + 2; i++) buffer[i] = max;
+        compare(buffer, MAX_LEN, 0, shift, 4095);
+
+        block_stats_t stats;
+        block_stats_compute(buffer, MAX_LEN, 0, shift, 4095, &stats);
+        CHECK_EQ(stats.sum, MAX_LEN * 4095u);
+        CHECK_EQ(stats.square_sum, (uint64_t)MAX_LEN * 4095u * 4095u);
+        CHECK_EQ(stats.peak, 4095);
+        CHECK_EQ(stats.loud, MAX_LEN);
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+int main(void) {
+    test_random_blocks();
+    test_edges();
+    test_long_full_scale();
+    return TEST_RESULT();
+}
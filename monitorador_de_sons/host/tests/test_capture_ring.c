@@ -0,0 +1,167 @@
+// Anel de captura (inc/capture_ring.h) contra um DMA simulado: dois canais
+// encadeados que se alternam, cada um rearmado pela "ISR" no slot devolvido
+// por capture_ring_block_done, como em dma_irq_handler.
+#include <string.h>
+#include "test.h"
+#include "capture_ring.h"
+
+#define BLOCKS 8
+#define LEN 16
+
+typedef struct {
+    capture_ring_t ring;
+    uint32_t buffers[CAPTURE_RING_MAX_BLOCKS][LEN];
+    uint32_t channel_slot[2];  // Slot em que cada canal está armado
+    uint32_t channel_seq[2];   // Sequência que cada canal está escrevendo
+    uint8_t active;            // Canal transferindo agora
+} sim_dma_t;
+
+// Mesma ordem de start_capture: o segundo canal armado no próximo slot
+static void sim_start(sim_dma_t *dma, uint32_t blocks) {
+    capture_ring_init(&dma->ring, blocks);
+    dma->active = 0;
+    dma->channel_slot[0] = capture_ring_slot(&dma->ring, 0);
+    dma->channel_slot[1] = capture_ring_slot(&dma->ring, 1);
+    uint32_t head = atomic_load(&dma->ring.head);
+    dma->channel_seq[0] = head;
+    dma->channel_seq[1] = head + 1;
+}
+
+// O canal ativo preenche o bloco com a própria sequência; a ISR o rearma dois
+// blocos à frente e o outro canal assume. Retorna a sequência fechada.
+static uint32_t sim_complete(sim_dma_t *dma) {
+    uint8_t ch = dma->active;
+    for (uint32_t i = 0; i < LEN; i++) dma->buffers[dma->channel_slot[ch]][i] = dma->channel_seq[ch] * LEN + i;
+    uint32_t seq;
+    dma->channel_slot[ch] = capture_ring_block_done(&dma->ring, &seq);
+    CHECK_EQ(seq, dma->channel_seq[ch]);
+    dma->channel_seq[ch] += 2;
+    dma->active ^= 1;
+    return seq;
+}
+
+// Os dois canais nunca apontam para o slot de um bloco que ainda é válido
+static void check_not_armed_on(const sim_dma_t *dma, uint32_t seq) {
+    uint32_t slot = seq % dma->ring.num_blocks;
+    CHECK(dma->channel_slot[0] != slot);
+    CHECK(dma->channel_slot[1] != slot);
+}
+
+static bool block_intact(const sim_dma_t *dma, uint32_t seq) {
+    const uint32_t *data = dma->buffers[seq % dma->ring.num_blocks];
+    for (uint32_t i = 0; i < LEN; i++) {
+        if (data[i] != seq * LEN + i) return false;
+    }
+    return true;
+}
+
+// Consumidor em dia: todos os blocos chegam intactos, várias voltas no anel
+static void test_keeps_up(void) {
+    static sim_dma_t dma;
+    sim_start(&dma, BLOCKS);
+    for (uint32_t n = 0; n < 10 * BLOCKS; n++) {
+        uint32_t seq = sim_complete(&dma);
+        CHECK_EQ(seq, n);
+        CHECK(capture_ring_validate(&dma.ring, seq));
+        check_not_armed_on(&dma, seq);
+        CHECK(block_intact(&dma, seq));
+        CHECK(capture_ring_validate(&dma.ring, seq));
+    }
+    CHECK_EQ(capture_ring_overruns(&dma.ring), 0);
+}
+
+// Consumidor atrasado: só os últimos (BLOCKS - 2) blocos fechados continuam
+// válidos; cada leitura de um bloco já sobrescrito conta um overrun
+static void test_overrun(void) {
+    static sim_dma_t dma;
+    sim_start(&dma, BLOCKS);
+    const uint32_t produced = 3 * BLOCKS + 3;
+    for (uint32_t n = 0; n < produced; n++) sim_complete(&dma);
+
+    uint32_t expected_overruns = 0;
+    for (uint32_t seq = 0; seq < produced; seq++) {
+        bool fresh = produced - seq <= BLOCKS - 2;
+        CHECK_EQ(capture_ring_validate(&dma.ring, seq), fresh);
+        if (fresh) {
+            check_not_armed_on(&dma, seq);
+            CHECK(block_intact(&dma, seq));
+        } else {
+            expected_overruns++;
+        }
+    }
+    CHECK_EQ(capture_ring_overruns(&dma.ring), expected_overruns);
+    CHECK_EQ(expected_overruns, produced - (BLOCKS - 2));
+
+    // Bloco validado antes da análise e sobrescrito durante ela: a segunda validação falha
+    uint32_t seq = sim_complete(&dma);
+    CHECK(capture_ring_validate(&dma.ring, seq));
+    for (uint32_t n = 0; n < BLOCKS - 2; n++) sim_complete(&dma);
+    CHECK(!capture_ring_validate(&dma.ring, seq));
+    CHECK_EQ(capture_ring_overruns(&dma.ring), expected_overruns + 1);
+}
+
+// A comparação head - seq continua certa quando a sequência passa de 2^32, e o
+// slot segue em ordem: o DMA e o consumidor (seq % num_blocks) não se separam
+static void check_wraparound(uint32_t requested) {
+    static sim_dma_t dma;
+    capture_ring_init(&dma.ring, requested);
+    atomic_store(&dma.ring.head, UINT32_MAX - 3);
+    dma.active = 0;
+    dma.channel_slot[0] = capture_ring_slot(&dma.ring, 0);
+    dma.channel_slot[1] = capture_ring_slot(&dma.ring, 1);
+    dma.channel_seq[0] = UINT32_MAX - 3;
+    dma.channel_seq[1] = UINT32_MAX - 2;
+
+    uint32_t first = 0;
+    for (uint32_t n = 0; n < 8; n++) {
+        uint32_t seq = sim_complete(&dma);
+        if (n == 0) first = seq;
+        CHECK(capture_ring_validate(&dma.ring, seq));
+        check_not_armed_on(&dma, seq);
+        CHECK(block_intact(&dma, seq));
+    }
+    CHECK_EQ(atomic_load(&dma.ring.head), 4);  // Passou por zero
+    CHECK_EQ(capture_ring_validate(&dma.ring, first), dma.ring.num_blocks - 2 >= 8);
+    CHECK(capture_ring_validate(&dma.ring, 3));
+    CHECK(block_intact(&dma, 3));
+    if (requested == BLOCKS) CHECK_EQ(capture_ring_overruns(&dma.ring), 1);
+}
+
+static void test_sequence_wraparound(void) {
+    check_wraparound(BLOCKS);
+    check_wraparound(12);  // Vira 8: com 12 o slot pularia de 3 para 0 na volta
+    check_wraparound(CAPTURE_RING_MAX_BLOCKS);
+}
+
+static void test_init_limits(void) {
+    capture_ring_t ring;
+    capture_ring_init(&ring, 1);
+    CHECK_EQ(ring.num_blocks, 4);  // Dois slots ficam com o DMA
+    capture_ring_init(&ring, 1000);
+    CHECK_EQ(ring.num_blocks, CAPTURE_RING_MAX_BLOCKS);
+    // Tamanhos que não são potência de 2 são arredondados para baixo
+    capture_ring_init(&ring, 5);
+    CHECK_EQ(ring.num_blocks, 4);
+    capture_ring_init(&ring, 31);
+    CHECK_EQ(ring.num_blocks, 16);
+
+    // Com o mínimo de 4 blocos só os dois últimos fechados podem ser lidos
+    static sim_dma_t dma;
+    sim_start(&dma, 4);
+    for (uint32_t n = 0; n < 9; n++) {
+        uint32_t seq = sim_complete(&dma);
+        CHECK(capture_ring_validate(&dma.ring, seq));
+        check_not_armed_on(&dma, seq);
+        CHECK(block_intact(&dma, seq));
+        if (seq > 0) CHECK(capture_ring_validate(&dma.ring, seq - 1));
+        if (seq > 1) CHECK(!capture_ring_validate(&dma.ring, seq - 2));
+    }
+}
+
+int main(void) {
+    test_keeps_up();
+    test_overrun();
+    test_sequence_wraparound();
+    test_init_limits();
+    return TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+// Rastreador do nível DC (inc/dc_tracker.h): integrador por amostra, fim da
+// calibração na amostra exata e constantes de tempo rápida e lenta.
+#include <math.h>
+#include "test.h"
+#include "dc_tracker.h"
+
+#define BLOCK_LEN 79
+
+static uint16_t block[BLOCK_LEN];
+
+static void feed_constant(dc_tracker_t *dc, uint16_t value, uint32_t samples) {
+    for (uint32_t i = 0; i < BLOCK_LEN; i++) block[i] = value;
+    for (; samples >= BLOCK_LEN; samples -= BLOCK_LEN) dc_tracker_process(dc, block, BLOCK_LEN);
+    dc_tracker_process(dc, block, samples);
+}
+
+// Fração da distância até um degrau que resta após `samples` amostras
+static double remaining(uint8_t shift, uint32_t samples) {
+    return pow(1.0 - 1.0 / (1u << shift), samples);
+}
+
+static void test_matches_sample_recurrence(void) {
+    // Processar em blocos é o mesmo integrador amostra a amostra
+    dc_tracker_t blocks, samples;
+    dc_tracker_init(&blocks, 2048 << 4, 0);
+    dc_tracker_init(&samples, 2048 << 4, 0);
+    uint32_t seed = 9;
+    for (uint32_t b = 0; b < 300; b++) {
+        for (uint32_t i = 0; i < BLOCK_LEN; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            block[i] = (uint16_t)((30000 + (seed >> 20)) & 0xFFFF);
+            dc_tracker_add_sample(&samples, block[i]);
+        }
+        dc_tracker_process(&blocks, block, BLOCK_LEN);
+        CHECK_EQ(blocks.acc, samples.acc);
+    }
+}
+
+static void test_calibration(void) {
+    dc_tracker_t dc;
+    uint32_t settle = 16000;  // DC_SETTLE_MS a 16 kHz
+    dc_tracker_init(&dc, 2048 << 4, settle);
+    CHECK(!dc_tracker_settled(&dc));
+
+    // Polarização real 40 LSB acima da nominal: em 16 ms resta 1/e do erro
+    uint16_t bias = (2048 + 40) << 4;
+    feed_constant(&dc, bias, 256);
+    CHECK_NEAR(dc_tracker_level(&dc), bias - (40 << 4) * remaining(DC_TRACKER_FAST_SHIFT, 256), 2);
+    CHECK(!dc_tracker_settled(&dc));
+
+    // A calibração acaba na amostra exata, no meio de um bloco
+    feed_constant(&dc, bias, settle - 256 - 1);
+    CHECK(!dc_tracker_settled(&dc));
+    CHECK_EQ(dc.shift, DC_TRACKER_FAST_SHIFT);
+    feed_constant(&dc, bias, 1);
+    CHECK(dc_tracker_settled(&dc));
+    CHECK_EQ(dc.shift, DC_TRACKER_SLOW_SHIFT);
+    CHECK_NEAR(dc_tracker_level(&dc), bias, 1);  // Convergiu e a troca de escala preserva o nível
+}
+
+static void test_slow_tracking(void) {
+    dc_tracker_t dc;
+    dc_tracker_init(&dc, 2048 << 4, 0);
+    CHECK(dc_tracker_settled(&dc));
+
+    // Deriva de 20 LSB: após 2^14 amostras (1 s) resta 1/e
+    uint16_t drifted = (2048 + 20) << 4;
+    feed_constant(&dc, drifted, 1u << DC_TRACKER_SLOW_SHIFT);
+    CHECK_NEAR(dc_tracker_level(&dc), drifted - (20 << 4) * remaining(DC_TRACKER_SLOW_SHIFT, 1u << DC_TRACKER_SLOW_SHIFT), 2);
+
+    // Um grave de 50 Hz forte quase não move o nível (corte em 0,16 Hz)
+    dc_tracker_init(&dc, 2048 << 4, 0);
+    for (uint32_t b = 0; b < 400; b++) {
+        for (uint32_t i = 0; i < BLOCK_LEN; i++) {
+            uint32_t n = b * BLOCK_LEN + i;
+            block[i] = (uint16_t)lround((2048 + 1500 * sin(2 * M_PI * 50 * n / 16000.0)) * 16);
+        }
+        dc_tracker_process(&dc, block, BLOCK_LEN);
+        CHECK_NEAR(dc_tracker_level(&dc), 2048 << 4, 16 * 1500 / 80);
+    }
+}
+
+int main(void) {
+    test_matches_sample_recurrence();
+    test_calibration();
+    test_slow_tracking();
+    return TEST_RESULT();
+}
@@ -0,0 +1,80 @@
+// Resposta em frequência do decimador (inc/decimator.h) em cada razão suportada:
+// banda de passagem plana até 0,45 da taxa de saída, rejeição do que dobraria
+// sobre ela e nível DC exato, medidos com senoides na taxa do ADC.
+#include <math.h>
+#include "test.h"
+#include "decimator.h"
+
+#define OUTPUT_RATE 16000.0
+#define BLOCKS 40
+#define BLOCK_LEN 79
+#define AMPLITUDE 1000.0
+#define SETTLE 200  // Saídas descartadas até o FIR encher
+
+static decimator_t dec;
+static uint16_t input[BLOCK_LEN * DECIMATOR_MAX_RATIO * BLOCKS];
+static uint16_t output[BLOCK_LEN * BLOCKS];
+
+// Ganho em dB de uma senoide de `freq` Hz, processada em blocos como no firmware
+static double gain_db(uint32_t ratio, double freq) {
+    decimator_reset(&dec);
+    uint32_t len = BLOCK_LEN * ratio;
+    for (uint32_t i = 0; i < len * BLOCKS; i++)
+        input[i] = (uint16_t)lround(2048 + AMPLITUDE * sin(2 * M_PI * freq * i / (OUTPUT_RATE * ratio)));
+    uint32_t produced = 0;
+    for (uint32_t b = 0; b < BLOCKS; b++) produced += decimator_process(&dec, input + b * len, len, output + produced);
+    CHECK_EQ(produced, BLOCK_LEN * BLOCKS);
+
+    double sum = 0;
+    for (uint32_t i = SETTLE; i < produced; i++) {
+        double v = (output[i] - (2048 << DECIMATOR_OUTPUT_SHIFT)) / (double)(1 << DECIMATOR_OUTPUT_SHIFT);
+        sum += v * v;
+    }
+    double rms = sqrt(sum / (produced - SETTLE));
+    return rms > 0 ? 20 * log10(rms / (AMPLITUDE / sqrt(2))) : -200;
+}
+
+static void test_response(uint32_t ratio) {
+    CHECK(decimator_init(&dec, ratio, 2048));
+    // Banda de passagem: compensação da queda do CIC
+    const double pass[] = {50, 500, 1000, 3000, 5000, 6500, 0.45 * OUTPUT_RATE};
+    for (size_t i = 0; i < sizeof pass / sizeof pass[0]; i++) CHECK_NEAR(gain_db(ratio, pass[i]), 0, 0.1);
+    // Acima da metade da taxa de saída: o que dobraria sobre a banda de áudio
+    const double stop[] = {8800, 10000, 12000, 15000, 20000, 31000};
+    for (size_t i = 0; i < sizeof stop / sizeof stop[0]; i++) CHECK(gain_db(ratio, stop[i]) < -45);
+    // Perto das imagens do CIC (múltiplos da taxa intermediária), já bem longe da banda
+    CHECK(gain_db(ratio, 2 * OUTPUT_RATE + 1000) < -60);
+}
+
+static void test_dc_and_full_scale(void) {
+    for (uint32_t ratio = 4; ratio <= DECIMATOR_MAX_RATIO; ratio *= 2) {
+        CHECK(decimator_init(&dec, ratio, 1900));
+        uint32_t len = BLOCK_LEN * ratio;
+        // DC: sai exatamente (x - offset) << DECIMATOR_OUTPUT_SHIFT + centro
+        for (uint32_t i = 0; i < len * 4; i++) input[i] = 2100;
+        uint32_t produced = decimator_process(&dec, input, len * 4, output);
+        CHECK_EQ(output[produced - 1], 2100 << DECIMATOR_OUTPUT_SHIFT);
+
+        // Degraus de fundo de escala a cada bloco, com o offset longe do meio: os
+        // pentes não estouram e cada patamar chega ao valor exato
+        decimator_reset(&dec);
+        for (uint32_t i = 0; i < len * 4; i++) input[i] = (i / len) & 1 ? 4095 : 0;
+        produced = decimator_process(&dec, input, len * 4, output);
+        CHECK_NEAR(output[produced - 1], 4095 << DECIMATOR_OUTPUT_SHIFT, 1);
+        CHECK_NEAR(output[produced - 1 - BLOCK_LEN], 0, 1);
+    }
+}
+
+static void test_ratio_limits(void) {
+    CHECK(!decimator_init(&dec, 2, 2048));
+    CHECK(!decimator_init(&dec, 12, 2048));
+    CHECK(!decimator_init(&dec, DECIMATOR_MAX_RATIO * 2, 2048));
+    CHECK(decimator_init(&dec, DECIMATOR_MAX_RATIO, 2048));
+}
+
+int main(void) {
+    for (uint32_t ratio = 4; ratio <= DECIMATOR_MAX_RATIO; ratio *= 2) test_response(ratio);
+    test_dc_and_full_scale();
+    test_ratio_limits();
+    return TEST_RESULT();
+}
@@ -0,0 +1,99 @@
+// Separação por canal (inc/deinterleave.h): de 1 a 5 entradas no rodízio (até
+// quatro microfones e o sensor de temperatura), números de quadros que não são
+// múltiplos do número de canais nem de 2, início do bloco alinhado e
+// desalinhado, e um fluxo contínuo do DMA cortado em blocos seguidos, em que
+// cada bloco tem de recomeçar no canal 0.
+#include <string.h>
+#include "test.h"
+#include "deinterleave.h"
+
+#define MAX_CHANNELS 5
+#define MAX_FRAMES 700
+#define SENTINEL 0xBEEF
+
+static uint16_t stream[MAX_CHANNELS * MAX_FRAMES * 3 + 2] __attribute__((aligned(4)));
+static uint16_t out[MAX_CHANNELS * MAX_FRAMES + 8] __attribute__((aligned(4)));
+
+// Amostra do canal `k` no quadro `f`: o valor diz de onde veio
+static uint16_t sample_of(uint8_t k, uint32_t f) {
+    return (uint16_t)((k << 12) | (f & 0x0FFF));
+}
+
+static uint32_t check_lanes(uint32_t frames, uint8_t channels, uint32_t first_frame) {
+    uint32_t wrong = 0;
+    for (uint8_t k = 0; k < channels; k++) {
+        for (uint32_t f = 0; f < frames; f++) {
+            if (out[(uint32_t)k * frames + f] != sample_of(k, first_frame + f)) wrong++;
+        }
+    }
+    for (uint32_t i = (uint32_t)channels * frames; i < sizeof out / sizeof out[0]; i++) {
+        if (out[i] != SENTINEL) wrong++;  // Nada escrito depois do último canal
+    }
+    return wrong;
+}
+
+static void fill_out(void) {
+    for (uint32_t i = 0; i < sizeof out / sizeof out[0]; i++) out[i] = SENTINEL;
+}
+
+// Bloco isolado: o canal k de cada quadro vai para out[k * frames + f]
+static void test_single_block(void) {
+    static const uint32_t frame_counts[] = { 0, 1, 2, 3, 5, 7, 79, 158, 316, 631, 632, 700 };
+    for (uint8_t channels = 1; channels <= MAX_CHANNELS; channels++) {
+        for (size_t n = 0; n < sizeof frame_counts / sizeof frame_counts[0]; n++) {
+            uint32_t frames = frame_counts[n];
+            for (uint8_t start = 0; start < 2; start++) {
+                uint16_t *in = stream + start;
+                for (uint32_t f = 0; f < frames; f++) {
+                    for (uint8_t k = 0; k < channels; k++) in[f * channels + k] = sample_of(k, f);
+                }
+                fill_out();
+                deinterleave(in, frames, channels, out);
+                CHECK_EQ(check_lanes(frames, channels, 0), 0);
+            }
+        }
+    }
+}
+
+// O DMA grava um fluxo c0 c1 ... cN-1 c0 ... e o corta em blocos de frames * N
+// amostras. Com frames * N ímpar os blocos alternam entre alinhado e
+// desalinhado; em todos a primeira amostra ainda é do canal 0 e cada canal
+// continua do quadro em que o bloco anterior parou.
+static void test_consecutive_blocks(void) {
+    static const uint32_t frame_counts[] = { 1, 3, 79, 237 };
+    for (uint8_t channels = 1; channels <= MAX_CHANNELS; channels++) {
+        for (size_t n = 0; n < sizeof frame_counts / sizeof frame_counts[0]; n++) {
+            uint32_t frames = frame_counts[n], block = frames * channels;
+            for (uint32_t i = 0; i < 3 * block; i++) stream[i] = sample_of(i % channels, i / channels);
+            for (uint32_t b = 0; b < 3; b++) {
+                fill_out();
+                deinterleave(stream + b * block, frames, channels, out);
+                CHECK_EQ(out[0], sample_of(0, b * frames));
+                CHECK_EQ(check_lanes(frames, channels, b * frames), 0);
+            }
+        }
+    }
+}
+
+// Dois canais com o bloco alinhado usam uma palavra de 32 bits por quadro:
+// a amostra da metade baixa é sempre a do canal 0 (little-endian)
+static void test_two_channel_word_order(void) {
+    stream[0] = 0x1111;
+    stream[1] = 0x2222;
+    stream[2] = 0x3333;
+    stream[3] = 0x4444;
+    fill_out();
+    deinterleave(stream, 2, 2, out);
+    CHECK_EQ(out[0], 0x1111);
+    CHECK_EQ(out[1], 0x3333);
+    CHECK_EQ(out[2], 0x2222);
+    CHECK_EQ(out[3], 0x4444);
+    CHECK_EQ(out[4], SENTINEL);
+}
+
+int main(void) {
+    test_single_block();
+    test_consecutive_blocks();
+    test_two_channel_word_order();
+    return TEST_RESULT();
+}
@@ -0,0 +1,150 @@
+// Fonte e telas geradas no build (generated/display_assets.c, de inc/font.txt e
+// inc/screens.txt por tools/gen_display_assets.py). Os glifos têm de seguir as
+// regras de tamanho de font.txt, e cada tela de screens.txt, refeita em tempo
+// de execução com ssd1306_rect e ssd1306_draw_string, tem de sair igual à
+// imagem gerada, com os textos dentro da tela e longe da borda que o alerta
+// pisca por cima.
+//
+// Uso (pelo ctest): test_display_assets inc/screens.txt
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "mock_i2c.h"
+#include "ssd1306.h"
+#include "display_assets.h"
+
+// Borda piscante do alerta (alert_task em monitorador_de_sons.c)
+#define ALERT_BORDER_X 3
+#define ALERT_BORDER_Y 3
+#define ALERT_BORDER_W 122
+#define ALERT_BORDER_H 60
+
+static ssd1306_t ssd;
+
+static const struct {
+    const char *name;
+    const uint8_t *frame;
+} screens[] = {
+    { "monitor", screen_monitor },
+    { "alert", screen_alert },
+};
+
+static bool glyph_pixel(uint8_t code, uint8_t x, uint8_t y) {
+    return (font_glyphs[code - FONT_FIRST][x] >> y) & 1;
+}
+
+// 8x8 por código; a coluna 7 fica livre como espaço entre letras, e maiúsculas
+// e dígitos sem acento usam só as linhas 0-6
+static void test_glyph_size(void) {
+    CHECK_EQ(FONT_GLYPH_BYTES, 8);
+    CHECK_EQ(sizeof font_glyphs, (FONT_LAST - FONT_FIRST + 1) * FONT_GLYPH_BYTES);
+    CHECK(FONT_LAST >= 'z');
+    for (uint16_t code = FONT_FIRST; code <= FONT_LAST; code++) {
+        for (uint8_t y = 0; y < 8; y++) CHECK(!glyph_pixel((uint8_t)code, 7, y));
+        bool plain = (code >= 'A' && code <= 'Z') || (code >= '0' && code <= '9');
+        if (plain) {
+            bool inked = false;
+            for (uint8_t x = 0; x < 8; x++) {
+                CHECK(!glyph_pixel((uint8_t)code, x, 7));
+                for (uint8_t y = 0; y < 8; y++) inked |= glyph_pixel((uint8_t)code, x, y);
+            }
+            CHECK(inked);
+        }
+    }
+    for (uint8_t x = 0; x < 8; x++) CHECK_EQ(font_glyphs[0][x], 0);  // Espaço
+}
+
+static const uint8_t *screen_frame(const char *name) {
+    for (size_t i = 0; i < sizeof screens / sizeof screens[0]; i++) {
+        if (!strcmp(screens[i].name, name)) return screens[i].frame;
+    }
+    return NULL;
+}
+
+static uint32_t utf8_length(const char *s) {
+    uint32_t n = 0;
+    for (; *s; s++) n += ((uint8_t)*s & 0xC0) != 0x80;
+    return n;
+}
+
+static bool boxes_overlap(int x0, int y0, int w0, int h0, int x1, int y1, int w1, int h1) {
+    return x0 < x1 + w1 && x1 < x0 + w0 && y0 < y1 + h1 && y1 < y0 + h0;
+}
+
+// A borda só ocupa o contorno do retângulo: o texto não pode tocar nenhum lado
+static bool touches_border(int x, int y, int w, int h) {
+    const int bx = ALERT_BORDER_X, by = ALERT_BORDER_Y, bw = ALERT_BORDER_W, bh = ALERT_BORDER_H;
+    return boxes_overlap(x, y, w, h, bx, by, bw, 1) || boxes_overlap(x, y, w, h, bx, by + bh - 1, bw, 1)
+        || boxes_overlap(x, y, w, h, bx, by, 1, bh) || boxes_overlap(x, y, w, h, bx + bw - 1, by, 1, bh);
+}
+
+static void finish_screen(const char *name, uint32_t *checked) {
+    const uint8_t *frame = screen_frame(name);
+    CHECK(frame != NULL);
+    if (!frame) {
+        fprintf(stderr, "tela '%s' de screens.txt sem imagem gerada conhecida pelo teste\n", name);
+        return;
+    }
+    if (memcmp(ssd.ram_buffer, frame, SCREEN_FRAME_BYTES) != 0) {
+        CHECK(false);
+        fprintf(stderr, "tela '%s': imagem gerada difere do desenho com ssd1306_rect/ssd1306_draw_string\n", name);
+    }
+    (*checked)++;
+}
+
+// Repete os comandos de screens.txt com as funções do ssd1306
+static void test_screens(const char *path) {
+    FILE *f = fopen(path, "r");
+    CHECK(f != NULL);
+    if (!f) return;
+
+    mock_i2c_reset();
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    CHECK_EQ(SCREEN_WIDTH, ssd.width);
+    CHECK_EQ(SCREEN_HEIGHT, ssd.height);
+    CHECK_EQ(SCREEN_FRAME_BYTES, ssd.bufsize);
+
+    char line[256], name[64] = "";
+    uint32_t checked = 0, line_no = 0;
+    while (fgets(line, sizeof line, f)) {
+        line_no++;
+        line[strcspn(line, "\r\n")] = '\0';
+        int x, y, w, h, text_at;
+        char word[64];
+        if (line[0] == '#' || sscanf(line, "%63s", word) != 1) continue;
+        if (!strcmp(word, "screen")) {
+            if (name[0]) finish_screen(name, &checked);
+            sscanf(line, "screen %63s", name);
+            ssd1306_fill(&ssd, false);
+        } else if (!strcmp(word, "rect") && sscanf(line, "rect %d %d %d %d", &x, &y, &w, &h) == 4) {
+            ssd1306_rect(&ssd, (uint8_t)y, (uint8_t)x, (uint8_t)w, (uint8_t)h, true, false);
+        } else if (!strcmp(word, "text") && sscanf(line, "text %d %d %n", &x, &y, &text_at) == 2) {
+            const char *text = line + text_at;
+            int width = 8 * (int)utf8_length(text);
+            // ssd1306_draw_string quebra a linha quando o próximo caractere encosta na borda direita
+            if (x < 0 || y < 0 || x + width >= SCREEN_WIDTH || y + 8 >= SCREEN_HEIGHT) {
+                CHECK(false);
+                fprintf(stderr, "%s:%u: texto fora da área de ssd1306_draw_string\n", path, line_no);
+            }
+            if (touches_border(x, y, width, 8)) {
+                CHECK(false);
+                fprintf(stderr, "%s:%u: texto sob a borda piscante do alerta\n", path, line_no);
+            }
+            ssd1306_draw_string(&ssd, text, (uint8_t)x, (uint8_t)y);
+        }
+    }
+    if (name[0]) finish_screen(name, &checked);
+    fclose(f);
+    CHECK_EQ(checked, sizeof screens / sizeof screens[0]);
+
+    free(ssd.ram_buffer);
+    free(ssd.dirty);
+    free(ssd.sent_buffer);
+    free(ssd.stream);
+}
+
+int main(int argc, char **argv) {
+    test_glyph_size();
+    test_screens(argc > 1 ? argv[1] : "inc/screens.txt");
+    return TEST_RESULT();
+}
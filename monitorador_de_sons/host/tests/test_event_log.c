@@ -0,0 +1,311 @@
+// Registro na flash (inc/event_log.h) sobre uma flash NOR simulada em RAM:
+// apagar põe 0xFF e programar só leva bits de 1 para 0. Uma falta de energia é
+// simulada por um orçamento de bytes: a gravação para no meio de um registro e
+// o registro é reaberto do zero, como na partida seguinte.
+#include <string.h>
+#include "test.h"
+#include "event_log.h"
+
+#define SECTORS 4
+#define FLASH_SIZE (SECTORS * EVENT_LOG_SECTOR_SIZE)
+#define NO_CUT UINT32_MAX
+
+static uint8_t flash_mem[FLASH_SIZE];
+static uint32_t sector_erases[SECTORS];
+static uint32_t programs;
+static uint32_t power_budget = NO_CUT;  // Bytes que ainda chegam à flash antes da falta de energia
+static bool power_lost;
+
+static void ram_erase(uint32_t offset) {
+    CHECK_EQ(offset % EVENT_LOG_SECTOR_SIZE, 0);
+    if (power_lost) return;
+    memset(flash_mem + offset, 0xFF, EVENT_LOG_SECTOR_SIZE);
+    sector_erases[offset / EVENT_LOG_SECTOR_SIZE]++;
+}
+
+static void ram_program(uint32_t offset, const uint8_t *data) {
+    CHECK_EQ(offset % EVENT_LOG_PAGE_SIZE, 0);
+    programs++;
+    for (uint32_t i = 0; i < EVENT_LOG_PAGE_SIZE && !power_lost; i++) {
+        uint8_t next = flash_mem[offset + i] & data[i];
+        CHECK_EQ(next, data[i]);  // Nenhum bit 0 volta a 1 sem apagar
+        if (next == flash_mem[offset + i]) continue;
+        if (power_budget != NO_CUT && power_budget-- == 0) {
+            power_lost = true;
+            break;
+        }
+        flash_mem[offset + i] = next;
+    }
+}
+
+static const event_log_flash_t ram_flash = { flash_mem, SECTORS, ram_erase, ram_program };
+
+static void flash_reset(void) {
+    memset(flash_mem, 0xFF, sizeof flash_mem);
+    memset(sector_erases, 0, sizeof sector_erases);
+    programs = 0;
+    power_budget = NO_CUT;
+    power_lost = false;
+}
+
+// Religa a placa: a energia volta e o estado em RAM é perdido
+static void reboot(event_log_t *log) {
+    power_budget = NO_CUT;
+    power_lost = false;
+    memset(log, 0xA5, sizeof *log);
+    event_log_init(log, &ram_flash);
+}
+
+// Minuto `i` com níveis que sobem e descem, para exercitar os deltas negativos
+static event_log_record_t make_minute(uint32_t i) {
+    event_log_record_t r = { .type = EVENT_LOG_MINUTE, .time_s = 60 * (i + 1) };
+    int16_t base = (int16_t)(400 + (int32_t)((i * 37) % 400) - (i % 3 == 0 ? 300 : 0));
+    r.minute.laeq_db_x10 = base;
+    r.minute.lafmax_db_x10 = (int16_t)(base + 150);
+    r.minute.l10_db_x10 = (int16_t)(base + 40);
+    r.minute.l50_db_x10 = (int16_t)(base - 20);
+    r.minute.l90_db_x10 = (int16_t)(base - 60);
+    r.minute.peak_max = (uint16_t)i;  // Identifica o minuto na leitura
+    r.minute.loud_blocks = (uint16_t)(i % 50);
+    r.minute.alerts = (uint16_t)(i % 4);
+    r.minute.gap_ms = (uint16_t)(i % 10 == 0 ? 87 : 0);
+    return r;
+}
+
+static bool same_minute(const event_log_record_t *a, const event_log_record_t *b) {
+    return a->type == b->type && a->time_s == b->time_s
+        && a->minute.laeq_db_x10 == b->minute.laeq_db_x10 && a->minute.lafmax_db_x10 == b->minute.lafmax_db_x10
+        && a->minute.l10_db_x10 == b->minute.l10_db_x10 && a->minute.l50_db_x10 == b->minute.l50_db_x10
+        && a->minute.l90_db_x10 == b->minute.l90_db_x10 && a->minute.peak_max == b->minute.peak_max
+        && a->minute.loud_blocks == b->minute.loud_blocks && a->minute.alerts == b->minute.alerts
+        && a->minute.gap_ms == b->minute.gap_ms;
+}
+
+#define READ_MAX 2048
+
+typedef struct {
+    event_log_record_t records[READ_MAX];
+    uint32_t count;
+} read_out_t;
+
+static read_out_t out;
+
+static void collect(void *ctx, const event_log_record_t *record) {
+    read_out_t *o = ctx;
+    if (o->count < READ_MAX) o->records[o->count] = *record;
+    o->count++;
+}
+
+static uint32_t read_all(const event_log_t *log) {
+    out.count = 0;
+    uint32_t n = event_log_read(log, collect, &out);
+    CHECK_EQ(n, out.count);
+    return n;
+}
+
+// Confere que os minutos lidos são first, first+1, ... sem buracos e devolve quantos
+static uint32_t check_minutes(uint32_t first) {
+    uint32_t expected = first, minutes = 0;
+    for (uint32_t i = 0; i < out.count && i < READ_MAX; i++) {
+        if (out.records[i].type != EVENT_LOG_MINUTE) continue;
+        event_log_record_t want = make_minute(expected);
+        CHECK(same_minute(&out.records[i], &want));
+        expected++;
+        minutes++;
+    }
+    return minutes;
+}
+
+static void test_round_trip(void) {
+    event_log_t log;
+    flash_reset();
+    reboot(&log);
+    CHECK_EQ(log.boot_count, 1);
+    for (uint32_t i = 0; i < 10; i++) {
+        event_log_record_t r = make_minute(i);
+        CHECK(event_log_append(&log, &r));
+    }
+    event_log_record_t alert = { .type = EVENT_LOG_ALERT, .time_s = 305 };
+    alert.alert.rules = 0x5;
+    alert.alert.laf_db_x10 = -12;
+    CHECK(event_log_append(&log, &alert));
+    event_log_commit(&log);
+    CHECK(!event_log_pending(&log));
+
+    reboot(&log);
+    CHECK_EQ(log.boot_count, 2);
+    CHECK_EQ(read_all(&log), 12);
+    CHECK_EQ(out.records[0].type, EVENT_LOG_BOOT);
+    CHECK_EQ(out.records[0].boot.count, 1);
+    CHECK_EQ(check_minutes(0), 10);
+    CHECK_EQ(out.records[11].type, EVENT_LOG_ALERT);
+    CHECK_EQ(out.records[11].time_s, 305);
+    CHECK_EQ(out.records[11].alert.rules, 0x5);
+    CHECK_EQ(out.records[11].alert.laf_db_x10, -12);
+    CHECK_EQ(out.records[10].minute.gap_ms, 0);
+    CHECK_EQ(out.records[1].minute.gap_ms, 87);
+
+    // A partida nova entra depois dos registros antigos e continua o delta
+    event_log_commit(&log);
+    event_log_record_t r = make_minute(10);
+    event_log_append(&log, &r);
+    event_log_commit(&log);
+    reboot(&log);
+    CHECK_EQ(log.boot_count, 3);
+    CHECK_EQ(read_all(&log), 14);
+    CHECK_EQ(out.records[12].type, EVENT_LOG_BOOT);
+    CHECK_EQ(out.records[12].boot.count, 2);
+    CHECK_EQ(check_minutes(0), 11);
+}
+
+// Só o rodízio apaga, e event_log_commit_erases avisa antes exatamente quando
+static void test_commit_erases(void) {
+    event_log_t log;
+    flash_reset();
+    reboot(&log);
+    CHECK(event_log_commit_erases(&log));  // Flash virgem: o primeiro setor é aberto
+    event_log_commit(&log);
+    CHECK_EQ(sector_erases[0], 1);
+    CHECK(!event_log_commit_erases(&log));  // Fila vazia
+
+    uint32_t erases = log.erases, predicted = 0;
+    for (uint32_t i = 0; i < 600; i++) {
+        event_log_record_t r = make_minute(i);
+        event_log_append(&log, &r);
+        bool will_erase = event_log_commit_erases(&log);
+        uint32_t before = programs;
+        event_log_commit(&log);
+        CHECK_EQ(log.erases - erases, will_erase ? 1 : 0);
+        if (!will_erase) CHECK(programs - before <= 2);  // Uma página, ou duas se o registro cruza a divisa
+        predicted += will_erase;
+        erases = log.erases;
+    }
+    CHECK(predicted >= 2);  // 600 minutos passam por mais de um setor
+}
+
+static void test_rotation(void) {
+    event_log_t log;
+    flash_reset();
+    reboot(&log);
+    event_log_commit(&log);
+
+    // Cerca de 250 minutos por setor: 3000 minutos dão quase três voltas
+    const uint32_t minutes = 3000;
+    for (uint32_t i = 0; i < minutes; i++) {
+        event_log_record_t r = make_minute(i);
+        event_log_append(&log, &r);
+        if (i % 3 == 2 || i == minutes - 1) event_log_commit(&log);
+    }
+    uint32_t min_erases = UINT32_MAX, max_erases = 0;
+    for (uint32_t s = 0; s < SECTORS; s++) {
+        if (sector_erases[s] < min_erases) min_erases = sector_erases[s];
+        if (sector_erases[s] > max_erases) max_erases = sector_erases[s];
+    }
+    CHECK(min_erases >= 2);
+    CHECK(max_erases - min_erases <= 1);  // Desgaste nivelado
+
+    reboot(&log);
+    uint32_t n = read_all(&log);
+    // Os setores cheios guardam pelo menos um registro máximo a cada 40 bytes
+    CHECK(n >= (SECTORS - 1) * (EVENT_LOG_SECTOR_SIZE / EVENT_LOG_RECORD_MAX) && n < minutes);
+    // O mais antigo foi descartado; do primeiro lido até o último não falta nenhum
+    CHECK_EQ(out.records[0].type, EVENT_LOG_MINUTE);
+    uint32_t first = out.records[0].minute.peak_max;
+    CHECK(first > 0);
+    CHECK_EQ(check_minutes(first), minutes - first);
+    CHECK_EQ(out.records[n - 1].minute.peak_max, minutes - 1);
+    CHECK_EQ(log.boot_count, 2);  // O registro de partida saiu, mas o número vem do cabeçalho
+}
+
+// Corta a energia em cada byte de um registro: os anteriores sobrevivem, o cortado
+// some e os seguintes são lidos depois da próxima partida
+static void test_torn_record(void) {
+    event_log_t log;
+    event_log_record_t r = make_minute(5);
+    uint8_t buf[EVENT_LOG_RECORD_MAX];
+    event_log_delta_t delta = {0};
+    uint32_t len = event_log_encode(&r, &delta, buf);
+
+    uint32_t cut;
+    for (cut = 0; cut < len; cut++) {
+        flash_reset();
+        reboot(&log);
+        for (uint32_t i = 0; i < 5; i++) {
+            event_log_record_t m = make_minute(i);
+            event_log_append(&log, &m);
+        }
+        event_log_commit(&log);
+
+        event_log_append(&log, &r);
+        power_budget = cut;
+        event_log_commit(&log);
+        if (!power_lost) break;  // Os bytes 0xFF do registro não gastam o orçamento
+
+        reboot(&log);
+        CHECK_EQ(log.boot_count, 2);
+        CHECK_EQ(read_all(&log), 6);
+        CHECK_EQ(check_minutes(0), 5);
+
+        for (uint32_t i = 6; i < 9; i++) {
+            event_log_record_t m = make_minute(i);
+            event_log_append(&log, &m);
+        }
+        event_log_commit(&log);
+        reboot(&log);
+        CHECK_EQ(read_all(&log), 10);
+        for (uint32_t i = 1; i < 6; i++) {
+            event_log_record_t want = make_minute(i - 1);
+            CHECK(same_minute(&out.records[i], &want));
+        }
+        CHECK_EQ(out.records[6].type, EVENT_LOG_BOOT);
+        for (uint32_t i = 7; i < 10; i++) {
+            event_log_record_t want = make_minute(i - 1);
+            CHECK(same_minute(&out.records[i], &want));
+        }
+    }
+    CHECK(cut > len / 2);
+}
+
+// Energia cortada entre o apagamento e o cabeçalho: o setor fica sem cabeçalho e
+// é ignorado, e o próximo commit o abre de novo
+static void test_cut_after_erase(void) {
+    event_log_t log;
+    flash_reset();
+    reboot(&log);
+    event_log_commit(&log);
+    uint32_t i = 0;
+    while (true) {
+        event_log_record_t m = make_minute(i);
+        event_log_append(&log, &m);
+        if (event_log_commit_erases(&log)) break;
+        event_log_commit(&log);
+        i++;
+    }
+    power_budget = 0;
+    event_log_commit(&log);
+    CHECK(power_lost);
+    CHECK_EQ(sector_erases[1], 1);
+
+    reboot(&log);
+    CHECK_EQ(log.sector, 0);
+    CHECK_EQ(read_all(&log), i + 1);  // Partida e os minutos 0..i-1
+    CHECK_EQ(check_minutes(0), i);
+
+    event_log_record_t m = make_minute(i);
+    event_log_append(&log, &m);
+    event_log_commit(&log);
+    CHECK_EQ(sector_erases[1], 2);
+    reboot(&log);
+    CHECK_EQ(read_all(&log), i + 3);
+    CHECK_EQ(out.records[i + 1].type, EVENT_LOG_BOOT);
+    CHECK(same_minute(&out.records[i + 2], &m));
+}
+
+int main(void) {
+    test_round_trip();
+    test_commit_erases();
+    test_rotation();
+    test_torn_record();
+    test_cut_after_erase();
+    return TEST_RESULT();
+}
@@ -0,0 +1,151 @@
+// Fila de mensagens das ISRs (inc/isr_log.h): ordem de entrega, descarte com a
+// fila cheia e registros nunca lidos pela metade, com o produtor (a ISR) e o
+// consumidor (o laço principal) em threads separadas.
+#include <pthread.h>
+#include <sched.h>
+#include "test.h"
+#include "isr_log.h"
+
+#define ITEMS 1000000u
+
+static isr_log_t isr_log;
+
+// Os três campos vêm da mesma sequência, para detectar um registro misturado
+static void push_seq(uint32_t seq, bool *ok) {
+    *ok = isr_log_push(&isr_log, seq, (uint16_t)seq, (uint16_t)(seq >> 16));
+}
+
+static bool entry_consistent(const isr_log_entry_t *e) {
+    return e->id == (uint16_t)e->time_us && e->arg == (uint16_t)(e->time_us >> 16);
+}
+
+typedef struct {
+    bool retry;  // true: espera espaço em vez de descartar
+    uint32_t rejected;
+} producer_t;
+
+static void *producer(void *arg) {
+    producer_t *p = arg;
+    for (uint32_t seq = 0; seq < ITEMS; seq++) {
+        bool ok;
+        for (push_seq(seq, &ok); !ok; push_seq(seq, &ok)) {
+            p->rejected++;
+            if (!p->retry) break;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    uint32_t received;
+    uint32_t out_of_order;
+    uint32_t torn;  // Campos de registros diferentes no mesmo registro
+    uint32_t gaps;
+} consumer_t;
+
+static _Atomic bool producer_done;
+
+static void *consumer(void *arg) {
+    consumer_t *c = arg;
+    uint32_t expected = 0;
+    isr_log_entry_t entry;
+    for (;;) {
+        bool done = atomic_load(&producer_done);
+        if (!isr_log_pop(&isr_log, &entry)) {
+            if (done) break;
+            sched_yield();
+            continue;
+        }
+        if (!entry_consistent(&entry)) c->torn++;
+        if (entry.time_us < expected) c->out_of_order++;
+        else c->gaps += entry.time_us - expected;
+        expected = entry.time_us + 1;
+        c->received++;
+    }
+    if (expected < ITEMS) c->gaps += ITEMS - expected;
+    return NULL;
+}
+
+static void run(producer_t *p, consumer_t *c) {
+    isr_log_init(&isr_log);
+    atomic_store(&producer_done, false);
+    pthread_t tp, tc;
+    pthread_create(&tc, NULL, consumer, c);
+    pthread_create(&tp, NULL, producer, p);
+    pthread_join(tp, NULL);
+    atomic_store(&producer_done, true);
+    pthread_join(tc, NULL);
+}
+
+static void test_lossless_order(void) {
+    producer_t p = { .retry = true };
+    consumer_t c = {0};
+    run(&p, &c);
+    CHECK_EQ(c.received, ITEMS);
+    CHECK_EQ(c.out_of_order, 0);
+    CHECK_EQ(c.torn, 0);
+    CHECK_EQ(c.gaps, 0);
+    CHECK_EQ(isr_log_dropped(&isr_log), p.rejected);
+}
+
+// Como na ISR, que nunca espera: o descartado só aparece como lacuna e em dropped
+static void test_drops_are_counted(void) {
+    producer_t p = { .retry = false };
+    consumer_t c = {0};
+    run(&p, &c);
+    CHECK_EQ(c.out_of_order, 0);
+    CHECK_EQ(c.torn, 0);
+    CHECK_EQ(c.received + isr_log_dropped(&isr_log), ITEMS);
+    CHECK_EQ(c.gaps, isr_log_dropped(&isr_log));
+    CHECK_EQ(p.rejected, isr_log_dropped(&isr_log));
+}
+
+// Em uma thread só: cheia com ISR_LOG_SIZE, os registros antigos ficam e o novo
+// é descartado; índices que passam de 2^32 mantêm a ordem
+static void test_full_and_wrap(void) {
+    isr_log_entry_t entry;
+    bool ok;
+    isr_log_init(&isr_log);
+    CHECK(!isr_log_pop(&isr_log, &entry));
+    for (uint32_t i = 0; i < ISR_LOG_SIZE; i++) {
+        push_seq(i, &ok);
+        CHECK(ok);
+    }
+    push_seq(999, &ok);
+    CHECK(!ok);
+    CHECK_EQ(isr_log_dropped(&isr_log), 1);
+    CHECK(isr_log_pop(&isr_log, &entry));
+    CHECK_EQ(entry.time_us, 0);
+    push_seq(ISR_LOG_SIZE, &ok);  // Um espaço livre de novo
+    CHECK(ok);
+    for (uint32_t i = 1; i <= ISR_LOG_SIZE; i++) {
+        CHECK(isr_log_pop(&isr_log, &entry));
+        CHECK_EQ(entry.time_us, i);
+        CHECK(entry_consistent(&entry));
+    }
+    CHECK(!isr_log_pop(&isr_log, &entry));
+
+    isr_log_init(&isr_log);
+    atomic_store(&isr_log.head, UINT32_MAX - 4);
+    atomic_store(&isr_log.tail, UINT32_MAX - 4);
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 20; i++) {
+            push_seq(round * 20 + i, &ok);
+            CHECK(ok);
+        }
+        for (uint32_t i = 0; i < 20; i++) {
+            CHECK(isr_log_pop(&isr_log, &entry));
+            CHECK_EQ(entry.time_us, round * 20 + i);
+        }
+    }
+    CHECK(!isr_log_pop(&isr_log, &entry));
+    CHECK_EQ(isr_log_dropped(&isr_log), 0);
+}
+
+int main(void) {
+    test_full_and_wrap();
+    test_lossless_order();
+    test_drops_are_counted();
+    return TEST_RESULT();
+}
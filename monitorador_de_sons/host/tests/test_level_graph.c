@@ -0,0 +1,210 @@
+// Gráfico de nível (inc/level_graph.h) no framebuffer do ssd1306 com o painel
+// simulado (mock_i2c.c). Cada push tem de deixar o quadro igual a um
+// redesenho completo (level_graph_draw), com o cursor apagado à direita da
+// coluna nova e a varredura voltando ao início da área; quadros de referência
+// ficam em snapshots/ como texto ('#' aceso), e um quadro diferente é gravado
+// em <nome>.actual.txt no diretório de execução para comparação.
+//
+// Uso (pelo ctest): test_level_graph diretório/snapshots
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "mock_i2c.h"
+#include "level_graph.h"
+
+// Mesma configuração do firmware (monitorador_de_sons.c)
+#define GRAPH_X0 20
+#define GRAPH_MIN_DB_X10 300
+#define GRAPH_MAX_DB_X10 900
+#define THRESHOLD_DB_X10 745
+#define GRAPH_WIDTH (WIDTH - GRAPH_X0)
+#define SNAPSHOT_LEN (HEIGHT * (WIDTH + 1))
+
+static const char *snapshot_dir = ".";
+static ssd1306_t ssd, reference;
+static level_graph_t graph;
+
+static bool pixel(const ssd1306_t *s, uint8_t x, uint8_t y) {
+    return (s->ram_buffer[x * 8 + y / 8] >> (y & 7)) & 1;
+}
+
+static void render(const ssd1306_t *s, char *text) {
+    for (uint8_t y = 0; y < HEIGHT; y++) {
+        for (uint8_t x = 0; x < WIDTH; x++) *text++ = pixel(s, x, y) ? '#' : '.';
+        *text++ = '\n';
+    }
+}
+
+static void check_snapshot(const char *name) {
+    static char actual[SNAPSHOT_LEN + 1], expected[SNAPSHOT_LEN + 1];
+    render(&ssd, actual);
+    actual[SNAPSHOT_LEN] = '\0';
+
+    char path[512];
+    snprintf(path, sizeof path, "%s/%s.txt", snapshot_dir, name);
+    FILE *f = fopen(path, "r");
+    size_t len = f ? fread(expected, 1, SNAPSHOT_LEN, f) : 0;
+    if (f) fclose(f);
+    expected[len] = '\0';
+
+    bool same = len == SNAPSHOT_LEN && memcmp(actual, expected, SNAPSHOT_LEN) == 0;
+    CHECK(same);
+    if (!same) {
+        snprintf(path, sizeof path, "%s.actual.txt", name);
+        f = fopen(path, "w");
+        if (f) {
+            fwrite(actual, 1, SNAPSHOT_LEN, f);
+            fclose(f);
+        }
+        fprintf(stderr, "%s: quadro diferente de %s/%s.txt, gravado em %s\n", name, snapshot_dir, name, path);
+    }
+}
+
+// Envia as alterações ao painel e devolve os bytes de I2C
+static size_t flush(void) {
+    size_t before = mock_panel.wire_bytes;
+    CHECK(ssd1306_send_data_async(&ssd));
+    CHECK(memcmp(mock_panel.ram, ssd.ram_buffer, ssd.bufsize) == 0);
+    return mock_panel.wire_bytes - before;
+}
+
+static void setup(void) {
+    mock_i2c_reset();
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_config(&ssd);
+    ssd1306_init(&reference, WIDTH, HEIGHT, false, 0x3C, i2c0);  // Só o framebuffer, nunca enviado
+    level_graph_init(&graph, GRAPH_X0, GRAPH_WIDTH, GRAPH_MIN_DB_X10, GRAPH_MAX_DB_X10, THRESHOLD_DB_X10);
+    level_graph_draw(&graph, &ssd);
+    ssd1306_send_data(&ssd);
+}
+
+static void teardown(void) {
+    ssd1306_t *all[] = { &ssd, &reference };
+    for (size_t i = 0; i < 2; i++) {
+        free(all[i]->ram_buffer);
+        free(all[i]->dirty);
+        free(all[i]->sent_buffer);
+        free(all[i]->stream);
+    }
+}
+
+// O quadro atualizado coluna a coluna é o mesmo de um redesenho completo
+static bool matches_redraw(void) {
+    level_graph_draw(&graph, &reference);
+    return memcmp(ssd.ram_buffer, reference.ram_buffer, ssd.bufsize) == 0;
+}
+
+// Linha do topo da barra, calculada à parte do módulo: 63 linhas para a faixa
+static int expected_top(int16_t level) {
+    if (level == LEVEL_GRAPH_EMPTY || level < GRAPH_MIN_DB_X10) return HEIGHT;  // Sem barra
+    if (level >= GRAPH_MAX_DB_X10) return 0;
+    int32_t span = GRAPH_MAX_DB_X10 - GRAPH_MIN_DB_X10;
+    return HEIGHT - 1 - ((level - GRAPH_MIN_DB_X10) * (HEIGHT - 1) + span / 2) / span;
+}
+
+// Coluna de um nível: barra do topo até a base e o ponto do limiar invertido
+// nas colunas pares
+static bool column_matches(uint8_t x, int16_t level) {
+    int top = expected_top(level);
+    int threshold = expected_top(THRESHOLD_DB_X10);
+    for (uint8_t y = 0; y < HEIGHT; y++) {
+        bool want = y >= top;
+        if (y == threshold && !(x & 1)) want = !want;
+        if (pixel(&ssd, x, y) != want) return false;
+    }
+    return true;
+}
+
+static bool column_blank(uint8_t x) {
+    for (uint8_t y = 0; y < HEIGHT; y++) {
+        if (pixel(&ssd, x, y)) return false;
+    }
+    return true;
+}
+
+// Eixo, marcas a cada 10 dB, rótulos 90/60/30 e a linha pontilhada do limiar
+static void test_empty(void) {
+    setup();
+    CHECK(column_blank(GRAPH_X0));  // Cursor na primeira coluna
+    for (uint8_t x = GRAPH_X0 + 1; x < WIDTH; x++) CHECK(column_matches(x, LEVEL_GRAPH_EMPTY));
+    check_snapshot("level_graph_empty");
+    teardown();
+}
+
+// Cada push escreve a coluna do cursor e apaga a seguinte, em uma só janela de
+// duas colunas; os níveis fora da faixa ficam recortados
+static void test_sweep_cursor(void) {
+    static const int16_t levels[] = {
+        LEVEL_GRAPH_EMPTY, 299, 300, 301, 450, 600, 744, 745, 746, 899, 900, 901, 1200, -50
+    };
+    setup();
+    for (size_t i = 0; i < sizeof levels / sizeof levels[0]; i++) {
+        uint8_t x = (uint8_t)(GRAPH_X0 + i);
+        level_graph_push(&graph, &ssd, levels[i]);
+        CHECK(column_matches(x, levels[i]));
+        CHECK(column_blank(x + 1));
+        CHECK(flush() <= SSD1306_WINDOW_OVERHEAD + 2 * 8);
+        CHECK(matches_redraw());
+    }
+    // Rampa até a metade da tela
+    for (uint8_t i = 0; i < 40; i++) level_graph_push(&graph, &ssd, (int16_t)(300 + i * 15));
+    flush();
+    CHECK(matches_redraw());
+    check_snapshot("level_graph_sweep");
+    teardown();
+}
+
+// Depois da última coluna a varredura volta a x0: as colunas novas ficam à
+// esquerda do cursor e as antigas à direita, sem deslocar nada
+static void test_wraparound(void) {
+    setup();
+    const uint32_t pushes = GRAPH_WIDTH + 37;
+    for (uint32_t n = 0; n < pushes; n++) {
+        // Serra de 0,5 dB por coluna na primeira volta e degraus na segunda
+        int16_t level = n < GRAPH_WIDTH ? (int16_t)(350 + 5 * n) : (int16_t)(800 - 100 * ((n / 8) % 5));
+        level_graph_push(&graph, &ssd, level);
+        uint8_t x = (uint8_t)(GRAPH_X0 + n % GRAPH_WIDTH);
+        CHECK(column_matches(x, level));
+        uint8_t cursor = (uint8_t)(GRAPH_X0 + (n + 1) % GRAPH_WIDTH);
+        CHECK(column_blank(cursor));
+        CHECK(flush() <= 2 * (SSD1306_WINDOW_OVERHEAD + 8));  // Na volta, a última e a primeira coluna
+        if (!matches_redraw()) {
+            CHECK(false);
+            break;
+        }
+    }
+    CHECK_EQ(graph.head, 37);
+    // À direita do cursor continua a primeira volta
+    for (uint32_t i = 38; i < GRAPH_WIDTH; i++) CHECK(column_matches((uint8_t)(GRAPH_X0 + i), (int16_t)(350 + 5 * i)));
+    check_snapshot("level_graph_wrap");
+    teardown();
+}
+
+// Com outra tela no display os pushes só vão para a RAM do gráfico; o
+// redesenho na volta mostra o mesmo quadro de quem ficou o tempo todo na tela
+static void test_hidden_then_redraw(void) {
+    setup();
+    level_graph_t visible = graph;
+    ssd1306_fill(&ssd, false);
+    for (uint32_t n = 0; n < GRAPH_WIDTH + 5; n++) {
+        int16_t level = (int16_t)(400 + (n * 37) % 500);
+        level_graph_push(&graph, NULL, level);
+        level_graph_push(&visible, &reference, level);
+    }
+    CHECK(column_blank(GRAPH_X0 + 10));  // Nada foi desenhado
+    level_graph_draw(&graph, &ssd);
+    uint8_t shown[WIDTH * HEIGHT / 8];
+    memcpy(shown, reference.ram_buffer, sizeof shown);
+    CHECK(memcmp(ssd.ram_buffer + GRAPH_X0 * 8, shown + GRAPH_X0 * 8, (WIDTH - GRAPH_X0) * 8) == 0);
+    CHECK(matches_redraw());
+    teardown();
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) snapshot_dir = argv[1];
+    test_empty();
+    test_sweep_cursor();
+    test_wraparound();
+    test_hidden_then_redraw();
+    return TEST_RESULT();
+}
@@ -0,0 +1,108 @@
+// Níveis de excedência (L10/L50/L90) de inc/level_stats.h contra o quantil exato
+// dos níveis ordenados, e as médias da janela.
+#include <stdlib.h>
+#include <math.h>
+#include "test.h"
+#include "level_stats.h"
+
+#define MAX_BLOCKS 4000
+
+static int compare_desc(const void *a, const void *b) {
+    return *(const int32_t *)b - *(const int32_t *)a;
+}
+
+// Nível excedido em `percent`% dos blocos: cada bloco de nível v ocupa [v, v + 1)
+// décimos de dB, e o quantil é o ponto com percent% da duração acima dele
+static double exact_exceeded(const int32_t *levels, uint32_t n, uint8_t percent) {
+    static int32_t sorted[MAX_BLOCKS];
+    for (uint32_t i = 0; i < n; i++) sorted[i] = levels[i];
+    qsort(sorted, n, sizeof sorted[0], compare_desc);
+    double position = n * percent / 100.0;  // Blocos acima do quantil
+    uint32_t i = (uint32_t)position;
+    if (i >= n) return sorted[n - 1];
+    return sorted[i] + 1 - (position - i);
+}
+
+static void add_levels(level_stats_t *stats, const int32_t *levels, uint32_t n) {
+    level_stats_reset(stats);
+    for (uint32_t i = 0; i < n; i++) level_stats_add_block(stats, levels[i], 0, 0, 79, 0, false);
+}
+
+static void test_uniform_exact(void) {
+    // Um bloco a cada 0,1 dB de 50,0 a 59,9 dB: a interpolação na faixa é exata
+    static int32_t levels[100];
+    for (int i = 0; i < 100; i++) levels[i] = 500 + i;
+    level_stats_t stats;
+    add_levels(&stats, levels, 100);
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 10), 590);
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 50), 550);
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 90), 510);
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 10), exact_exceeded(levels, 100, 10));
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 0), 600);
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 100), 500);
+}
+
+static void test_random_within_bin(void) {
+    static int32_t levels[MAX_BLOCKS];
+    level_stats_t stats;
+    srand(11);
+    for (int trial = 0; trial < 50; trial++) {
+        uint32_t n = 1 + rand() % MAX_BLOCKS;
+        // Fundo em torno de 45 dB com eventos entre 60 e 90 dB
+        for (uint32_t i = 0; i < n; i++)
+            levels[i] = rand() % 5 ? 420 + rand() % 60 : 600 + rand() % 300;
+        add_levels(&stats, levels, n);
+        for (uint8_t percent = 5; percent <= 95; percent += 5) {
+            // O histograma só sabe em que faixa de 0,5 dB cada bloco caiu
+            CHECK_NEAR(level_stats_exceeded_db_x10(&stats, percent), exact_exceeded(levels, n, percent),
+                       LEVEL_STATS_BIN_DB_X10);
+        }
+    }
+}
+
+static void test_short_and_empty_windows(void) {
+    level_stats_t stats;
+    level_stats_reset(&stats);
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 50), LEVEL_STATS_MIN_DB_X10);
+    CHECK_EQ(level_stats_mean_amplitude(&stats), 0);
+    CHECK_EQ(level_stats_rms_amplitude(&stats), 0);
+    CHECK_EQ(level_stats_mean_loud_peak(&stats), 0);
+
+    // Um único bloco: todos os percentis caem na sua faixa
+    int32_t one = 723;
+    add_levels(&stats, &one, 1);
+    for (uint8_t percent = 10; percent <= 90; percent += 40) {
+        int32_t value = level_stats_exceeded_db_x10(&stats, percent);
+        CHECK(value >= 720 && value <= 725);
+    }
+
+    // Níveis fora da faixa caem nas faixas extremas
+    int32_t extremes[2] = {0, 2000};
+    add_levels(&stats, extremes, 2);
+    CHECK_EQ(stats.histogram[0], 1);
+    CHECK_EQ(stats.histogram[LEVEL_STATS_BINS - 1], 1);
+    CHECK_EQ(level_stats_exceeded_db_x10(&stats, 0),
+             LEVEL_STATS_MIN_DB_X10 + LEVEL_STATS_BINS * LEVEL_STATS_BIN_DB_X10);
+}
+
+static void test_amplitudes(void) {
+    level_stats_t stats;
+    level_stats_reset(&stats);
+    // Blocos de 79 amostras com amplitude constante: média e RMS exatas
+    level_stats_add_block(&stats, 500, 79 * 100, 79ull * 100 * 100, 79, 150, false);
+    level_stats_add_block(&stats, 500, 79 * 300, 79ull * 300 * 300, 79, 2500, true);
+    level_stats_add_block(&stats, 500, 79 * 200, 79ull * 200 * 200, 79, 1800, true);
+    CHECK_EQ(level_stats_mean_amplitude(&stats), 200);
+    CHECK_EQ(level_stats_rms_amplitude(&stats), (uint32_t)lround(sqrt((100.0 * 100 + 300 * 300 + 200 * 200) / 3)));
+    CHECK_EQ(stats.peak_max, 2500);
+    CHECK_EQ(stats.loud_blocks, 2);
+    CHECK_EQ(level_stats_mean_loud_peak(&stats), 2150);
+}
+
+int main(void) {
+    test_uniform_exact();
+    test_random_within_bin();
+    test_short_and_empty_windows();
+    test_amplitudes();
+    return TEST_RESULT();
+}
@@ -0,0 +1,127 @@
+// Medidor (inc/metering.h) com tons de referência: ganho da ponderação A contra
+// a IEC 61672, nível absoluto com a calibração, constantes de tempo Fast/Slow
+// e LAeq da janela.
+#include <math.h>
+#include "test.h"
+#include "metering.h"
+
+#define BLOCK 79
+#define OFFSET 2048
+#define CAL_DB_X10 200
+
+// Ponderação A da IEC 61672-1 (dB) pela fórmula analítica
+static double a_weighting_db(double f) {
+    double f2 = f * f;
+    double ra = 12194.217 * 12194.217 * f2 * f2
+              / ((f2 + 20.598997 * 20.598997) * sqrt((f2 + 107.65265 * 107.65265) * (f2 + 737.86223 * 737.86223))
+                 * (f2 + 12194.217 * 12194.217));
+    return 20.0 * log10(ra) + 2.0;
+}
+
+typedef struct {
+    meter_t meter;
+    uint32_t rate;
+    double phase;
+} tone_t;
+
+static void tone_init(tone_t *t, uint32_t rate) {
+    t->rate = rate;
+    t->phase = 0;
+    metering_init(&t->meter, rate, BLOCK, OFFSET, 0, CAL_DB_X10);
+}
+
+// Alimenta `ms` milissegundos de senoide (amplitude 0: silêncio) em blocos de BLOCK amostras
+static void feed(tone_t *t, double freq, double amplitude, uint32_t ms) {
+    uint32_t blocks = (uint32_t)((uint64_t)ms * t->rate / (1000u * BLOCK));
+    uint16_t buf[BLOCK];
+    for (uint32_t b = 0; b < blocks; b++) {
+        for (uint32_t i = 0; i < BLOCK; i++) {
+            buf[i] = (uint16_t)lround(OFFSET + amplitude * sin(t->phase));
+            t->phase += 2.0 * M_PI * freq / t->rate;
+        }
+        metering_process_block(&t->meter, buf, BLOCK);
+    }
+}
+
+// LAeq de 2 s de tom, depois de 1 s para o filtro entrar em regime
+static double steady_level_db(uint32_t rate, double freq, double amplitude) {
+    tone_t t;
+    tone_init(&t, rate);
+    feed(&t, freq, amplitude, 1000);
+    metering_reset_window(&t.meter);
+    feed(&t, freq, amplitude, 2000);
+    return metering_laeq_db_x10(&t.meter) / 10.0;
+}
+
+static void test_a_weighting(void) {
+    const double amplitude = 1000.0;
+    // Senoide de amplitude A: 20 log10(A / sqrt(2)) dB em relação a 1 LSB RMS
+    double expected_1k = 20.0 * log10(amplitude / sqrt(2.0)) + CAL_DB_X10 / 10.0;
+
+    double l1k = steady_level_db(16000, 1000.0, amplitude);
+    CHECK_NEAR(l1k, expected_1k, 0.2);
+
+    // 31,5 Hz: -39,4 dB; tolerância da classe 1 em 31,5 Hz é ±1,5 dB
+    double l31 = steady_level_db(16000, 31.5, amplitude);
+    CHECK_NEAR(l31 - l1k, a_weighting_db(31.5), 1.5);
+    CHECK_NEAR(a_weighting_db(31.5), -39.4, 0.15);  // Tabela da norma: frequência exata 31,62 Hz
+
+    // 8 kHz é a frequência de Nyquist a 16 kS/s, onde a transformação bilinear
+    // zera o ganho; o projeto do filtro é conferido em 48 kS/s (-1,1 dB, classe 1: +1,5/-2,5 dB)
+    double l1k_48 = steady_level_db(48000, 1000.0, amplitude);
+    CHECK_NEAR(l1k_48, expected_1k, 0.2);
+    double l8k = steady_level_db(48000, 8000.0, amplitude);
+    double delta = l8k - l1k_48 - a_weighting_db(8000.0);
+    CHECK(delta <= 1.5 && delta >= -2.5);
+    CHECK_NEAR(a_weighting_db(8000.0), -1.1, 0.05);
+
+    // Na taxa do firmware, o agudo até 4 kHz fica na classe 1 (±1,6 dB) apesar da distorção da bilinear
+    double l4k = steady_level_db(16000, 4000.0, amplitude);
+    CHECK_NEAR(l4k - l1k, a_weighting_db(4000.0), 1.6);
+}
+
+// Decaimento depois de desligar o tom: Fast 34,7 dB/s (10 log10(e) / 0,125 s)
+// e Slow 4,34 dB/s, medidos na inclinação do LAF/LAS
+static void test_time_constants(void) {
+    tone_t t;
+    tone_init(&t, 16000);
+    feed(&t, 1000.0, 1000.0, 3000);
+    int32_t laf0 = metering_laf_db_x10(&t.meter), las0 = metering_las_db_x10(&t.meter);
+    feed(&t, 0, 0, 200);
+    double fast_rate = (laf0 - metering_laf_db_x10(&t.meter)) / 10.0 / 0.2;
+    CHECK_NEAR(fast_rate, 10.0 * log10(exp(1.0)) / 0.125, 34.7 * 0.05);
+    feed(&t, 0, 0, 800);
+    double slow_rate = (las0 - metering_las_db_x10(&t.meter)) / 10.0 / 1.0;
+    CHECK_NEAR(slow_rate, 10.0 * log10(exp(1.0)) / 1.0, 4.34 * 0.05);
+
+    // Subida a partir do silêncio: depois de uma constante de tempo o LAF está a
+    // 10 log10(1 - 1/e) = -2,0 dB do valor final
+    tone_init(&t, 16000);
+    feed(&t, 1000.0, 1000.0, 3000);
+    int32_t final = metering_laf_db_x10(&t.meter);
+    tone_init(&t, 16000);
+    feed(&t, 1000.0, 1000.0, 125);
+    CHECK_NEAR((metering_laf_db_x10(&t.meter) - final) / 10.0, 10.0 * log10(1.0 - exp(-1.0)), 0.4);
+}
+
+// LAeq de uma janela com metade em tom e metade em silêncio: 3 dB abaixo do tom
+static void test_leq(void) {
+    tone_t t;
+    tone_init(&t, 16000);
+    feed(&t, 1000.0, 1000.0, 1000);
+    metering_reset_window(&t.meter);
+    feed(&t, 1000.0, 1000.0, 2000);
+    int32_t tone_leq = metering_laeq_db_x10(&t.meter);
+    metering_reset_window(&t.meter);
+    feed(&t, 1000.0, 1000.0, 2000);
+    feed(&t, 0, 0, 2000);
+    CHECK_NEAR((tone_leq - metering_laeq_db_x10(&t.meter)) / 10.0, 10.0 * log10(2.0), 0.2);
+    CHECK_NEAR(metering_lafmax_db_x10(&t.meter), tone_leq, 2);
+}
+
+int main(void) {
+    test_a_weighting();
+    test_time_constants();
+    test_leq();
+    return TEST_RESULT();
+}
@@ -0,0 +1,154 @@
+// Medição das etapas (inc/profiling.c) com o SysTick e o número do core
+// simulados. O módulo é incluído aqui para o teste ver o anel de eventos e as
+// estatísticas, que no firmware só saem por profiling_dump.
+#define PROFILING_ENABLED 1
+#include <string.h>
+#include <unistd.h>
+#include "test.h"
+#include "../../inc/profiling.c"
+
+systick_hw_t systick_sim;
+static uint core_now;
+static uint32_t now_us;
+
+uint get_core_num(void) { return core_now; }
+uint32_t time_us_32(void) { return now_us; }
+uint32_t clock_get_hz(enum clock_index clk_index) { (void)clk_index; return 125000000; }
+
+// Etapa que começa com o SysTick em `start` e dura `cycles` (ele conta para baixo)
+static void record_at(uint core, prof_stage_t stage, uint32_t start, uint32_t cycles) {
+    core_now = core;
+    systick_sim.cvr = start;
+    PROF_BEGIN(stage);
+    systick_sim.cvr = (start - cycles) & 0x00FFFFFF;
+    now_us++;
+    PROF_END(stage);
+}
+
+static void reset_all(void) {
+    profiling_init();
+    profiling_reset();
+    memset(trace, 0, sizeof trace);
+    atomic_store(&trace_head[0], 0);
+    atomic_store(&trace_head[1], 0);
+    now_us = 0;
+}
+
+// Cada core tem seu anel, na ordem de gravação, mesmo intercalando os dois
+static void test_trace_order_per_core(void) {
+    reset_all();
+    for (uint32_t i = 0; i < 40; i++) {
+        record_at(i % 3 == 0, (prof_stage_t)(i % PROF_STAGE_COUNT), 0x800000, 100 + i);
+    }
+    uint32_t head0 = atomic_load(&trace_head[0]), head1 = atomic_load(&trace_head[1]);
+    CHECK_EQ(head0 + head1, 40);
+    CHECK_EQ(head1, 14);
+    uint32_t k[2] = {0, 0};
+    for (uint32_t i = 0; i < 40; i++) {
+        uint core = i % 3 == 0;
+        const prof_event_t *e = &trace[core][k[core]++];
+        CHECK_EQ(e->timestamp_us, i + 1);
+        CHECK_EQ(e->stage, i % PROF_STAGE_COUNT);
+        CHECK_EQ(e->cycles, 100 + i);
+    }
+}
+
+// O anel guarda os últimos PROF_TRACE_SIZE eventos, do mais antigo ao mais novo
+static void test_trace_wraparound(void) {
+    reset_all();
+    const uint32_t events = 3 * PROF_TRACE_SIZE + 5;
+    for (uint32_t i = 0; i < events; i++) record_at(0, PROF_STAGE_ANALYSIS, 0x100000, i);
+    uint32_t head = atomic_load(&trace_head[0]);
+    CHECK_EQ(head, events);
+    for (uint32_t k = head - PROF_TRACE_SIZE; k != head; k++) {
+        const prof_event_t *e = &trace[0][k & (PROF_TRACE_SIZE - 1)];
+        CHECK_EQ(e->timestamp_us, k + 1);
+        CHECK_EQ(e->cycles, k);
+    }
+    CHECK_EQ(stats[PROF_STAGE_ANALYSIS].count, events);
+}
+
+// Duração com o SysTick passando por zero (24 bits, contando para baixo)
+static void test_systick_wrap(void) {
+    reset_all();
+    record_at(0, PROF_STAGE_DMA_IRQ, 10, 16);
+    record_at(0, PROF_STAGE_DMA_IRQ, 0, 1);
+    record_at(0, PROF_STAGE_DMA_IRQ, 0x00FFFFFF, 0x00FFFFFE);
+    const prof_stats_t *s = &stats[PROF_STAGE_DMA_IRQ];
+    CHECK_EQ(s->count, 3);
+    CHECK_EQ(s->min_cycles, 1);
+    CHECK_EQ(s->max_cycles, 0x00FFFFFE);
+    CHECK_EQ(s->total_cycles, 16 + 1 + 0x00FFFFFE);
+}
+
+// Cada valor cai em uma faixa cujo limite superior está acima dele e a menos de
+// 1/4 de oitava; o p99 fica entre o valor real e esse limite
+static void test_histogram(void) {
+    for (uint32_t c = 0; c < (1u << 24); c += 1 + c / 1024) {
+        uint16_t b = hist_bucket(c);
+        CHECK(b < PROF_HIST_BUCKETS);
+        uint32_t upper = hist_upper(b);
+        if (c >= upper || (b > 0 && c < hist_upper(b - 1))) {
+            CHECK(false);
+            break;
+        }
+        CHECK(upper - c <= c / 4 + 1);
+    }
+
+    reset_all();
+    for (uint32_t i = 0; i < 990; i++) record_at(0, PROF_STAGE_LEDS, 0x200000, 100);
+    for (uint32_t i = 0; i < 10; i++) record_at(0, PROF_STAGE_LEDS, 0x200000, 20000);
+    const prof_stats_t *s = &stats[PROF_STAGE_LEDS];
+    uint32_t p99 = percentile_cycles(s, 99);
+    CHECK(p99 >= 100 && p99 <= 125);
+    CHECK_EQ(percentile_cycles(s, 100), 20000);  // Limitado ao máximo visto
+}
+
+// profiling_dump lista os eventos de cada core do mais antigo ao mais novo
+static void test_dump_order(void) {
+    reset_all();
+    for (uint32_t i = 0; i < PROF_TRACE_SIZE + 10; i++) record_at(i & 1, PROF_STAGE_DISPLAY, 0x300000, 1250);
+
+    FILE *capture = tmpfile();
+    fflush(stdout);
+    int saved = dup(fileno(stdout));
+    dup2(fileno(capture), fileno(stdout));
+    profiling_dump();
+    fflush(stdout);
+    dup2(saved, fileno(stdout));
+    close(saved);
+
+    rewind(capture);
+    char line[160];
+    int core = -1;
+    uint32_t last = 0, listed[2] = {0, 0}, out_of_order = 0;
+    while (fgets(line, sizeof line, capture)) {
+        unsigned n, c;
+        if (sscanf(line, "Últimos %u eventos do core %u", &n, &c) == 2) {
+            core = (int)c;
+            last = 0;
+            CHECK_EQ(n, (PROF_TRACE_SIZE + 10) / 2);
+            continue;
+        }
+        unsigned t;
+        if (core >= 0 && sscanf(line, " %u display %*s", &t) == 1) {
+            if (t <= last) out_of_order++;
+            CHECK_EQ(t % 2, core == 0);  // Core 0 gravou nos instantes ímpares
+            last = t;
+            listed[core]++;
+        }
+    }
+    fclose(capture);
+    CHECK_EQ(listed[0], (PROF_TRACE_SIZE + 10) / 2);
+    CHECK_EQ(listed[1], (PROF_TRACE_SIZE + 10) / 2);
+    CHECK_EQ(out_of_order, 0);
+}
+
+int main(void) {
+    test_trace_order_per_core();
+    test_trace_wraparound();
+    test_systick_wrap();
+    test_histogram();
+    test_dump_order();
+    return TEST_RESULT();
+}
@@ -0,0 +1,243 @@
+// Captura bruta (inc/raw_stream.h): quadros byte a byte, escrita em pedaços
+// retomada no meio do quadro, salto com o envio atrasado e quadro sobrescrito
+// durante o envio. Com --capture SHIFT grava no stdout uma captura como a do
+// CDC do USB (texto do firmware entre os quadros, blocos perdidos e um quadro
+// inválido), e com --expected SHIFT descreve em JSON os blocos válidos e o PCM
+// que tools/raw_stream_wav.py tem de gerar, para test_raw_stream_wav.py.
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "raw_stream.h"
+
+#define RATE_HZ 16000
+#define SAMPLES 79
+#define CHANNELS 2
+#define BLOCK (SAMPLES * CHANNELS)
+#define FRAME_LEN (RAW_STREAM_HEADER_LEN + BLOCK * 2 + RAW_STREAM_TRAILER_LEN)
+#define OUT_MAX (1 << 20)
+
+static uint16_t blocks[RAW_STREAM_BLOCKS * BLOCK];
+static raw_stream_t rs;
+static uint8_t sent[OUT_MAX];
+static size_t sent_len;
+static size_t write_limit = SIZE_MAX;  // Bytes que a escrita ainda aceita (0: USB cheio)
+static size_t write_chunk = SIZE_MAX;  // Máximo por chamada
+
+static size_t capture_write(const uint8_t *data, size_t len) {
+    if (len > write_limit) len = write_limit;
+    if (len > write_chunk) len = write_chunk;
+    if (sent_len + len > OUT_MAX) len = OUT_MAX - sent_len;
+    memcpy(sent + sent_len, data, len);
+    sent_len += len;
+    if (write_limit != SIZE_MAX) write_limit -= len;
+    return len;
+}
+
+static void text(const char *s) {
+    capture_write((const uint8_t *)s, strlen(s));
+}
+
+// Amostra do canal c na posição i do bloco seq. Com shift 0 algumas passam dos
+// 12 bits (o WAV as satura); os extremos 0 e 0xFFFF aparecem nos dois casos.
+static uint16_t sample_at(uint32_t seq, uint8_t c, uint32_t i, uint8_t shift) {
+    uint32_t h = (seq * 2654435761u) ^ (i * 40503u) ^ (c * 0x9E37u);
+    if (i == 5) return 0;
+    if (i == 6) return 0xFFFF;
+    uint32_t range = 1u << (12 + shift);
+    return (uint16_t)(h % range);
+}
+
+static void produce(uint32_t seq, uint8_t shift) {
+    uint16_t *slot = raw_stream_slot(&rs);
+    for (uint8_t c = 0; c < CHANNELS; c++) {
+        for (uint32_t i = 0; i < SAMPLES; i++) slot[c * SAMPLES + i] = sample_at(seq, c, i, shift);
+    }
+    raw_stream_publish(&rs, seq);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void reset(uint8_t shift) {
+    sent_len = 0;
+    write_limit = write_chunk = SIZE_MAX;
+    raw_stream_init(&rs, blocks, RATE_HZ, SAMPLES, CHANNELS, shift, (uint16_t)(2048u << shift));
+}
+
+// Cabeçalho, amostras e sequência final no layout documentado
+static void test_frame_layout(void) {
+    reset(4);
+    produce(0x01020304, 4);
+    CHECK_EQ(raw_stream_service(&rs, capture_write), FRAME_LEN);
+    CHECK_EQ(sent_len, FRAME_LEN);
+    CHECK(memcmp(sent, "MRAW", 4) == 0);
+    CHECK_EQ(get_u32(sent + 4), 0x01020304);
+    CHECK_EQ(get_u32(sent + 8), RATE_HZ);
+    CHECK_EQ(sent[12] | (sent[13] << 8), SAMPLES);
+    CHECK_EQ(sent[14], CHANNELS);
+    CHECK_EQ(sent[15], 4);
+    CHECK_EQ(sent[16] | (sent[17] << 8), 2048u << 4);
+    CHECK_EQ(sent[18], RAW_STREAM_VERSION);
+    for (uint32_t i = 0; i < BLOCK; i++) {
+        const uint8_t *p = sent + RAW_STREAM_HEADER_LEN + 2 * i;
+        CHECK_EQ(p[0] | (p[1] << 8), sample_at(0x01020304, (uint8_t)(i / SAMPLES), i % SAMPLES, 4));
+    }
+    CHECK_EQ(get_u32(sent + FRAME_LEN - 4), 0x01020304);
+    CHECK_EQ(rs.frames, 1);
+    CHECK_EQ(raw_stream_service(&rs, capture_write), 0);  // Nada novo
+}
+
+// Escrita que aceita poucos bytes por vez e às vezes nenhum: o fluxo sai igual
+static void test_chunked_resume(void) {
+    reset(4);
+    for (uint32_t seq = 0; seq < 5; seq++) produce(seq, 4);
+    raw_stream_service(&rs, capture_write);
+    static uint8_t whole[5 * FRAME_LEN];
+    memcpy(whole, sent, sent_len);
+    CHECK_EQ(sent_len, 5 * FRAME_LEN);
+
+    reset(4);
+    for (uint32_t seq = 0; seq < 5; seq++) produce(seq, 4);
+    write_chunk = 7;
+    for (uint32_t call = 0; rs.frames < 5 && call < 10000; call++) {
+        write_limit = call % 3 == 0 ? 0 : 1 + call % 23;
+        raw_stream_service(&rs, capture_write);
+    }
+    CHECK_EQ(sent_len, 5 * FRAME_LEN);
+    CHECK(memcmp(sent, whole, sizeof whole) == 0);
+    CHECK_EQ(rs.overwritten, 0);
+    CHECK_EQ(rs.skipped, 0);
+}
+
+// Envio atrasado: o consumidor salta para o bloco completo mais recente
+static void test_skip_when_behind(void) {
+    reset(4);
+    for (uint32_t seq = 0; seq < RAW_STREAM_BLOCKS + 3; seq++) produce(seq, 4);
+    raw_stream_service(&rs, capture_write);
+    CHECK_EQ(rs.skipped, RAW_STREAM_BLOCKS + 2);
+    CHECK_EQ(rs.frames, 1);
+    CHECK_EQ(get_u32(sent + 4), RAW_STREAM_BLOCKS + 2);
+}
+
+// O produtor alcança o bloco em envio: o quadro sai com ~seq no fim
+static void test_overwritten_frame(void) {
+    reset(4);
+    produce(0, 4);
+    write_limit = RAW_STREAM_HEADER_LEN + 10;
+    raw_stream_service(&rs, capture_write);
+    for (uint32_t seq = 1; seq <= RAW_STREAM_BLOCKS; seq++) produce(seq, 4);
+    write_limit = FRAME_LEN - (RAW_STREAM_HEADER_LEN + 10);
+    raw_stream_service(&rs, capture_write);
+    CHECK_EQ(sent_len, FRAME_LEN);
+    CHECK_EQ(get_u32(sent + 4), 0);
+    CHECK_EQ(get_u32(sent + FRAME_LEN - 4), ~0u);  // ~ da sequência do cabeçalho, não da do bloco novo
+    CHECK_EQ(rs.overwritten, 1);
+}
+
+typedef struct {
+    uint32_t seqs[256];  // Sequências dos quadros íntegros, em ordem
+    uint32_t count;
+    uint32_t invalid;    // Quadros com ~seq no fim
+} frame_scan_t;
+
+static frame_scan_t scan;
+
+// Envia tudo o que foi publicado, em pedaços de tamanho variado
+static void service_chunked(void) {
+    do {
+        write_limit = 1 + (sent_len * 7) % 97;
+    } while (raw_stream_service(&rs, capture_write) > 0);
+    write_limit = SIZE_MAX;
+}
+
+// Captura com tudo o que o conversor deve tolerar
+static void build_capture(uint8_t shift) {
+    reset(shift);
+    text("Monitorador de sons\n-- COMUNICAÇÃO ATIVADA --\n");
+    uint32_t seq = 100;
+    for (uint32_t i = 0; i < 12; i++) {
+        produce(seq++, shift);
+        service_chunked();
+        if (i % 4 == 3) text("\n[12.345 s] --> Buzzers Passivos foram: Ativados\n");
+    }
+    seq += 3;  // Blocos perdidos na captura (fila cheia)
+    for (uint32_t i = 0; i < 5; i++) {
+        produce(seq++, shift);
+        service_chunked();
+    }
+    // Envio atrasado: o anel é pulado até o bloco completo mais recente
+    for (uint32_t i = 0; i < RAW_STREAM_BLOCKS + 4; i++) produce(seq++, shift);
+    service_chunked();
+    // Quadro sobrescrito durante o envio
+    produce(seq++, shift);
+    write_limit = RAW_STREAM_HEADER_LEN + 40;
+    raw_stream_service(&rs, capture_write);
+    for (uint32_t i = 0; i < RAW_STREAM_BLOCKS; i++) produce(seq++, shift);
+    service_chunked();
+    for (uint32_t i = 0; i < 6; i++) {
+        produce(seq++, shift);
+        service_chunked();
+    }
+    text("--> Captura bruta encerrada\n");
+}
+
+// Percorre a captura montada e separa os quadros íntegros, pela sequência final
+static void scan_capture(frame_scan_t *log) {
+    memset(log, 0, sizeof *log);
+    for (size_t pos = 0; pos + FRAME_LEN <= sent_len; pos++) {
+        if (memcmp(sent + pos, "MRAW", 4) != 0) continue;
+        uint32_t seq = get_u32(sent + pos + 4), trailer = get_u32(sent + pos + FRAME_LEN - 4);
+        if (trailer == seq) log->seqs[log->count++] = seq;
+        else if (trailer == ~seq) log->invalid++;
+        pos += FRAME_LEN - 1;
+    }
+}
+
+static void write_expected(uint8_t shift) {
+    scan_capture(&scan);
+    uint32_t first = scan.seqs[0], last = scan.seqs[scan.count - 1];
+    uint16_t center = (uint16_t)(2048u << shift);
+    int scale = 4 - shift;
+    printf("{\"rate\": %u, \"samples\": %u, \"channels\": %u, \"shift\": %u,\n", RATE_HZ, SAMPLES, CHANNELS, shift);
+    printf(" \"invalid\": %u, \"lost\": %u,\n", scan.invalid, last - first + 1 - scan.count);
+    printf(" \"blocks\": [\n");
+    for (uint32_t b = 0; b < scan.count; b++) {
+        printf("  {\"seq\": %u, \"pcm\": \"", scan.seqs[b]);
+        // WAV intercalado, 16 bits little-endian, silêncio em 0 e saturado
+        for (uint32_t i = 0; i < SAMPLES; i++) {
+            for (uint8_t c = 0; c < CHANNELS; c++) {
+                int32_t d = (int32_t)sample_at(scan.seqs[b], c, i, shift) - center;
+                int32_t v = scale >= 0 ? d * (1 << scale) : d >> -scale;
+                if (v > 32767) v = 32767;
+                if (v < -32768) v = -32768;
+                uint16_t u = (uint16_t)(int16_t)v;
+                printf("%02x%02x", u & 0xFF, u >> 8);
+            }
+        }
+        printf("\"}%s\n", b + 1 < scan.count ? "," : "");
+    }
+    printf(" ]}\n");
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2 && (!strcmp(argv[1], "--capture") || !strcmp(argv[1], "--expected"))) {
+        uint8_t shift = (uint8_t)atoi(argv[2]);
+        build_capture(shift);
+        if (!strcmp(argv[1], "--capture")) fwrite(sent, 1, sent_len, stdout);
+        else write_expected(shift);
+        return 0;
+    }
+    test_frame_layout();
+    test_chunked_resume();
+    test_skip_when_behind();
+    test_overwritten_frame();
+
+    // A própria captura tem de ter o que o teste do conversor espera encontrar
+    build_capture(4);
+    scan_capture(&scan);
+    CHECK(scan.count >= 20);
+    CHECK_EQ(scan.invalid, 1);
+    CHECK(scan.seqs[scan.count - 1] - scan.seqs[0] + 1 > scan.count);
+    return TEST_RESULT();
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Ida e volta da captura bruta: a captura gerada por test_raw_stream --capture
+passa por tools/raw_stream_wav.py lida de arquivo, do stdin (com --fill-gaps) e
+de um pseudo-terminal fazendo o papel do CDC do USB, e o WAV tem de trazer
+exatamente o PCM dos blocos íntegros (test_raw_stream --expected), com os
+blocos perdidos e o quadro sobrescrito contados no resumo.
+
+No pseudo-terminal o teste responde como o firmware: espera o 's' que liga a
+captura, envia os quadros e espera o 's' que a desliga. Sem o pyserial, um
+substituto mínimo de serial.Serial é posto no PYTHONPATH da ferramenta.
+
+Uso (pelo ctest): test_raw_stream_wav.py caminho/test_raw_stream tools/raw_stream_wav.py
+"""
+
+import json
+import os
+import re
+import select
+import subprocess
+import sys
+import tempfile
+import tty
+import wave
+
+SERIAL_STUB = '''
+import os, select, termios, tty
+
+class Serial:
+    def __init__(self, port, baudrate=115200, timeout=None):
+        self.fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        self.timeout = timeout
+        self.is_open = True
+
+    def reset_input_buffer(self):
+        termios.tcflush(self.fd, termios.TCIFLUSH)
+
+    def write(self, data):
+        return os.write(self.fd, data)
+
+    def read(self, size):
+        ready, _, _ = select.select([self.fd], [], [], self.timeout)
+        return os.read(self.fd, size) if ready else b""
+'''
+
+
+def run_helper(helper, *args):
+    return subprocess.run([helper, *args], check=True, capture_output=True).stdout
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as wav:
+        return wav.getframerate(), wav.getnchannels(), wav.getsampwidth(), wav.readframes(wav.getnframes())
+
+
+def summary_counts(stderr):
+    match = re.search(r"(\d+) blocos, .*?, (\d+) blocos perdidos, (\d+) quadros inválidos", stderr)
+    return tuple(int(g) for g in match.groups()) if match else None
+
+
+def check(name, expected, wav_path, stderr, fill_gaps, failures):
+    rate, channels, width, pcm = read_wav(wav_path)
+    if (rate, channels, width) != (expected["rate"], expected["channels"], 2):
+        failures.append(f"{name}: formato {rate} Hz, {channels} canais, {width} bytes")
+    blocks = expected["blocks"]
+    block_bytes = expected["samples"] * expected["channels"] * 2
+    want = bytearray()
+    previous = None
+    for block in blocks:
+        if fill_gaps and previous is not None:
+            want += bytes((block["seq"] - previous - 1) * block_bytes)
+        want += bytes.fromhex(block["pcm"])
+        previous = block["seq"]
+    if pcm != bytes(want):
+        diff = next((i for i, (a, b) in enumerate(zip(pcm, want)) if a != b), min(len(pcm), len(want)))
+        failures.append(f"{name}: PCM difere no byte {diff} ({len(pcm)} bytes, esperados {len(want)})")
+    counts = summary_counts(stderr)
+    if counts != (len(blocks), expected["lost"], expected["invalid"]):
+        failures.append(f"{name}: resumo '{stderr.strip()}', esperados {len(blocks)} blocos, "
+                        f"{expected['lost']} perdidos e {expected['invalid']} inválidos")
+
+
+def wait_for(fd, byte, timeout):
+    ready, _, _ = select.select([fd], [], [], timeout)
+    return bool(ready) and os.read(fd, 64).endswith(byte)
+
+
+def run_pty(tool, capture, expected, wav_path, workdir):
+    env = dict(os.environ)
+    try:
+        import serial  # noqa: F401
+    except ImportError:
+        with open(os.path.join(workdir, "serial.py"), "w") as stub:
+            stub.write(SERIAL_STUB)
+        env["PYTHONPATH"] = workdir + os.pathsep + env.get("PYTHONPATH", "")
+
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    audio = len(expected["blocks"]) * expected["samples"]
+    seconds = (audio - expected["samples"] / 2) / expected["rate"]  # Para logo depois do último bloco
+    proc = subprocess.Popen([sys.executable, tool, os.ttyname(slave), wav_path, "--seconds", f"{seconds:.6f}"],
+                            env=env, stderr=subprocess.PIPE)
+    problems = []
+    try:
+        if not wait_for(master, b"s", 5):
+            problems.append("o 's' que liga a captura não chegou")
+        for start in range(0, len(capture), 1000):  # Como o USB entrega, em pacotes
+            os.write(master, capture[start:start + 1000])
+        if not wait_for(master, b"s", 10):
+            problems.append("o 's' que desliga a captura não chegou")
+        _, stderr = proc.communicate(timeout=10)
+    finally:
+        if proc.poll() is None:
+            proc.kill()
+            proc.communicate()
+        os.close(master)
+        os.close(slave)
+    if proc.returncode != 0:
+        problems.append(f"saiu com {proc.returncode}")
+    return problems, stderr.decode()
+
+
+def main():
+    helper, tool = sys.argv[1], sys.argv[2]
+    failures = []
+    with tempfile.TemporaryDirectory() as workdir:
+        for shift in (4, 0):
+            capture = run_helper(helper, "--capture", str(shift))
+            expected = json.loads(run_helper(helper, "--expected", str(shift)))
+            capture_path = os.path.join(workdir, f"captura{shift}.bin")
+            with open(capture_path, "wb") as f:
+                f.write(capture)
+
+            wav_path = os.path.join(workdir, f"arquivo{shift}.wav")
+            result = subprocess.run([sys.executable, tool, capture_path, wav_path], capture_output=True, text=True)
+            if result.returncode != 0:
+                failures.append(f"arquivo, shift {shift}: {result.stderr.strip()}")
+            else:
+                check(f"arquivo, shift {shift}", expected, wav_path, result.stderr, False, failures)
+
+            wav_path = os.path.join(workdir, f"stdin{shift}.wav")
+            result = subprocess.run([sys.executable, tool, "-", wav_path, "--fill-gaps"], input=capture,
+                                    capture_output=True)
+            if result.returncode != 0:
+                failures.append(f"stdin, shift {shift}: {result.stderr.decode().strip()}")
+            else:
+                check(f"stdin, shift {shift}", expected, wav_path, result.stderr.decode(), True, failures)
+
+            wav_path = os.path.join(workdir, f"pty{shift}.wav")
+            problems, stderr = run_pty(tool, capture, expected, wav_path, workdir)
+            if problems:
+                failures += [f"pty, shift {shift}: {p} ({stderr.strip()})" for p in problems]
+            else:
+                check(f"pty, shift {shift}", expected, wav_path, stderr, False, failures)
+
+    for failure in failures:
+        print(failure, file=sys.stderr)
+    print(f"captura bruta: 6 conversões, {len(failures)} falhas")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,171 @@
+// Escalonador (inc/scheduler.h) com relógio simulado: o laço de teste faz o que o
+// laço principal do firmware faz, executando tudo o que está pronto e então
+// "dormindo" até sched_next_due (ou até o próximo evento de ISR).
+#include <string.h>
+#include "test.h"
+#include "scheduler.h"
+#include "alert.h"
+
+#define MAX_RUNS 64
+
+static scheduler_t sched;
+static uint32_t clock_ms;
+static struct { int task; uint32_t at; } runs[MAX_RUNS];
+static int run_count;
+
+static void record(int task, uint32_t now) {
+    if (run_count < MAX_RUNS) {
+        runs[run_count].task = task;
+        runs[run_count].at = now;
+    }
+    run_count++;
+}
+
+static void task_a(uint32_t now) { record(0, now); }
+static void task_b(uint32_t now) { record(1, now); }
+static void task_c(uint32_t now) { record(2, now); }
+
+static void setup(uint32_t start_ms) {
+    sched_init(&sched);
+    clock_ms = start_ms;
+    run_count = 0;
+}
+
+// Executa até esvaziar e avança o relógio até o próximo prazo, sem passar de `until`
+static void run_until(uint32_t until) {
+    for (;;) {
+        while (sched_run(&sched, sched_take_posted(&sched), clock_ms)) {}
+        uint32_t due;
+        if (!sched_next_due(&sched, &due) || (int32_t)(due - until) > 0) break;
+        if ((int32_t)(due - clock_ms) > 0) clock_ms = due;
+    }
+    clock_ms = until;
+}
+
+static void test_priority(void) {
+    setup(0);
+    int low = sched_add(&sched, task_c, 5);
+    int high = sched_add(&sched, task_a, 0);
+    int tie = sched_add(&sched, task_b, 5);
+    sched_in(&sched, low, clock_ms, 0);
+    sched_in(&sched, tie, clock_ms, 0);
+    sched_post(&sched, high);
+    run_until(0);
+    // Maior prioridade primeiro; empates na ordem de registro
+    CHECK_EQ(run_count, 3);
+    CHECK_EQ(runs[0].task, 0);
+    CHECK_EQ(runs[1].task, 2);
+    CHECK_EQ(runs[2].task, 1);
+
+    // Evento postado executa mesmo sem prazo; cancelar descarta o evento pendente
+    sched_post(&sched, high);
+    sched.ready |= sched_take_posted(&sched);
+    sched_cancel(&sched, high);
+    CHECK(!sched_run(&sched, 0, clock_ms));
+}
+
+static void test_periodic_without_drift(void) {
+    setup(1000);
+    int id = sched_add(&sched, task_a, 0);
+    sched_every(&sched, id, clock_ms, 10);
+    // O laço só acorda em múltiplos de 3 ms (ex.: outra tarefa segurando o core)
+    for (uint32_t t = 1000; t <= 1102; t += 3) {
+        clock_ms = t;
+        while (sched_run(&sched, 0, clock_ms)) {}
+    }
+    // Uma execução por período, cada uma no primeiro acordar depois do prazo
+    CHECK_EQ(run_count, 10);
+    for (int i = 0; i < run_count && i < MAX_RUNS; i++) {
+        uint32_t due = 1010 + 10 * i;
+        CHECK(runs[i].at >= due);
+        CHECK(runs[i].at < due + 3);
+    }
+    CHECK_EQ(sched.tasks[id].due_ms, 1110);
+}
+
+static void test_missed_periods_skipped(void) {
+    setup(0);
+    int id = sched_add(&sched, task_a, 0);
+    sched_every(&sched, id, clock_ms, 10);
+    run_until(20);
+    CHECK_EQ(run_count, 2);
+    // 35 ms sem executar: uma única execução, e o prazo volta à grade de 10 ms
+    clock_ms = 55;
+    while (sched_run(&sched, 0, clock_ms)) {}
+    CHECK_EQ(run_count, 3);
+    CHECK_EQ(sched.tasks[id].due_ms, 60);
+}
+
+static void test_one_shot(void) {
+    setup(0);
+    int id = sched_add(&sched, task_b, 0);
+    sched_in(&sched, id, clock_ms, 50);
+    sched_in(&sched, id, clock_ms, 80);  // Prazo já armado mais cedo é mantido
+    sched_in(&sched, id, 10, 20);        // Mais cedo: substitui
+    uint32_t due;
+    CHECK(sched_next_due(&sched, &due));
+    CHECK_EQ(due, 30);
+    run_until(200);
+    CHECK_EQ(run_count, 1);
+    CHECK_EQ(runs[0].at, 30);
+    CHECK(!sched_next_due(&sched, &due));
+}
+
+static void test_clock_wraparound(void) {
+    setup(UINT32_MAX - 25);
+    int periodic = sched_add(&sched, task_a, 1);
+    int once = sched_add(&sched, task_b, 0);
+    sched_every(&sched, periodic, clock_ms, 20);
+    sched_in(&sched, once, clock_ms, 40);
+    uint32_t due;
+    CHECK(sched_next_due(&sched, &due));
+    CHECK_EQ(due, UINT32_MAX - 5);
+    run_until(60);
+    // Periódico em -6, 14, 34 e 54 (módulo 2^32); o único também em 14, antes pela prioridade
+    CHECK_EQ(run_count, 5);
+    CHECK_EQ(runs[0].at, UINT32_MAX - 5);
+    CHECK_EQ(runs[1].task, 1);
+    CHECK_EQ(runs[1].at, 14);
+    CHECK_EQ(runs[2].at, 14);
+    CHECK_EQ(runs[4].at, 54);
+}
+
+// Tarefa de alerta como a do firmware: reagenda a si mesma a cada 10 ms
+// (ALERT_TICK_MS) enquanto houver alerta
+static alert_t alert;
+static int task_alert;
+static uint32_t shown_at, restored_at;
+
+static void alert_task(uint32_t now) {
+    uint8_t events = alert_tick(&alert, now);
+    if (events & ALERT_EVT_SHOW) shown_at = now;
+    if (events & ALERT_EVT_RESTORE) restored_at = now;
+    if (alert_busy(&alert)) sched_in(&sched, task_alert, now, 10);
+}
+
+static void test_alert_task(void) {
+    setup(500);
+    alert_init(&alert);
+    task_alert = sched_add(&sched, alert_task, 1);
+    const alert_pattern_t pattern = {.duration_ms = 95, .buzzer_on_ms = 20, .buzzer_off_ms = 20};
+    alert_schedule(&alert, &pattern);
+    alert_schedule(&alert, &pattern);
+    sched_in(&sched, task_alert, clock_ms, 0);
+    run_until(2000);
+    // Dois padrões de 95 ms com passo de 10 ms: cada um acaba no primeiro tick depois do fim
+    CHECK_EQ(shown_at, 600);
+    CHECK_EQ(restored_at, 700);
+    CHECK(!alert_busy(&alert));
+    uint32_t due;
+    CHECK(!sched_next_due(&sched, &due));  // Sem alerta a tarefa não fica acordando
+}
+
+int main(void) {
+    test_priority();
+    test_periodic_without_drift();
+    test_missed_periods_skipped();
+    test_one_shot();
+    test_clock_wraparound();
+    test_alert_task();
+    return TEST_RESULT();
+}
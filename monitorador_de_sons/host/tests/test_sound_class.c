@@ -0,0 +1,448 @@
+// Classificador de eventos (inc/sound_class.h) com trechos rotulados
+// sintetizados: silêncio, ruídos contínuos (ventilação, zumbido, apito e bipes
+// ligando e desligando), fala com vogais, consoantes e pausas, e batidas de
+// porta com e sem saturar o ADC. Os blocos passam pelo mesmo caminho do
+// process_block do firmware, com dois microfones, medidor e block_stats por
+// microfone, e o classificador vendo só o de maior LAF no bloco; nas conversas
+// entre dois microfones e na batida perto do outro microfone esse microfone
+// troca no meio do som. Cada trecho rotulado tem de ter a maior parte dos
+// blocos na classe certa, e as batidas contadas uma a uma.
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "sound_class.h"
+#include "sound_class_config.h"
+
+// Mesmos parâmetros de captura do firmware (monitorador_de_sons.c), com o decimador
+#define RATE_HZ 16000
+#define BLOCK 79
+#define SHIFT 4
+#define CAL_DB_X10 200
+#define AMPL_LEVEL_5 750
+#define MICS 2
+#define MAX_SEGMENTS 16
+
+static const char *const class_names[SOUND_CLASS_COUNT] = { "silêncio", "contínuo", "fala", "impulso" };
+static const uint16_t mic_bias[MICS] = { 2048, 1990 };  // Polarização de cada microfone (LSB)
+
+typedef struct {
+    float start_s, end_s;
+    sound_class_label_t label;
+    uint8_t min_percent;  // Blocos do trecho que têm de sair com o rótulo
+} segment_t;
+
+typedef struct {
+    const char *name;
+    float *mic[MICS];     // Pressão em LSB do ADC em torno da polarização
+    uint32_t len;
+    segment_t segments[MAX_SEGMENTS];
+    uint8_t segment_count;
+    uint32_t impulses;    // Batidas no trecho todo
+} clip_t;
+
+// ---- Síntese (valores em LSB do ADC; dB SPL = 20 log10(RMS) + CAL_DB_X10 / 10) ----
+
+static uint32_t rng = 12345;
+
+static float uniform(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static float uniform_in(float a, float b) {
+    return a + (b - a) * uniform();
+}
+
+static float gauss(void) {
+    float u = uniform() + 1e-7f, v = uniform();
+    return sqrtf(-2.0f * logf(u)) * cosf(2.0f * (float)M_PI * v);
+}
+
+static float db_rms(float db) {
+    return powf(10.0f, (db - CAL_DB_X10 / 10.0f) / 20.0f);
+}
+
+static uint32_t at(float seconds) {
+    return (uint32_t)(seconds * RATE_HZ);
+}
+
+static float rms(const float *x, uint32_t n) {
+    double sum = 0;
+    for (uint32_t i = 0; i < n; i++) sum += (double)x[i] * x[i];
+    return n ? (float)sqrt(sum / n) : 0.0f;
+}
+
+// Ajusta para o RMS das amostras não nulas (as pausas não contam)
+static void scale_to(float *x, uint32_t n, float target) {
+    double sum = 0;
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (x[i] != 0.0f) {
+            sum += (double)x[i] * x[i];
+            used++;
+        }
+    }
+    float gain = used ? target / (float)sqrt(sum / used) : 0.0f;
+    for (uint32_t i = 0; i < n; i++) x[i] *= gain;
+}
+
+static void add_scaled(float *dst, const float *src, uint32_t n, float gain) {
+    for (uint32_t i = 0; i < n; i++) dst[i] += gain * src[i];
+}
+
+static void pink(float *x, uint32_t n, float db) {
+    float b0 = 0, b1 = 0, b2 = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        float w = gauss();
+        b0 = 0.99765f * b0 + w * 0.0990460f;
+        b1 = 0.96300f * b1 + w * 0.2965164f;
+        b2 = 0.57000f * b2 + w * 1.0526913f;
+        x[i] = b0 + b1 + b2 + w * 0.1848f;
+    }
+    scale_to(x, n, db_rms(db));
+}
+
+static void lowpass_noise(float *x, uint32_t n, float db) {
+    float lp = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        lp += 0.15f * (gauss() - lp);
+        x[i] = lp;
+    }
+    scale_to(x, n, db_rms(db));
+}
+
+// Tom contínuo ou bipes de `on_s` ligados e `on_s` desligados
+static void tone(float *x, uint32_t n, float hz, float db, float on_s) {
+    float amp = db_rms(db) * sqrtf(2.0f);
+    for (uint32_t i = 0; i < n; i++) {
+        bool on = on_s == 0.0f || fmodf((float)i / RATE_HZ, 2.0f * on_s) < on_s;
+        x[i] = on ? amp * sinf(2.0f * (float)M_PI * hz * i / RATE_HZ) : 0.0f;
+    }
+}
+
+typedef struct {
+    float a1, a2, g, y1, y2;
+} resonator_t;
+
+static void resonator_init(resonator_t *r, float hz, float bandwidth_hz) {
+    float radius = expf(-(float)M_PI * bandwidth_hz / RATE_HZ);
+    r->a1 = 2.0f * radius * cosf(2.0f * (float)M_PI * hz / RATE_HZ);
+    r->a2 = -radius * radius;
+    r->g = 1.0f - radius;
+    r->y1 = r->y2 = 0;
+}
+
+static float resonate(resonator_t *r, float x) {
+    float y = r->g * x + r->a1 * r->y1 + r->a2 * r->y2;
+    r->y2 = r->y1;
+    r->y1 = y;
+    return y;
+}
+
+// Vogal: trem de pulsos glotais com entonação caindo, três formantes e rampas
+static uint32_t vowel(float *x, float seconds, float f0) {
+    static const float formants[5][3] = {
+        { 730, 1090, 2440 }, { 530, 1840, 2480 }, { 270, 2290, 3010 }, { 570, 840, 2410 }, { 300, 870, 2240 }
+    };
+    const float *f = formants[rng % 5];
+    resonator_t r[3];
+    resonator_init(&r[0], f[0], 80);
+    resonator_init(&r[1], f[1], 100);
+    resonator_init(&r[2], f[2], 140);
+    uint32_t n = at(seconds);
+    float phase = 0, lp = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        float pitch = f0 * (1.0f + 0.08f * sinf(2.0f * (float)M_PI * 3.0f * i / RATE_HZ) - 0.15f * i / n);
+        phase += pitch / RATE_HZ;
+        float pulse = 0;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+            pulse = 1.0f;
+        }
+        lp = 0.9f * lp + 0.1f * pulse;
+        float y = resonate(&r[0], lp) + 0.5f * resonate(&r[1], lp) + 0.25f * resonate(&r[2], lp);
+        float env = fminf(1.0f, fminf(i / (0.015f * RATE_HZ), (n - i) / (0.03f * RATE_HZ)));
+        x[i] = y * env;
+    }
+    return n;
+}
+
+// Consoante fricativa: ruído branco derivado (agudo), no nível `level` RMS
+static uint32_t fricative(float *x, float seconds, float level) {
+    uint32_t n = at(seconds);
+    float previous = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        float w = gauss();
+        x[i] = (w - previous) * fminf(1.0f, fminf(i / 80.0f, (n - i) / 80.0f));
+        previous = w;
+    }
+    scale_to(x, n, level);
+    return n;
+}
+
+// Uma frase de 4 a 8 palavras seguida de pausa, a partir de x[0]; retorna o
+// número de amostras escritas (no máximo `room`)
+static uint32_t sentence(float *x, uint32_t room, float f0) {
+    static float syllable[RATE_HZ];
+    uint32_t n = 0;
+    uint32_t words = 4 + rng % 5;
+    for (uint32_t w = 0; w < words; w++) {
+        uint32_t syllables = 1 + rng % 3;
+        for (uint32_t s = 0; s < syllables; s++) {
+            float choice = uniform();
+            uint32_t v = vowel(syllable, uniform_in(0.09f, 0.24f), f0 * uniform_in(0.85f, 1.2f));
+            float level = rms(syllable, v);
+            if (n + at(0.12f) + v > room) return room;  // A fala para entre sílabas, não no meio
+            if (choice < 0.3f) {
+                n += fricative(x + n, uniform_in(0.06f, 0.12f), 0.5f * level);
+            } else if (choice < 0.55f) {
+                n += at(0.03f);  // Oclusiva: silêncio e estouro
+                for (uint32_t i = 0; i < at(0.01f); i++) x[n++] = 1.5f * level * gauss();
+            }
+            memcpy(x + n, syllable, v * sizeof *x);
+            n += v;
+        }
+        n += at(uniform_in(0.03f, 0.15f));
+    }
+    n += at(uniform_in(0.3f, 0.9f));
+    return n < room ? n : room;
+}
+
+// Fala contínua de um falante no nível `db` (RMS sem as pausas)
+static void speech(float *x, uint32_t n, float db, float f0) {
+    memset(x, 0, n * sizeof *x);
+    for (uint32_t pos = 0; pos < n;) pos += sentence(x + pos, n - pos, f0);
+    scale_to(x, n, db_rms(db));
+}
+
+// Batida: ruído grave com ataque de 1 ms e decaimento exponencial (TR60 `rt60_s`);
+// `db` é o nível dos primeiros 10 ms
+static uint32_t slam(float *x, float db, float rt60_s) {
+    uint32_t n = at(rt60_s * 1.2f);
+    float lp = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        lp += 0.2f * (gauss() - lp);
+        x[i] = lp * powf(10.0f, -3.0f * i / (rt60_s * RATE_HZ)) * fminf(1.0f, i / 16.0f);
+    }
+    float gain = db_rms(db) / rms(x, at(0.01f));
+    for (uint32_t i = 0; i < n; i++) x[i] *= gain;
+    return n;
+}
+
+// ---- Trechos ----
+
+static float scratch[80 * RATE_HZ];
+
+static void clip_init(clip_t *clip, const char *name, float seconds) {
+    memset(clip, 0, sizeof *clip);
+    clip->name = name;
+    clip->len = at(seconds);
+    for (uint8_t k = 0; k < MICS; k++) {
+        clip->mic[k] = calloc(clip->len, sizeof(float));
+        pink(scratch, clip->len, 35.0f);  // Fundo da sala, independente em cada microfone
+        add_scaled(clip->mic[k], scratch, clip->len, 1.0f);
+    }
+}
+
+static void clip_free(clip_t *clip) {
+    for (uint8_t k = 0; k < MICS; k++) free(clip->mic[k]);
+}
+
+// Fonte perto do microfone `near`: o outro a ouve `far_db` abaixo
+static void place(clip_t *clip, const float *src, uint32_t n, float start_s, uint8_t near, float far_db) {
+    uint32_t offset = at(start_s);
+    if (offset >= clip->len) return;
+    if (n > clip->len - offset) n = clip->len - offset;
+    for (uint8_t k = 0; k < MICS; k++) {
+        add_scaled(clip->mic[k] + offset, src, n, k == near ? 1.0f : powf(10.0f, -far_db / 20.0f));
+    }
+}
+
+static void label(clip_t *clip, float start_s, float end_s, sound_class_label_t l, uint8_t min_percent) {
+    clip->segments[clip->segment_count++] = (segment_t){ start_s, end_s, l, min_percent };
+}
+
+static void add_slam(clip_t *clip, float start_s, float db, float rt60_s, uint8_t near, float far_db) {
+    uint32_t n = slam(scratch, db, rt60_s);
+    place(clip, scratch, n, start_s, near, far_db);
+    label(clip, start_s, start_s + 0.1f, SOUND_CLASS_IMPULSE, 80);
+    clip->impulses++;
+}
+
+// ---- Execução como em process_block ----
+
+typedef struct {
+    uint32_t blocks[MAX_SEGMENTS][SOUND_CLASS_COUNT];
+    uint32_t switches;  // Trocas do microfone de maior LAF
+    uint32_t impulses;
+} run_t;
+
+static void to_samples(const float *x, uint16_t bias, uint16_t *out) {
+    for (uint32_t i = 0; i < BLOCK; i++) {
+        float v = bias + x[i];
+        if (v < 0.0f) v = 0.0f;
+        if (v > 4095.0f) v = 4095.0f;  // Saturação do ADC
+        out[i] = (uint16_t)lroundf(v * (1 << SHIFT));
+    }
+}
+
+static void run(const clip_t *clip, run_t *result) {
+    static meter_t meters[MICS];
+    static sound_class_t sc;
+    memset(result, 0, sizeof *result);
+    for (uint8_t k = 0; k < MICS; k++) {
+        metering_init(&meters[k], RATE_HZ, BLOCK, mic_bias[k] << SHIFT, SHIFT, CAL_DB_X10);
+    }
+    sound_class_init(&sc, &sound_class_config, RATE_HZ, BLOCK, SHIFT, CAL_DB_X10);
+
+    uint8_t loud_mic = 0, previous_mic = 0;
+    uint16_t samples[MICS][BLOCK];
+    for (uint32_t b = 0; (b + 1) * BLOCK <= clip->len; b++) {
+        block_stats_t stats[MICS];
+        for (uint8_t k = 0; k < MICS; k++) {
+            to_samples(clip->mic[k] + b * BLOCK, mic_bias[k], samples[k]);
+            block_stats_compute(samples[k], BLOCK, (uint16_t)(mic_bias[k] << SHIFT), SHIFT, AMPL_LEVEL_5, &stats[k]);
+            metering_process_block(&meters[k], samples[k], BLOCK);
+            if (k == 0 || meters[k].fast_ms > meters[loud_mic].fast_ms) loud_mic = k;
+        }
+        result->switches += loud_mic != previous_mic;
+        previous_mic = loud_mic;
+        sound_class_label_t l = sound_class_process_block(&sc, samples[loud_mic], BLOCK, &meters[loud_mic], &stats[loud_mic]);
+
+        float t = (float)(b * BLOCK) / RATE_HZ;
+        for (uint8_t s = 0; s < clip->segment_count; s++) {
+            if (t >= clip->segments[s].start_s && t < clip->segments[s].end_s) result->blocks[s][l]++;
+        }
+    }
+    result->impulses = sc.impulses;
+}
+
+static void check_clip(const clip_t *clip, uint32_t min_switches) {
+    run_t result;
+    run(clip, &result);
+    for (uint8_t s = 0; s < clip->segment_count; s++) {
+        const segment_t *seg = &clip->segments[s];
+        uint32_t total = 0;
+        for (uint8_t c = 0; c < SOUND_CLASS_COUNT; c++) total += result.blocks[s][c];
+        uint32_t percent = total ? 100 * result.blocks[s][seg->label] / total : 0;
+        // As confusões que a regra de conversa e a de picos não toleram: fala ou
+        // ruído contínuo como impulso, e ruído ou silêncio como fala (até 2%: um
+        // ataque descartado fica como impulso enquanto é candidato)
+        bool confused = (seg->label != SOUND_CLASS_IMPULSE && result.blocks[s][SOUND_CLASS_IMPULSE] * 50 > total)
+                        || (seg->label != SOUND_CLASS_SPEECH && result.blocks[s][SOUND_CLASS_SPEECH] * 50 > total);
+        CHECK(percent >= seg->min_percent);
+        CHECK(!confused);
+        if (percent < seg->min_percent || confused) {
+            fprintf(stderr, "%s, %.2f-%.2f s (%s): %u%% certos, mínimo %u%% (", clip->name, seg->start_s, seg->end_s,
+                    class_names[seg->label], percent, seg->min_percent);
+            for (uint8_t c = 0; c < SOUND_CLASS_COUNT; c++) {
+                fprintf(stderr, "%s%s %u", c ? ", " : "", class_names[c], result.blocks[s][c]);
+            }
+            fprintf(stderr, ")\n");
+        }
+    }
+    CHECK_EQ(result.impulses, clip->impulses);
+    CHECK(result.switches >= min_switches);
+    if (result.impulses != clip->impulses || result.switches < min_switches) {
+        fprintf(stderr, "%s: %u impulsos (esperados %u), %u trocas de microfone\n", clip->name, result.impulses,
+                clip->impulses, result.switches);
+    }
+}
+
+// Só o fundo da sala
+static void test_quiet(void) {
+    clip_t clip;
+    clip_init(&clip, "silêncio", 10.0f);
+    label(&clip, 0.0f, 10.0f, SOUND_CLASS_QUIET, 99);
+    check_clip(&clip, 0);
+    clip_free(&clip);
+}
+
+// Sons sem modulação silábica; os bipes sobem e descem como sílabas, mas os
+// cruzamentos por zero não variam entre quadros, o que os separa da fala
+static void test_steady(void) {
+    clip_t clip;
+    clip_init(&clip, "contínuos", 40.0f);
+    lowpass_noise(scratch, at(10.0f), 72.0f);
+    place(&clip, scratch, at(10.0f), 0.0f, 0, 6.0f);
+    tone(scratch, at(10.0f), 100.0f, 75.0f, 0.0f);
+    place(&clip, scratch, at(10.0f), 10.0f, 1, 6.0f);
+    tone(scratch, at(10.0f), 2000.0f, 70.0f, 0.0f);
+    place(&clip, scratch, at(10.0f), 20.0f, 0, 6.0f);
+    tone(scratch, at(10.0f), 1000.0f, 72.0f, 0.25f);
+    place(&clip, scratch, at(10.0f), 30.0f, 1, 6.0f);
+    label(&clip, 1.0f, 10.0f, SOUND_CLASS_STEADY, 95);
+    label(&clip, 11.0f, 20.0f, SOUND_CLASS_STEADY, 95);
+    label(&clip, 21.0f, 30.0f, SOUND_CLASS_STEADY, 95);
+    label(&clip, 31.0f, 40.0f, SOUND_CLASS_STEADY, 45);  // Nos intervalos dos bipes sai silêncio
+    check_clip(&clip, 1);
+    clip_free(&clip);
+}
+
+// Voz grave e voz aguda mais baixa, com pausas entre frases
+static void test_speech(void) {
+    clip_t clip;
+    clip_init(&clip, "fala", 50.0f);
+    speech(scratch, at(29.0f), 68.0f, 130.0f);
+    place(&clip, scratch, at(29.0f), 1.0f, 0, 6.0f);
+    speech(scratch, at(20.0f), 63.0f, 210.0f);
+    place(&clip, scratch, at(20.0f), 30.0f, 0, 6.0f);
+    label(&clip, 2.0f, 30.0f, SOUND_CLASS_SPEECH, 80);
+    label(&clip, 31.0f, 50.0f, SOUND_CLASS_SPEECH, 80);
+    check_clip(&clip, 0);
+    clip_free(&clip);
+}
+
+// Batidas num ambiente silencioso (algumas saturam o ADC) e com ventilação
+static void test_slams(void) {
+    static const struct {
+        float db, rt60_s;
+    } quiet_room[] = { { 86, 0.4f }, { 82, 0.25f }, { 88, 0.6f }, { 78, 0.3f }, { 85, 0.15f }, { 84, 0.5f } },
+      ventilated[] = { { 72, 0.4f }, { 76, 0.25f }, { 70, 0.6f }, { 78, 0.3f }, { 74, 0.15f }, { 75, 0.5f } };
+    clip_t clip;
+    clip_init(&clip, "batidas", 76.0f);
+    for (uint8_t i = 0; i < 6; i++) add_slam(&clip, 3.0f + 6.0f * i, quiet_room[i].db, quiet_room[i].rt60_s, i % 2, 4.0f);
+    lowpass_noise(scratch, at(38.0f), 50.0f);
+    place(&clip, scratch, at(38.0f), 38.0f, 0, 3.0f);
+    for (uint8_t i = 0; i < 6; i++) add_slam(&clip, 41.0f + 6.0f * i, ventilated[i].db, ventilated[i].rt60_s, i % 2, 4.0f);
+    check_clip(&clip, 6);
+    clip_free(&clip);
+}
+
+// Conversa entre duas pessoas, cada uma perto de um microfone: o classificador
+// acompanha quem fala mais alto, trocando de microfone a cada frase, e ainda vê
+// fala. No meio, uma porta bate perto do microfone de quem está calado.
+static void test_conversation(void) {
+    static float turn[RATE_HZ * 8];
+    clip_t clip;
+    clip_init(&clip, "conversa", 46.0f);
+    uint8_t talker = 0;
+    for (uint32_t pos = at(1.0f); pos < clip.len; talker ^= 1) {
+        uint32_t n = 0;
+        memset(turn, 0, sizeof turn);
+        // Uma ou duas frases por vez
+        for (uint8_t s = 0, count = 1 + rng % 2; s < count; s++) {
+            n += sentence(turn + n, sizeof turn / sizeof turn[0] - n, talker ? 200.0f : 125.0f);
+        }
+        scale_to(turn, n, db_rms(talker ? 64.0f : 67.0f));
+        place(&clip, turn, n, (float)pos / RATE_HZ, talker, 8.0f);
+        pos += n;
+    }
+    add_slam(&clip, 23.0f, 84.0f, 0.35f, 1, 8.0f);
+    label(&clip, 2.0f, 22.9f, SOUND_CLASS_SPEECH, 75);
+    label(&clip, 24.5f, 46.0f, SOUND_CLASS_SPEECH, 75);
+    check_clip(&clip, 6);
+    clip_free(&clip);
+}
+
+int main(void) {
+    test_quiet();
+    test_steady();
+    test_speech();
+    test_slams();
+    test_conversation();
+    return TEST_RESULT();
+}
@@ -0,0 +1,112 @@
+// FFT Q15 e bandas do espectro (inc/spectrum.h) contra uma DFT em double.
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+#include "spectrum.h"
+#include "fft_tables.h"
+#include "metering.h"
+
+#define N FFT_TABLE_SIZE
+
+static void dft(const double *re, const double *im, double *out_re, double *out_im, uint32_t n) {
+    for (uint32_t k = 0; k < n; k++) {
+        double sr = 0, si = 0;
+        for (uint32_t t = 0; t < n; t++) {
+            double a = -2.0 * M_PI * k * t / n;
+            sr += re[t] * cos(a) - im[t] * sin(a);
+            si += re[t] * sin(a) + im[t] * cos(a);
+        }
+        out_re[k] = sr;
+        out_im[k] = si;
+    }
+}
+
+// FFT complexa de 128 pontos: saída escalada por 1/points, erro de poucos LSB
+static void test_complex_fft(void) {
+    const uint32_t points = N / 2;
+    int16_t data[2 * N / 2];
+    double re[N / 2], im[N / 2], ref_re[N / 2], ref_im[N / 2];
+    srand(1);
+    for (uint32_t i = 0; i < points; i++) {
+        re[i] = data[2 * i] = (int16_t)(rand() % 65536 - 32768);
+        im[i] = data[2 * i + 1] = (int16_t)(rand() % 65536 - 32768);
+    }
+    dft(re, im, ref_re, ref_im, points);
+    fft_q15_complex(data, points);
+    double max_error = 0;
+    for (uint32_t k = 0; k < points; k++) {
+        double er = fabs(data[2 * k] - ref_re[k] / points), ei = fabs(data[2 * k + 1] - ref_im[k] / points);
+        if (er > max_error) max_error = er;
+        if (ei > max_error) max_error = ei;
+    }
+    CHECK(max_error <= 4.0);
+
+    // Um só bin: impulso de amplitude máxima vira constante
+    for (uint32_t i = 0; i < 2 * points; i++) data[i] = 0;
+    data[0] = 32767;
+    fft_q15_complex(data, points);
+    for (uint32_t k = 0; k < points; k++) CHECK_NEAR(data[2 * k], 32767.0 / points, 1.0);
+}
+
+// Potência da FFT real de 256 pontos: (|X[k]| / N)^2, com X da DFT em double
+static void check_real_power(const int16_t *input, double tolerance_rel, double tolerance_abs) {
+    int16_t data[N];
+    uint32_t power[N / 2];
+    double re[N], im[N] = {0}, ref_re[N], ref_im[N];
+    for (uint32_t i = 0; i < N; i++) re[i] = data[i] = input[i];
+    dft(re, im, ref_re, ref_im, N);
+    fft_q15_real_power(data, power);
+    for (uint32_t k = 0; k < N / 2; k++) {
+        double expected = (ref_re[k] * ref_re[k] + ref_im[k] * ref_im[k]) / ((double)N * N);
+        CHECK_NEAR(power[k], expected, tolerance_abs + tolerance_rel * expected);
+    }
+}
+
+static void test_real_power(void) {
+    int16_t input[N];
+    srand(2);
+    for (uint32_t i = 0; i < N; i++) input[i] = (int16_t)(rand() % 65536 - 32768);
+    check_real_power(input, 0.01, 2000.0);
+
+    // Tom de amplitude máxima no bin 20: o pico fica no bin certo
+    for (uint32_t i = 0; i < N; i++) input[i] = (int16_t)lround(32767 * cos(2 * M_PI * 20 * i / N));
+    check_real_power(input, 0.01, 2000.0);
+
+    // Constante no fundo de escala: |X[0]| chega a ~65535 antes da metade; a soma
+    // dos quadrados estourava 32 bits
+    for (uint32_t i = 0; i < N; i++) input[i] = 32767;
+    check_real_power(input, 0.001, 16.0);
+    for (uint32_t i = 0; i < N; i++) input[i] = -32768;
+    check_real_power(input, 0.001, 16.0);
+}
+
+// Tom de 1,5 kHz (bin 24, no meio da banda de 1-2 kHz) pelo caminho do firmware:
+// janela, FFT e bandas. A banda mede o nível RMS do tom na escala calibrada do
+// medidor e as outras ficam bem abaixo (vazamento da janela de Hann)
+static void test_bands(void) {
+    const double amplitude = 500.0;
+    spectrum_t spectrum;
+    spectrum_init(&spectrum, 2048, 0);
+    uint16_t block[79];
+    double phase = 0;
+    for (uint32_t b = 0; b < 40; b++) {
+        for (uint32_t i = 0; i < 79; i++) {
+            block[i] = (uint16_t)lround(2048 + amplitude * sin(phase));
+            phase += 2 * M_PI * 1500.0 / 16000.0;
+        }
+        spectrum_feed(&spectrum, block, 79);
+    }
+    CHECK(spectrum.frames > 0);
+    int32_t expected = (int32_t)lround(200.0 * log10(amplitude / sqrt(2.0))) + 200;
+    CHECK_NEAR(spectrum_band_db_x10(&spectrum, 3, 200), expected, 5);
+    for (uint8_t band = 0; band < SPECTRUM_BANDS; band++) {
+        if (band != 3) CHECK(spectrum_band_db_x10(&spectrum, band, 200) < expected - 200);
+    }
+}
+
+int main(void) {
+    test_complex_fft();
+    test_real_power();
+    test_bands();
+    return TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+// Bytes de I2C de cada estratégia de envio do ssd1306 (janelas por página, janelas
+// por coluna e quadro inteiro) contra um painel simulado (mock_i2c.c): o custo
+// estimado em last_flush_bytes tem de ser o tráfego real, e a RAM do painel tem
+// de terminar igual a ram_buffer.
+#include <string.h>
+#include "test.h"
+#include "mock_i2c.h"
+#include "ssd1306.h"
+
+#define FULL_FRAME (SSD1306_WINDOW_OVERHEAD + WIDTH * HEIGHT / 8)
+
+static ssd1306_t ssd;
+
+// Envia as alterações pendentes e devolve os bytes que passaram no barramento
+static size_t flush(void) {
+    size_t before = mock_panel.wire_bytes;
+    CHECK(ssd1306_send_data_async(&ssd));
+    size_t bytes = mock_panel.wire_bytes - before;
+    CHECK_EQ(bytes, ssd.last_flush_bytes);
+    CHECK(memcmp(mock_panel.ram, ssd.ram_buffer, ssd.bufsize) == 0);
+    return bytes;
+}
+
+static void setup(void) {
+    mock_i2c_reset();
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_config(&ssd);
+    ssd1306_fill(&ssd, false);
+    ssd1306_send_data(&ssd);
+    CHECK_EQ(ssd.last_flush_bytes, FULL_FRAME);  // A RAM do painel começa com lixo
+}
+
+static void teardown(void) {
+    free(ssd.ram_buffer);
+    free(ssd.dirty);
+    free(ssd.sent_buffer);
+    free(ssd.stream);
+}
+
+static void test_no_change(void) {
+    setup();
+    CHECK_EQ(flush(), 0);
+    // Alteração desfeita antes do envio não gera tráfego
+    ssd1306_pixel(&ssd, 10, 10, true);
+    ssd1306_pixel(&ssd, 10, 10, false);
+    CHECK_EQ(flush(), 0);
+    teardown();
+}
+
+static void test_page_windows(void) {
+    setup();
+    // Um byte alterado: uma janela de uma coluna em uma página
+    ssd1306_pixel(&ssd, 3, 20, true);
+    CHECK_EQ(flush(), SSD1306_WINDOW_OVERHEAD + 1);
+
+    // Lacuna de até SSD1306_WINDOW_OVERHEAD colunas é reenviada junto...
+    ssd1306_pixel(&ssd, 0, 0, true);
+    ssd1306_pixel(&ssd, 1 + SSD1306_WINDOW_OVERHEAD, 0, true);
+    CHECK_EQ(flush(), SSD1306_WINDOW_OVERHEAD + SSD1306_WINDOW_OVERHEAD + 2);
+    // ...e uma maior abre outra janela
+    ssd1306_pixel(&ssd, 0, 1, true);
+    ssd1306_pixel(&ssd, 2 + SSD1306_WINDOW_OVERHEAD, 1, true);
+    CHECK_EQ(flush(), 2 * (SSD1306_WINDOW_OVERHEAD + 1));
+
+    // Uma linha horizontal: uma janela na sua página
+    ssd1306_hline(&ssd, 20, 99, 42, true);
+    CHECK_EQ(flush(), SSD1306_WINDOW_OVERHEAD + 80);
+    teardown();
+}
+
+static void test_column_windows(void) {
+    setup();
+    // Coluna inteira: por página seriam 8 janelas; por coluna é uma só
+    ssd1306_vline(&ssd, 50, 0, HEIGHT - 1, true);
+    CHECK_EQ(flush(), SSD1306_WINDOW_OVERHEAD + 8);
+
+    // Duas colunas vizinhas de um gráfico, em páginas diferentes
+    ssd1306_vline(&ssd, 60, 10, 30, true);
+    ssd1306_vline(&ssd, 61, 16, 40, true);
+    CHECK_EQ(flush(), SSD1306_WINDOW_OVERHEAD + 2 * 5);  // Páginas 1 a 5
+    teardown();
+}
+
+static void test_full_frame(void) {
+    setup();
+    // Quadro todo alterado: as janelas custariam mais que o quadro inteiro
+    ssd1306_fill(&ssd, true);
+    CHECK_EQ(flush(), FULL_FRAME);
+
+    // Texto em várias linhas ainda sai mais barato por janelas
+    ssd1306_fill(&ssd, false);
+    flush();
+    ssd1306_draw_string(&ssd, "MONITOR", 8, 0);
+    ssd1306_draw_string(&ssd, "60 dB", 8, 20);
+    size_t text = flush();
+    CHECK(text > 0);
+    CHECK(text < FULL_FRAME / 4);
+    teardown();
+}
+
+static void test_abort_forces_full_frame(void) {
+    setup();
+    ssd1306_pixel(&ssd, 5, 5, true);
+    // NACK na transferência: o painel pode ter ficado com qualquer parte do quadro
+    mock_i2c_set_abort();
+    CHECK(!ssd1306_busy(&ssd));
+    CHECK_EQ(ssd.tx_aborts, 1);
+    CHECK_EQ(flush(), FULL_FRAME);
+    CHECK_EQ(flush(), 0);
+    teardown();
+}
+
+// Um painel de 32 linhas pediria 4 páginas por coluna, mas o ram_buffer tem
+// sempre 8: a altura fica em 64 e desenhar na parte de baixo não sai do buffer
+static void test_height_fixed(void) {
+    mock_i2c_reset();
+    ssd1306_init(&ssd, WIDTH, 32, false, 0x3C, i2c0);
+    CHECK_EQ(ssd.height, HEIGHT);
+    CHECK_EQ(ssd.pages, 8);
+    CHECK_EQ(ssd.bufsize, WIDTH * 8);
+    ssd1306_fill(&ssd, true);
+    ssd1306_vline(&ssd, WIDTH - 1, 0, HEIGHT - 1, false);
+    CHECK_EQ(ssd.ram_buffer[ssd.bufsize - 1], 0);
+    ssd1306_send_data(&ssd);
+    CHECK(memcmp(mock_panel.ram, ssd.ram_buffer, ssd.bufsize) == 0);
+    teardown();
+}
+
+int main(void) {
+    test_no_change();
+    test_page_windows();
+    test_column_windows();
+    test_full_frame();
+    test_abort_forces_full_frame();
+    test_height_fixed();
+    return TEST_RESULT();
+}
@@ -0,0 +1,106 @@
+// Caminhos por palavra do ssd1306 (fill, rect, hline, vline e draw_char) contra
+// a versão original pixel a pixel (ssd1306_reference.c): a mesma sequência de
+// chamadas, com y fora do alinhamento de página, spans que cruzam as palavras de
+// 32 linhas e coordenadas além do display, tem de deixar os dois ram_buffer
+// iguais byte a byte depois de cada chamada.
+#include <string.h>
+#include "test.h"
+#include "mock_i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_reference.h"
+
+#define RANDOM_CALLS 200000
+#define MAX_COORD 200  // Além do display, mas longe dos laços de 8 bits que não terminam
+
+static ssd1306_t fast, reference;
+static uint32_t rng = 2024;
+
+static uint32_t next(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint8_t coord(void) {
+    return (uint8_t)(next() % (MAX_COORD + 1));
+}
+
+static bool same(void) {
+    return memcmp(fast.ram_buffer, reference.ram_buffer, fast.bufsize) == 0;
+}
+
+// Ruído nos dois buffers, para que apagar e acender partam de bits misturados
+static void scramble(void) {
+    for (size_t i = 0; i < fast.bufsize; i++) fast.ram_buffer[i] = (uint8_t)next();
+    memcpy(reference.ram_buffer, fast.ram_buffer, fast.bufsize);
+}
+
+// Todas as faixas verticais [y0, y1] numa coluna e numa linha horizontal de
+// cada altura, incluindo as que passam da última linha
+static void test_all_spans(void) {
+    for (uint8_t y0 = 0; y0 < HEIGHT + 8; y0++) {
+        for (uint8_t y1 = y0; y1 < HEIGHT + 8; y1++) {
+            for (int value = 0; value < 2; value++) {
+                scramble();
+                ssd1306_vline(&fast, 37, y0, y1, value);
+                ssd1306_reference_vline(&reference, 37, y0, y1, value);
+                ssd1306_rect(&fast, y0, 90, 5, y1 - y0 + 1, value, true);
+                ssd1306_reference_rect(&reference, y0, 90, 5, y1 - y0 + 1, value, true);
+                if (!same()) {
+                    CHECK(false);
+                    fprintf(stderr, "faixa %u-%u, valor %d: ram_buffer diferente\n", y0, y1, value);
+                    return;
+                }
+            }
+        }
+        ssd1306_hline(&fast, 0, WIDTH + 8, y0, y0 & 1);
+        ssd1306_reference_hline(&reference, 0, WIDTH + 8, y0, y0 & 1);
+        CHECK(same());
+    }
+}
+
+static void test_random_calls(void) {
+    scramble();
+    for (uint32_t call = 0; call < RANDOM_CALLS; call++) {
+        uint32_t kind = next() % 64;
+        bool value = next() & 1;
+        uint8_t a = coord(), b = coord(), c = coord(), d = coord();
+        if (kind == 0) {
+            ssd1306_fill(&fast, value);
+            ssd1306_reference_fill(&reference, value);
+        } else if (kind < 20) {
+            // Largura e altura zero incluídas; left + width e top + height cabem em 8 bits
+            uint8_t width = (uint8_t)(c % (256 - a)), height = (uint8_t)(d % (256 - b));
+            bool fill = next() & 1;
+            ssd1306_rect(&fast, b, a, width, height, value, fill);
+            ssd1306_reference_rect(&reference, b, a, width, height, value, fill);
+        } else if (kind < 32) {
+            ssd1306_hline(&fast, a, c, b, value);  // x0 > x1 não desenha nada
+            ssd1306_reference_hline(&reference, a, c, b, value);
+        } else if (kind < 44) {
+            ssd1306_vline(&fast, a, b, d, value);
+            ssd1306_reference_vline(&reference, a, b, d, value);
+        } else {
+            char ch = (char)next();
+            ssd1306_draw_char(&fast, ch, a, b);
+            ssd1306_reference_draw_char(&reference, ch, a, b);
+        }
+        if (!same()) {
+            CHECK(false);
+            fprintf(stderr, "chamada %u (tipo %u, %u %u %u %u, valor %d): ram_buffer diferente\n", call, kind, a, b, c,
+                    d, value);
+            return;
+        }
+    }
+    CHECK(same());
+}
+
+int main(void) {
+    mock_i2c_reset();
+    ssd1306_init(&fast, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_init(&reference, WIDTH, HEIGHT, false, 0x3C, i2c0);  // Só o framebuffer, nunca enviado
+    test_all_spans();
+    test_random_calls();
+    return TEST_RESULT();
+}
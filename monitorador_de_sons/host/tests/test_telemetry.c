@@ -0,0 +1,152 @@
+// Quadros da telemetria (inc/telemetry.h): ida e volta COBS + CRC com um
+// decodificador independente, no layout de 28 bytes `<BBIIHHHhhHHHH` de
+// tools/telemetry_csv.py. Com --capture grava no stdout uma captura com quadros
+// válidos e corrompidos, e com --expected os registros válidos em CSV, para o
+// teste de replay do decodificador em Python (test_telemetry_replay.py).
+#include <string.h>
+#include "test.h"
+#include "telemetry.h"
+
+#define RECORDS 300
+
+// Registros variados: zeros (o pior caso do COBS), bytes 0xFF, dB negativos e limites
+static telemetry_record_t make_record(uint32_t i) {
+    uint32_t h = i * 2654435761u;
+    telemetry_record_t r = {
+        .seq = i == 1 ? UINT32_MAX : i,
+        .timestamp_us = i % 3 == 0 ? 0 : h,
+        .peak = (uint16_t)(i % 4 == 0 ? 0 : h >> 16),
+        .mean = (uint16_t)(i % 5 == 0 ? 0xFFFF : h >> 8),
+        .peak_samples = (uint16_t)(i % 7),
+        .block_db_x10 = (int16_t)(i % 2 ? -(int32_t)(h % 900) : (int32_t)(h % 1200)),
+        .laf_db_x10 = (int16_t)(i == 2 ? INT16_MIN : i == 3 ? INT16_MAX : (int32_t)(h % 1300) - 100),
+        .alert_peaks = (uint16_t)(i / 10),
+        .overruns = (uint16_t)(i % 11 == 0 ? 0xFFFF : 0),
+        .dropped_blocks = (uint16_t)(i & 0xFF00),
+    };
+    if (i == 0) memset(&r, 0, sizeof r);
+    return r;
+}
+
+// Decodificação COBS de um quadro sem o 0x00 final; retorna o tamanho ou -1
+static int cobs_decode(const uint8_t *src, size_t len, uint8_t *dst) {
+    size_t in = 0, out = 0;
+    while (in < len) {
+        uint8_t code = src[in++];
+        if (code == 0 || in + code - 1 > len) return -1;
+        for (uint8_t k = 1; k < code; k++) dst[out++] = src[in++];
+        if (code < 0xFF && in < len) dst[out++] = 0;
+    }
+    return (int)out;
+}
+
+static uint32_t get_le(const uint8_t *p, uint8_t bytes) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < bytes; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static void test_round_trip(void) {
+    for (uint32_t i = 0; i < RECORDS; i++) {
+        telemetry_record_t r = make_record(i);
+        uint16_t dropped_records = (uint16_t)(i * 7);
+        uint8_t frame[TELEMETRY_FRAME_MAX], raw[TELEMETRY_FRAME_MAX];
+        size_t len = telemetry_encode_frame(&r, dropped_records, frame);
+
+        // Um único 0x00, o delimitador no fim
+        CHECK(len <= TELEMETRY_FRAME_MAX);
+        CHECK_EQ(frame[len - 1], 0);
+        CHECK(memchr(frame, 0, len - 1) == NULL);
+
+        CHECK_EQ(cobs_decode(frame, len - 1, raw), TELEMETRY_RECORD_LEN + 2);
+        CHECK_EQ(get_le(raw + TELEMETRY_RECORD_LEN, 2), telemetry_crc16(raw, TELEMETRY_RECORD_LEN));
+        CHECK_EQ(raw[0], TELEMETRY_VERSION);
+        CHECK_EQ(raw[1], TELEMETRY_TYPE_BLOCK);
+        CHECK_EQ(get_le(raw + 2, 4), r.seq);
+        CHECK_EQ(get_le(raw + 6, 4), r.timestamp_us);
+        CHECK_EQ(get_le(raw + 10, 2), r.peak);
+        CHECK_EQ(get_le(raw + 12, 2), r.mean);
+        CHECK_EQ(get_le(raw + 14, 2), r.peak_samples);
+        CHECK_EQ((int16_t)get_le(raw + 16, 2), r.block_db_x10);
+        CHECK_EQ((int16_t)get_le(raw + 18, 2), r.laf_db_x10);
+        CHECK_EQ(get_le(raw + 20, 2), r.alert_peaks);
+        CHECK_EQ(get_le(raw + 22, 2), r.overruns);
+        CHECK_EQ(get_le(raw + 24, 2), r.dropped_blocks);
+        CHECK_EQ(get_le(raw + 26, 2), dropped_records);
+    }
+}
+
+static void test_crc_and_cobs(void) {
+    // Valor de verificação do CRC-16/CCITT-FALSE
+    CHECK_EQ(telemetry_crc16((const uint8_t *)"123456789", 9), 0x29B1);
+
+    // Sequências longas sem zero: um byte de código a cada 254 bytes
+    uint8_t src[600], dst[610], back[610];
+    for (int i = 0; i < 600; i++) src[i] = (uint8_t)(i % 255 + 1);
+    size_t len = telemetry_cobs_encode(src, sizeof src, dst);
+    CHECK_EQ(len, 600 + 600 / 254 + 1);
+    CHECK(memchr(dst, 0, len) == NULL);
+    CHECK_EQ(cobs_decode(dst, len, back), 600);
+    CHECK(memcmp(src, back, 600) == 0);
+}
+
+static void test_queue_drops(void) {
+    static telemetry_queue_t queue;
+    telemetry_queue_init(&queue);
+    telemetry_record_t r;
+    for (uint32_t i = 0; i < TELEMETRY_QUEUE_SIZE + 5; i++) {
+        r = make_record(i);
+        CHECK_EQ(telemetry_queue_push(&queue, &r), i < TELEMETRY_QUEUE_SIZE);
+    }
+    CHECK_EQ(telemetry_queue_dropped(&queue), 5);
+    for (uint32_t i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+        CHECK(telemetry_queue_pop(&queue, &r));
+        CHECK_EQ(r.seq, make_record(i).seq);
+    }
+    CHECK(!telemetry_queue_pop(&queue, &r));
+}
+
+// Captura como a UART a entregaria: começa no meio de um quadro, tem quadros
+// vazios, um byte trocado e um quadro cortado; só os íntegros viram registros
+static void write_capture(void) {
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t len = telemetry_encode_frame(&(telemetry_record_t){.seq = 999}, 0, frame);
+    fwrite(frame + 10, 1, len - 10, stdout);
+    for (uint32_t i = 0; i < RECORDS; i++) {
+        telemetry_record_t r = make_record(i);
+        len = telemetry_encode_frame(&r, (uint16_t)(i * 7), frame);
+        if (i % 50 == 17) frame[len / 2] ^= 0x04;  // Inválido
+        if (i % 50 == 33) {
+            fwrite(frame, 1, len / 2, stdout);  // Cortado: funde com o próximo e os dois se perdem
+            continue;
+        }
+        if (i % 25 == 0) fputc(0, stdout);
+        fwrite(frame, 1, len, stdout);
+    }
+}
+
+static void write_expected(void) {
+    printf("seq,timestamp_us,peak,mean,peak_samples,block_db_x10,laf_db_x10,alert_peaks,overruns,"
+           "dropped_blocks,dropped_records\n");
+    for (uint32_t i = 0; i < RECORDS; i++) {
+        if (i % 50 == 17 || i % 50 == 33 || i % 50 == 34) continue;
+        telemetry_record_t r = make_record(i);
+        printf("%u,%u,%u,%u,%u,%d,%d,%u,%u,%u,%u\n", r.seq, r.timestamp_us, r.peak, r.mean, r.peak_samples,
+               r.block_db_x10, r.laf_db_x10, r.alert_peaks, r.overruns, r.dropped_blocks, (uint16_t)(i * 7));
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !strcmp(argv[1], "--capture")) {
+        write_capture();
+        return 0;
+    }
+    if (argc > 1 && !strcmp(argv[1], "--expected")) {
+        write_expected();
+        return 0;
+    }
+    test_round_trip();
+    test_crc_and_cobs();
+    test_queue_drops();
+    return TEST_RESULT();
+}
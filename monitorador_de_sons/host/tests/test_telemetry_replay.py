@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Replay da telemetria: a captura gerada por test_telemetry --capture passa por
+tools/telemetry_csv.py e o CSV tem de trazer exatamente os registros íntegros
+(test_telemetry --expected), com os quadros corrompidos contados como inválidos.
+
+Uso (pelo ctest): test_telemetry_replay.py caminho/test_telemetry tools/telemetry_csv.py
+"""
+
+import csv
+import io
+import subprocess
+import sys
+
+
+def main():
+    helper, decoder = sys.argv[1], sys.argv[2]
+    capture = subprocess.run([helper, "--capture"], check=True, capture_output=True).stdout
+    expected = list(csv.DictReader(io.StringIO(
+        subprocess.run([helper, "--expected"], check=True, capture_output=True, text=True).stdout)))
+
+    result = subprocess.run([sys.executable, decoder, "-", "-"], input=capture, capture_output=True, check=True)
+    decoded = list(csv.DictReader(io.StringIO(result.stdout.decode())))
+    summary = result.stderr.decode().strip()
+
+    failures = []
+    if len(decoded) != len(expected):
+        failures.append(f"{len(decoded)} registros decodificados, esperados {len(expected)}")
+    for want, got in zip(expected, decoded):
+        for field, value in want.items():
+            if field.endswith("_db_x10"):
+                # O CSV traz dB com uma casa decimal
+                ok = round(float(got[field[:-len("_x10")]]) * 10) == int(value)
+            else:
+                ok = int(got[field]) == int(value)
+            if not ok:
+                failures.append(f"seq {want['seq']}: {field} = {got.get(field, got.get(field[:-4]))}, esperado {value}")
+    good, bad = (int(word) for word in summary.split()[0:3:2])
+    if good != len(expected):
+        failures.append(f"resumo '{summary}' não bate com {len(expected)} registros")
+    if bad < 6:  # Início no meio de um quadro, um byte trocado e um quadro cortado a cada 50
+        failures.append(f"resumo '{summary}': quadros corrompidos não foram descartados")
+
+    for failure in failures[:20]:
+        print(failure, file=sys.stderr)
+    print(f"{len(expected)} registros conferidos, {len(failures)} falhas ({summary})")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,70 @@
+#include "alert.h"
+
+void alert_init(alert_t *alert) {
+    alert->queue_head = 0;
+    alert->queue_count = 0;
+    alert->active = false;
+    alert->buzzer_on = false;
+    alert->border_on = false;
+}
+
+// Coloca um padrão na fila. Retorna false se a fila estiver cheia.
+bool alert_schedule(alert_t *alert, const alert_pattern_t *pattern) {
+    if (alert->queue_count == ALERT_QUEUE_SIZE) return false;
+    uint8_t tail = (alert->queue_head + alert->queue_count) % ALERT_QUEUE_SIZE;
+    alert->queue[tail] = *pattern;
+    alert->queue_count++;
+    return true;
+}
+
+static void alert_start_next(alert_t *alert, uint32_t now_ms) {
+    alert->current = alert->queue[alert->queue_head];
+    alert->queue_head = (alert->queue_head + 1) % ALERT_QUEUE_SIZE;
+    alert->queue_count--;
+
+    alert->active = true;
+    alert->started_at = alert->buzzer_toggled_at = alert->border_toggled_at = now_ms;
+    alert->buzzer_on = alert->current.buzzer_on_ms > 0;
+    alert->border_on = true;
+}
+
+uint8_t alert_tick(alert_t *alert, uint32_t now_ms) {
+    uint8_t events = 0;
+    bool buzzer_before = alert->buzzer_on;
+
+    if (alert->active && now_ms - alert->started_at >= alert->current.duration_ms) {
+        alert->active = false;
+        alert->buzzer_on = false;
+        if (alert->queue_count == 0) {
+            alert->border_on = false;
+            events |= ALERT_EVT_RESTORE;
+        }
+    }
+
+    if (!alert->active && alert->queue_count > 0) {
+        alert_start_next(alert, now_ms);
+        events |= ALERT_EVT_SHOW | ALERT_EVT_BORDER;
+    } else if (alert->active) {
+        const alert_pattern_t *p = &alert->current;
+        if (p->buzzer_on_ms > 0 && p->buzzer_off_ms > 0) {
+            uint16_t phase = alert->buzzer_on ? p->buzzer_on_ms : p->buzzer_off_ms;
+            if (now_ms - alert->buzzer_toggled_at >= phase) {
+                alert->buzzer_on = !alert->buzzer_on;
+                alert->buzzer_toggled_at = now_ms;
+            }
+        }
+        if (p->blink_ms > 0 && now_ms - alert->border_toggled_at >= p->blink_ms) {
+            alert->border_on = !alert->border_on;
+            alert->border_toggled_at = now_ms;
+            events |= ALERT_EVT_BORDER;
+        }
+    }
+
+    // Só a transição final do tick é reportada (fim de um padrão + início do próximo se anulam)
+    if (alert->buzzer_on != buzzer_before) events |= alert->buzzer_on ? ALERT_EVT_BUZZER_ON : ALERT_EVT_BUZZER_OFF;
+    return events;
+}
+
+bool alert_busy(const alert_t *alert) {
+    return alert->active || alert->queue_count > 0;
+}
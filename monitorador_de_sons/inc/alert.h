@@ -0,0 +1,47 @@
+#ifndef ALERT_H
+#define ALERT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Máquina de estados dos alertas (buzzers + borda piscando no display).
+
+Não depende do hardware: `alert_tick` recebe o tempo atual e devolve eventos
+para quem o chama acionar os buzzers e redesenhar a tela. No firmware é chamada
+pela tarefa de alerta do escalonador (inc/scheduler.h), que se reagenda a cada
+ALERT_TICK_MS enquanto houver alerta; padrões agendados com o alerta em
+andamento entram em uma fila e são tocados em sequência.
+*/
+
+#define ALERT_QUEUE_SIZE 4
+
+// Eventos devolvidos por alert_tick
+#define ALERT_EVT_SHOW       0x01  // Começou um padrão: desenhar a tela de alerta
+#define ALERT_EVT_RESTORE    0x02  // Fila vazia: voltar à tela de monitoramento
+#define ALERT_EVT_BUZZER_ON  0x04
+#define ALERT_EVT_BUZZER_OFF 0x08
+#define ALERT_EVT_BORDER     0x10  // A borda mudou (ver border_on)
+
+typedef struct {
+    uint16_t duration_ms;
+    uint16_t buzzer_on_ms;   // 0: sem buzzer
+    uint16_t buzzer_off_ms;  // 0: buzzer contínuo durante todo o padrão
+    uint16_t blink_ms;       // Meio período da borda piscando (0: borda fixa)
+} alert_pattern_t;
+
+typedef struct {
+    alert_pattern_t queue[ALERT_QUEUE_SIZE];
+    uint8_t queue_head, queue_count;
+    alert_pattern_t current;
+    bool active;
+    bool buzzer_on, border_on;
+    uint32_t started_at, buzzer_toggled_at, border_toggled_at;
+} alert_t;
+
+void alert_init(alert_t *alert);
+bool alert_schedule(alert_t *alert, const alert_pattern_t *pattern);
+uint8_t alert_tick(alert_t *alert, uint32_t now_ms);
+bool alert_busy(const alert_t *alert);
+
+#endif
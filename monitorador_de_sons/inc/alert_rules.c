@@ -0,0 +1,93 @@
+#include "alert_rules.h"
+
+static void rule_clear(alert_rule_t *rule) {
+    for (uint8_t i = 0; i < ALERT_RULES_SLOTS; i++) {
+        rule->slots[i] = 0;
+        rule->slot_counts[i] = 0;
+    }
+    rule->total = 0;
+    rule->total_blocks = 0;
+    rule->slot_fill = 0;
+    rule->slot = 0;
+    rule->active = false;
+    rule->cooldown_left = 0;
+    rule->value = 0;
+}
+
+void alert_rules_init(alert_rules_t *rules, uint32_t sample_rate_hz, uint32_t block_len) {
+    rules->count = 0;
+    rules->block_us = (uint32_t)(((uint64_t)block_len * 1000000u) / sample_rate_hz);
+}
+
+// Adiciona uma regra; retorna seu índice (bit na máscara de disparos) ou -1 se não houver espaço
+int alert_rules_add(alert_rules_t *rules, const alert_rule_config_t *config) {
+    if (rules->count >= ALERT_RULES_MAX || rules->block_us == 0) return -1;
+
+    alert_rule_t *rule = &rules->rules[rules->count];
+    rule->config = *config;
+    uint64_t window_blocks = ((uint64_t)config->window_ms * 1000u + rules->block_us - 1) / rules->block_us;
+    uint64_t slot_len = (window_blocks + ALERT_RULES_SLOTS - 1) / ALERT_RULES_SLOTS;
+    rule->slot_len = slot_len == 0 ? 1 : (slot_len > UINT16_MAX ? UINT16_MAX : (uint16_t)slot_len);
+    rule->cooldown_blocks = (uint32_t)(((uint64_t)config->cooldown_ms * 1000u) / rules->block_us);
+    rule->fired = 0;
+    rule_clear(rule);
+    return rules->count++;
+}
+
+// Zera as janelas e estados (ex.: ao retomar a captura); mantém as contagens de disparos
+void alert_rules_reset(alert_rules_t *rules) {
+    for (uint8_t r = 0; r < rules->count; r++) rule_clear(&rules->rules[r]);
+}
+
+static int32_t rule_evaluate(const alert_rule_t *rule, const meter_t *meter) {
+    if (rule->config.kind == ALERT_RULE_EVENTS) return (int32_t)rule->total;
+    if (rule->total_blocks == 0) return metering_db_x10(meter, 0);
+    return metering_db_x10(meter, rule->total / rule->total_blocks);
+}
+
+// Acrescenta o último bloco do medidor, com o rótulo `block_class`, a todas as
+// regras. Retorna a máscara das regras que dispararam neste bloco.
+uint32_t alert_rules_update(alert_rules_t *rules, const meter_t *meter, uint8_t block_class) {
+    int32_t laf = metering_laf_db_x10(meter);
+    uint32_t fired = 0;
+
+    for (uint8_t r = 0; r < rules->count; r++) {
+        alert_rule_t *rule = &rules->rules[r];
+        bool counts = rule->config.class_mask == 0 || (rule->config.class_mask >> block_class & 1u);
+        uint64_t sample = 0;
+        if (counts) sample = rule->config.kind == ALERT_RULE_LEQ ? meter->block_ms : (laf >= rule->config.event_db_x10);
+
+        // Fatia cheia: avança e descarta a mais antiga da soma
+        if (rule->slot_fill == rule->slot_len) {
+            rule->slot = (uint8_t)((rule->slot + 1) % ALERT_RULES_SLOTS);
+            rule->total -= rule->slots[rule->slot];
+            rule->total_blocks -= rule->slot_counts[rule->slot];
+            rule->slots[rule->slot] = 0;
+            rule->slot_counts[rule->slot] = 0;
+            rule->slot_fill = 0;
+        }
+        rule->slots[rule->slot] += sample;
+        rule->slot_counts[rule->slot] += counts;
+        rule->slot_fill++;
+        rule->total += sample;
+        rule->total_blocks += counts;
+
+        int32_t value = rule_evaluate(rule, meter);
+        rule->value = value;
+        if (rule->cooldown_left > 0) rule->cooldown_left--;
+
+        if (!rule->active) {
+            if (value < rule->config.enter) continue;
+            rule->active = true;
+        } else if (value <= rule->config.exit) {
+            rule->active = false;
+            continue;
+        }
+        if (rule->cooldown_left == 0) {
+            fired |= 1u << r;
+            rule->fired++;
+            rule->cooldown_left = rule->cooldown_blocks;
+        }
+    }
+    return fired;
+}
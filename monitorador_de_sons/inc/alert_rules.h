@@ -0,0 +1,76 @@
+#ifndef ALERT_RULES_H
+#define ALERT_RULES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "metering.h"
+
+/*
+Regras de alerta avaliadas a cada bloco sobre janelas deslizantes.
+
+Cada regra mantém um anel de ALERT_RULES_SLOTS fatias da sua janela; a fatia
+atual acumula os blocos e, quando enche, a mais antiga sai da soma total. Assim
+a atualização por bloco é O(1) e a janela efetiva fica entre (SLOTS - 1) e
+SLOTS fatias. Tipos de regra:
+
+- ALERT_RULE_LEQ: nível equivalente (média de energia ponderada A) da janela,
+  comparado em décimos de dB. Ex.: "LAeq de 5 s acima de 70 dB".
+- ALERT_RULE_EVENTS: quantidade de blocos com LAF >= event_db_x10 na janela.
+  Ex.: "mais de 20 picos em 10 s".
+
+Com `class_mask` a regra só conta os blocos cujo rótulo (inc/sound_class.h)
+tem o bit ligado; os demais avançam a janela sem entrar na soma nem na média.
+Ex.: picos sem os impulsos isolados, ou "fala em metade dos blocos de 30 s".
+Máscara 0 conta todos os blocos.
+
+A regra entra em alerta quando o valor chega a `enter` e só sai quando cai a
+`exit` (histerese). O disparo ocorre ao entrar; enquanto continuar ativa, volta
+a disparar a cada `cooldown_ms`, que também é o intervalo mínimo entre disparos.
+*/
+
+#define ALERT_RULES_MAX 4
+#define ALERT_RULES_SLOTS 20
+
+typedef enum {
+    ALERT_RULE_LEQ,
+    ALERT_RULE_EVENTS
+} alert_rule_kind_t;
+
+typedef struct {
+    alert_rule_kind_t kind;
+    uint32_t window_ms;
+    int32_t event_db_x10;  // ALERT_RULE_EVENTS: LAF mínimo para o bloco contar
+    uint32_t class_mask;   // Bits (1 << rótulo) das classes que contam; 0: todas
+    int32_t enter;         // Décimos de dB (LEQ) ou número de blocos (EVENTS)
+    int32_t exit;
+    uint32_t cooldown_ms;
+} alert_rule_config_t;
+
+typedef struct {
+    alert_rule_config_t config;
+    uint64_t slots[ALERT_RULES_SLOTS];  // Soma de energia ou contagem de cada fatia
+    uint16_t slot_counts[ALERT_RULES_SLOTS];
+    uint64_t total;
+    uint32_t total_blocks;
+    uint16_t slot_len;        // Blocos por fatia
+    uint16_t slot_fill;
+    uint8_t slot;
+    bool active;
+    uint32_t cooldown_blocks;
+    uint32_t cooldown_left;
+    int32_t value;            // Último valor avaliado
+    uint32_t fired;           // Disparos desde a inicialização
+} alert_rule_t;
+
+typedef struct {
+    alert_rule_t rules[ALERT_RULES_MAX];
+    uint8_t count;
+    uint32_t block_us;        // Duração de um bloco
+} alert_rules_t;
+
+void alert_rules_init(alert_rules_t *rules, uint32_t sample_rate_hz, uint32_t block_len);
+int alert_rules_add(alert_rules_t *rules, const alert_rule_config_t *config);
+uint32_t alert_rules_update(alert_rules_t *rules, const meter_t *meter, uint8_t block_class);
+void alert_rules_reset(alert_rules_t *rules);
+
+#endif
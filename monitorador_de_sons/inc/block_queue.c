@@ -0,0 +1,39 @@
+#include "block_queue.h"
+
+void block_queue_init(block_queue_t *queue) {
+    atomic_store_explicit(&queue->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->dropped, 0, memory_order_relaxed);
+}
+
+// Lado do produtor (ISR). Nunca bloqueia: com a fila cheia o bloco é descartado.
+bool block_queue_push(block_queue_t *queue, const volatile uint16_t *samples, uint32_t seq) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head - tail >= BLOCK_QUEUE_SIZE) {
+        uint32_t dropped = atomic_load_explicit(&queue->dropped, memory_order_relaxed);
+        atomic_store_explicit(&queue->dropped, dropped + 1, memory_order_relaxed);
+        return false;
+    }
+
+    capture_block_t *item = &queue->items[head & (BLOCK_QUEUE_SIZE - 1)];
+    item->samples = samples;
+    item->seq = seq;
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+// Lado do consumidor (core 1).
+bool block_queue_pop(block_queue_t *queue, capture_block_t *block) {
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (head == tail) return false;
+
+    *block = queue->items[tail & (BLOCK_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t block_queue_dropped(const block_queue_t *queue) {
+    return atomic_load_explicit((_Atomic uint32_t *)&queue->dropped, memory_order_relaxed);
+}
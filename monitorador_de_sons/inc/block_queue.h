@@ -0,0 +1,36 @@
+#ifndef BLOCK_QUEUE_H
+#define BLOCK_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/*
+Fila sem travas de um produtor e um consumidor (SPSC) para entregar blocos de
+captura completos da ISR do DMA (core 0) para a análise (core 1).
+
+O produtor escreve apenas `head` e `dropped`; o consumidor escreve apenas
+`tail`. Só são usadas cargas/armazenamentos atômicos de 32 bits, que no
+Cortex-M0+ viram LDR/STR com DMB, sem depender de instruções exclusivas.
+*/
+
+#define BLOCK_QUEUE_SIZE 8  // Potência de 2
+
+typedef struct {
+    const volatile uint16_t *samples;
+    uint32_t seq;
+} capture_block_t;
+
+typedef struct {
+    capture_block_t items[BLOCK_QUEUE_SIZE];
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    _Atomic uint32_t dropped;  // Blocos descartados com a fila cheia
+} block_queue_t;
+
+void block_queue_init(block_queue_t *queue);
+bool block_queue_push(block_queue_t *queue, const volatile uint16_t *samples, uint32_t seq);
+bool block_queue_pop(block_queue_t *queue, capture_block_t *block);
+uint32_t block_queue_dropped(const block_queue_t *queue);
+
+#endif
@@ -0,0 +1,79 @@
+#include <stdint.h>
+#include "block_stats.h"
+
+#define HIGH_BITS 0x80008000u  // Bit de sinal de cada faixa de 16 bits
+#define LANE_LOW 0x00010001u   // Bit 0 de cada faixa
+#define LANE_12 0x0FFF0FFFu
+
+// Acumuladores de um trecho; as faixas são juntadas a cada BLOCK_STATS_CHUNK_WORDS palavras
+typedef struct {
+    uint32_t sum, loud, peak;
+    uint32_t squares;
+} lanes_t;
+
+static inline void add_sample(block_stats_t *stats, uint16_t x, uint16_t offset, uint8_t shift, uint16_t loud_level) {
+    uint32_t amplitude = (uint32_t)(x >= offset ? x - offset : offset - x) >> shift;
+    stats->sum += amplitude;
+    stats->square_sum += amplitude * amplitude;
+    if (amplitude > stats->peak) stats->peak = (uint16_t)amplitude;
+    if (amplitude >= loud_level) stats->loud++;
+}
+
+// Duas amostras por palavra. off2 e loud2 têm o valor repetido nas duas faixas.
+static inline void add_word(lanes_t *acc, uint32_t w, uint32_t off2, uint32_t not_off2, uint32_t loud2, uint8_t shift) {
+    // x - offset por faixa, módulo 2^16: o bit alto de cada faixa é separado para não propagar o empréstimo
+    uint32_t d = ((w | HIGH_BITS) - (off2 & ~HIGH_BITS)) ^ ((w ^ not_off2) & HIGH_BITS);
+    // x < offset (sem sinal) por faixa, no bit alto
+    uint32_t below = ((~w & off2) | ((~w | off2) & d)) & HIGH_BITS;
+    uint32_t neg = below >> 15;
+    uint32_t amplitude = (((d ^ (neg * 0xFFFFu)) + neg) >> shift) & LANE_12;
+
+    acc->sum += amplitude;
+    uint32_t lo = amplitude & 0xFFFFu, hi = amplitude >> 16;
+    acc->squares += lo * lo + hi * hi;
+
+    // Faixas de até 15 bits: o bit alto de (a | H) - b sobra quando a >= b
+    uint32_t ge = (((amplitude | HIGH_BITS) - acc->peak) & HIGH_BITS) >> 15;
+    uint32_t keep = ge * 0xFFFFu;
+    acc->peak = (amplitude & keep) | (acc->peak & ~keep);
+    acc->loud += (((amplitude | HIGH_BITS) - loud2) & HIGH_BITS) >> 15;
+}
+
+void block_stats_compute(const volatile uint16_t *samples, uint32_t len, uint16_t offset, uint8_t shift,
+                         uint16_t loud_level, block_stats_t *stats) {
+    *stats = (block_stats_t){0};
+    if (len == 0) return;
+    if ((uintptr_t)samples & 2u) {
+        add_sample(stats, samples[0], offset, shift, loud_level);
+        samples++;
+        len--;
+    }
+
+    const volatile uint32_t *words = (const volatile uint32_t *)samples;
+    uint32_t off2 = offset * LANE_LOW, loud2 = loud_level * LANE_LOW;
+    uint32_t n_words = len / 2, peak = 0;
+    lanes_t acc = {0};
+    for (uint32_t i = 0; i < n_words; ) {
+        uint32_t end = n_words - i > BLOCK_STATS_CHUNK_WORDS ? i + BLOCK_STATS_CHUNK_WORDS : n_words;
+        acc.sum = acc.loud = acc.squares = 0;
+        for (; i + 2 <= end; i += 2) {
+            uint32_t w0 = words[i], w1 = words[i + 1];
+            add_word(&acc, w0, off2, ~off2, loud2, shift);
+            add_word(&acc, w1, off2, ~off2, loud2, shift);
+        }
+        if (i < end) add_word(&acc, words[i++], off2, ~off2, loud2, shift);
+        stats->sum += (acc.sum & 0xFFFFu) + (acc.sum >> 16);
+        stats->loud += (uint16_t)((acc.loud & 0xFFFFu) + (acc.loud >> 16));
+        stats->square_sum += acc.squares;
+    }
+    peak = (acc.peak & 0xFFFFu) > (acc.peak >> 16) ? acc.peak & 0xFFFFu : acc.peak >> 16;
+    if (peak > stats->peak) stats->peak = (uint16_t)peak;
+
+    if (len & 1u) add_sample(stats, samples[len - 1], offset, shift, loud_level);
+}
+
+void block_stats_reference(const volatile uint16_t *samples, uint32_t len, uint16_t offset, uint8_t shift,
+                           uint16_t loud_level, block_stats_t *stats) {
+    *stats = (block_stats_t){0};
+    for (uint32_t i = 0; i < len; i++) add_sample(stats, samples[i], offset, shift, loud_level);
+}
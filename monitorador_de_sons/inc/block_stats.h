@@ -0,0 +1,36 @@
+#ifndef BLOCK_STATS_H
+#define BLOCK_STATS_H
+
+#include <stdint.h>
+
+/*
+Estatísticas de amplitude de um bloco: soma, pico, contagem acima de um limiar
+e soma dos quadrados de |x - offset| >> shift.
+
+`block_stats_compute` lê o bloco em palavras de 32 bits e processa as duas
+amostras de cada palavra juntas (SWAR): diferença, módulo, máximo e comparação
+por faixa de 16 bits com máscaras, sem desvios. As somas de amplitude e de
+contagem ficam nas faixas por BLOCK_STATS_CHUNK_WORDS palavras antes de serem
+juntadas, o que exige amplitudes de até 12 bits: amostras e offset devem caber
+em 12 + shift bits. Os quadrados usam a multiplicação de 32 bits do M0+ por
+amostra. Amostra inicial desalinhada e final ímpar são tratadas uma a uma.
+
+`block_stats_reference` é a versão escalar direta, com resultado idêntico bit a
+bit, usada para validar e comparar o desempenho.
+*/
+
+#define BLOCK_STATS_CHUNK_WORDS 16  // 16 * 4095 ainda cabe em uma faixa de 16 bits
+
+typedef struct {
+    uint32_t sum;          // Soma das amplitudes
+    uint64_t square_sum;   // Soma dos quadrados das amplitudes
+    uint16_t peak;
+    uint16_t loud;         // Amostras com amplitude >= loud_level
+} block_stats_t;
+
+void block_stats_compute(const volatile uint16_t *samples, uint32_t len, uint16_t offset, uint8_t shift,
+                         uint16_t loud_level, block_stats_t *stats);
+void block_stats_reference(const volatile uint16_t *samples, uint32_t len, uint16_t offset, uint8_t shift,
+                           uint16_t loud_level, block_stats_t *stats);
+
+#endif
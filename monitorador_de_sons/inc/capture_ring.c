@@ -0,0 +1,40 @@
+#include "capture_ring.h"
+
+void capture_ring_init(capture_ring_t *ring, uint32_t num_blocks) {
+    if (num_blocks < 4) num_blocks = 4;  // 2 slots ficam sempre com o DMA
+    if (num_blocks > CAPTURE_RING_MAX_BLOCKS) num_blocks = CAPTURE_RING_MAX_BLOCKS;
+    ring->num_blocks = 1u << (31 - __builtin_clz(num_blocks));  // Potência de 2 abaixo
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->overruns, 0, memory_order_relaxed);
+}
+
+// Chamada pela ISR quando um canal termina um bloco. Informa a sequência do
+// bloco fechado e retorna o slot em que esse mesmo canal deve ser rearmado
+// (dois blocos à frente do que acabou de fechar).
+uint32_t capture_ring_block_done(capture_ring_t *ring, uint32_t *done_seq) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    *done_seq = head;
+    return (head + 2) & (ring->num_blocks - 1);
+}
+
+// Slot `ahead` blocos depois do bloco que está sendo capturado agora.
+uint32_t capture_ring_slot(const capture_ring_t *ring, uint32_t ahead) {
+    uint32_t head = atomic_load_explicit((_Atomic uint32_t *)&ring->head, memory_order_relaxed);
+    return (head + ahead) & (ring->num_blocks - 1);
+}
+
+// Verifica se o bloco `seq` ainda não foi sobrescrito pelo DMA. Deve ser chamada
+// antes da análise e de novo ao final dela; cada falha conta um overrun.
+bool capture_ring_validate(capture_ring_t *ring, uint32_t seq) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head - seq <= ring->num_blocks - 2) return true;
+
+    uint32_t overruns = atomic_load_explicit(&ring->overruns, memory_order_relaxed);
+    atomic_store_explicit(&ring->overruns, overruns + 1, memory_order_relaxed);
+    return false;
+}
+
+uint32_t capture_ring_overruns(const capture_ring_t *ring) {
+    return atomic_load_explicit((_Atomic uint32_t *)&ring->overruns, memory_order_relaxed);
+}
@@ -0,0 +1,37 @@
+#ifndef CAPTURE_RING_H
+#define CAPTURE_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/*
+Anel de N blocos de captura alimentado por dois canais de DMA encadeados.
+
+O bloco de sequência `seq` sempre ocupa o slot `seq % num_blocks`, com
+`num_blocks` potência de 2 (capture_ring_init arredonda para baixo): só assim o
+slot segue em ordem quando a sequência de 32 bits dá a volta, e o DMA e o
+consumidor continuam no mesmo slot. Enquanto o
+canal ativo escreve o bloco `head`, o outro canal já está armado para o bloco
+`head + 1`; portanto apenas os blocos em [head + 2 - num_blocks, head) podem ser
+lidos com segurança pelo consumidor.
+
+`head` só é escrito pelo produtor (ISR do DMA) e `overruns` só pelo
+consumidor, o que dispensa travas entre os dois lados.
+*/
+
+#define CAPTURE_RING_MAX_BLOCKS 32  // Potência de 2
+
+typedef struct {
+    _Atomic uint32_t head;      // Blocos completados pelo DMA
+    _Atomic uint32_t overruns;  // Blocos sobrescritos antes de serem analisados
+    uint32_t num_blocks;
+} capture_ring_t;
+
+void capture_ring_init(capture_ring_t *ring, uint32_t num_blocks);
+uint32_t capture_ring_block_done(capture_ring_t *ring, uint32_t *done_seq);
+uint32_t capture_ring_slot(const capture_ring_t *ring, uint32_t ahead);
+bool capture_ring_validate(capture_ring_t *ring, uint32_t seq);
+uint32_t capture_ring_overruns(const capture_ring_t *ring);
+
+#endif
@@ -0,0 +1,23 @@
+#include "dc_tracker.h"
+
+void dc_tracker_init(dc_tracker_t *dc, int32_t nominal, uint32_t settle_samples) {
+    dc->shift = settle_samples ? DC_TRACKER_FAST_SHIFT : DC_TRACKER_SLOW_SHIFT;
+    dc->acc = nominal << dc->shift;
+    dc->settle_left = settle_samples;
+}
+
+// Passa as `len` amostras pelo integrador. A calibração termina na amostra exata
+// em que o tempo acaba: o acumulador é reescalado para a constante de tempo
+// lenta e o resto do bloco já segue com ela.
+void dc_tracker_process(dc_tracker_t *dc, const volatile uint16_t *samples, uint32_t len) {
+    uint32_t i = 0;
+    if (dc->settle_left > 0) {
+        uint32_t fast = dc->settle_left < len ? dc->settle_left : len;
+        for (; i < fast; i++) dc_tracker_add_sample(dc, samples[i]);
+        dc->settle_left -= fast;
+        if (dc->settle_left > 0) return;
+        dc->acc <<= DC_TRACKER_SLOW_SHIFT - DC_TRACKER_FAST_SHIFT;
+        dc->shift = DC_TRACKER_SLOW_SHIFT;
+    }
+    for (; i < len; i++) dc_tracker_add_sample(dc, samples[i]);
+}
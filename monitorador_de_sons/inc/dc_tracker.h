@@ -0,0 +1,48 @@
+#ifndef DC_TRACKER_H
+#define DC_TRACKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Estimativa incremental do nível DC (polarização do microfone), que deriva com a
+alimentação e a temperatura e, se fixada, seria retificada como amplitude.
+
+Um integrador com vazamento em ponto fixo acompanha a média das amostras:
+acc += x - (acc >> shift) a cada amostra, com nível = acc >> shift; são uma
+soma, uma subtração e um deslocamento por amostra, dentro do laço do bloco.
+Subtrair o nível é um passa-altas de primeira ordem com constante de tempo de
+2^shift amostras. Quem calcula as amplitudes de um bloco de uma vez (ex.:
+inc/block_stats.h) usa o nível do início do bloco; dentro dele o nível anda no
+máximo len / 2^shift da distância até a média.
+
+Na partida o rastreador fica em calibração: usa DC_TRACKER_FAST_SHIFT para
+convergir rápido a partir do valor nominal e, após `settle_samples` amostras,
+passa a DC_TRACKER_SLOW_SHIFT, lento o bastante para não seguir graves.
+*/
+
+#define DC_TRACKER_FAST_SHIFT 8    // 256 amostras (16 ms a 16 kHz)
+#define DC_TRACKER_SLOW_SHIFT 14   // 16384 amostras (1 s a 16 kHz, corte de 0,16 Hz)
+
+typedef struct {
+    int32_t acc;              // Nível << shift
+    uint8_t shift;
+    uint32_t settle_left;     // Amostras restantes da calibração
+} dc_tracker_t;
+
+void dc_tracker_init(dc_tracker_t *dc, int32_t nominal, uint32_t settle_samples);
+void dc_tracker_process(dc_tracker_t *dc, const volatile uint16_t *samples, uint32_t len);
+
+static inline int32_t dc_tracker_level(const dc_tracker_t *dc) {
+    return dc->acc >> dc->shift;
+}
+
+static inline void dc_tracker_add_sample(dc_tracker_t *dc, int32_t x) {
+    dc->acc += x - (dc->acc >> dc->shift);
+}
+
+static inline bool dc_tracker_settled(const dc_tracker_t *dc) {
+    return dc->settle_left == 0;
+}
+
+#endif
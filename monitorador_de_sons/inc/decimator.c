@@ -0,0 +1,142 @@
+#include <math.h>
+#include "decimator.h"
+
+#define TAP_SHIFT 14
+#define FIR_CENTER (DECIMATOR_FIR_TAPS / 2)
+#define CUTOFF 0.25        // Metade da taxa de saída, em relação à taxa de entrada do FIR
+#define DESIGN_GRID 2048   // Pontos por unidade de frequência na integração
+#define KAISER_BETA 7.0
+
+_Static_assert(DECIMATOR_CIC_ORDER == 4, "decimator_process desenrola 4 integradores");
+// Saída dos pentes: ganho (ratio/2)^4 sobre amplitudes de até 4095 LSB, em int32
+_Static_assert((1ull << DECIMATOR_CIC_ORDER * (__builtin_ctz(DECIMATOR_MAX_RATIO) - 1)) * 4095 <= INT32_MAX,
+               "DECIMATOR_MAX_RATIO estoura a saída do CIC");
+
+// Módulo da resposta do CIC na frequência `nu` (relativa à sua taxa de saída)
+static double cic_response(double nu, uint32_t r) {
+    if (nu == 0.0) return 1.0;
+    double h = sin(M_PI * nu) / (r * sin(M_PI * nu / r));
+    return pow(fabs(h), DECIMATOR_CIC_ORDER);
+}
+
+// Função de Bessel modificada I0 pela série de potências
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+// Projeta o FIR por amostragem em frequência: h[m] = 2 * integral de D(nu) cos(2 pi nu m)
+// em [0, CUTOFF], com D(nu) o inverso da resposta do CIC, e os cossenos de cada ponto da grade gerados pela recorrência de
+// Chebyshev. A janela de Kaiser aplicada em seguida define a transição em torno de
+// CUTOFF; por fim o ganho DC é normalizado e os coeficientes quantizados em Q14.
+static void design_fir(decimator_t *dec) {
+    double h[FIR_CENTER + 1] = {0};
+    double step = 1.0 / DESIGN_GRID;
+
+    for (double nu = step / 2; nu < CUTOFF; nu += step) {
+        double d = 2.0 * step / cic_response(nu, dec->cic_ratio);
+        double c2 = 2.0 * cos(2.0 * M_PI * nu);
+        double prev = 1.0, cur = c2 / 2.0;  // cos(0) e cos(theta)
+        h[0] += d;
+        for (uint32_t m = 1; m <= FIR_CENTER; m++) {
+            h[m] += d * cur;
+            double next = c2 * cur - prev;
+            prev = cur;
+            cur = next;
+        }
+    }
+
+    double i0_beta = bessel_i0(KAISER_BETA), dc = 0.0;
+    for (uint32_t m = 0; m <= FIR_CENTER; m++) {
+        double t = (double)m / FIR_CENTER;
+        h[m] *= bessel_i0(KAISER_BETA * sqrt(1.0 - t * t)) / i0_beta;
+        dc += m == 0 ? h[m] : 2.0 * h[m];
+    }
+
+    // taps[k] é o coeficiente a FIR_CENTER - k amostras do centro
+    int32_t sum = 0;
+    for (uint32_t m = 1; m <= FIR_CENTER; m++) {
+        int16_t tap = (int16_t)lround(h[m] / dc * (1 << TAP_SHIFT));
+        dec->taps[FIR_CENTER - m] = tap;
+        sum += 2 * tap;
+    }
+    dec->taps[FIR_CENTER] = (int16_t)((1 << TAP_SHIFT) - sum);  // Ganho DC exato após o arredondamento
+}
+
+bool decimator_init(decimator_t *dec, uint32_t ratio, int32_t offset) {
+    if (ratio < 4 || ratio > DECIMATOR_MAX_RATIO || (ratio & (ratio - 1))) return false;
+
+    dec->cic_ratio = ratio / 2;
+    dec->cic_shift = (uint8_t)(DECIMATOR_CIC_ORDER * __builtin_ctz(dec->cic_ratio) - DECIMATOR_OUTPUT_SHIFT);
+    dec->offset = offset;
+    design_fir(dec);
+    decimator_reset(dec);
+    return true;
+}
+
+void decimator_reset(decimator_t *dec) {
+    for (uint8_t s = 0; s < DECIMATOR_CIC_ORDER; s++) dec->integrators[s] = dec->combs[s] = 0;
+    for (uint32_t i = 0; i < 2 * DECIMATOR_FIR_TAPS; i++) dec->history[i] = 0;
+    dec->cic_phase = 0;
+    dec->history_pos = 0;
+    dec->fir_phase = false;
+}
+
+// Decima `len` amostras do ADC e grava as saídas em `out`. Retorna quantas foram
+// geradas (len / ratio quando len é múltiplo da razão).
+uint32_t decimator_process(decimator_t *dec, const volatile uint16_t *in, uint32_t len, uint16_t *out) {
+    uint32_t i0 = dec->integrators[0], i1 = dec->integrators[1];
+    uint32_t i2 = dec->integrators[2], i3 = dec->integrators[3];
+    uint32_t phase = dec->cic_phase, produced = 0;
+    int32_t center = dec->offset << DECIMATOR_OUTPUT_SHIFT;
+    int32_t round = dec->cic_shift ? 1 << (dec->cic_shift - 1) : 0;
+
+    for (uint32_t n = 0; n < len; n++) {
+        i0 += (uint32_t)((int32_t)in[n] - dec->offset);
+        i1 += i0;
+        i2 += i1;
+        i3 += i2;
+        if (++phase < dec->cic_ratio) continue;
+        phase = 0;
+
+        // Pentes na taxa decimada; a diferença modular desfaz o estouro dos integradores
+        uint32_t y = i3;
+        for (uint8_t s = 0; s < DECIMATOR_CIC_ORDER; s++) {
+            uint32_t t = y;
+            y -= dec->combs[s];
+            dec->combs[s] = t;
+        }
+
+        // Mais recente no menor índice; a janela é history[pos .. pos + TAPS - 1]
+        uint32_t pos = dec->history_pos ? dec->history_pos - 1u : DECIMATOR_FIR_TAPS - 1u;
+        int32_t x = ((int32_t)y + round) >> dec->cic_shift;
+        dec->history[pos] = dec->history[pos + DECIMATOR_FIR_TAPS] = x;
+        dec->history_pos = (uint8_t)pos;
+
+        dec->fir_phase = !dec->fir_phase;
+        if (dec->fir_phase) continue;
+
+        const int32_t *w = &dec->history[pos];
+        int32_t acc = dec->taps[FIR_CENTER] * w[FIR_CENTER];
+        for (uint32_t k = 0; k < FIR_CENTER; k++) {
+            acc += dec->taps[k] * (w[k] + w[DECIMATOR_FIR_TAPS - 1 - k]);
+        }
+
+        int32_t v = ((acc + (1 << (TAP_SHIFT - 1))) >> TAP_SHIFT) + center;
+        if (v < 0) v = 0;
+        if (v > 65535) v = 65535;
+        out[produced++] = (uint16_t)v;
+    }
+
+    dec->integrators[0] = i0;
+    dec->integrators[1] = i1;
+    dec->integrators[2] = i2;
+    dec->integrators[3] = i3;
+    dec->cic_phase = phase;
+    return produced;
+}
@@ -0,0 +1,50 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Decimador em ponto fixo para o modo de sobreamostragem do ADC.
+
+O ADC roda `ratio` vezes mais rápido que a taxa de análise e cada bloco passa
+por dois estágios:
+
+- CIC de ordem 4 decimando por ratio/2: integradores e pentes em uint32 com
+  aritmética modular, então o estouro dos integradores se cancela nos pentes.
+  O que não pode estourar é a saída dos pentes, de ganho (ratio/2)^4: com 12
+  bits de entrada ela cabe em int32 até ratio 32, e DECIMATOR_MAX_RATIO fica
+  em 16 (o maior OVERSAMPLE_FACTOR do firmware) com folga.
+- FIR simétrico de DECIMATOR_FIR_TAPS coeficientes (Q14) decimando por 2, que
+  compensa a queda do CIC na banda de passagem (até 0,45 da taxa de saída) e
+  rejeita o que dobraria sobre ela. Só as saídas mantidas são calculadas.
+
+Os coeficientes são projetados uma única vez na inicialização (amostragem em
+frequência com janela de Kaiser); o processamento por amostra é só aritmética
+inteira. A saída tem DECIMATOR_OUTPUT_SHIFT bits fracionários em relação ao
+LSB do ADC e é centrada em offset << DECIMATOR_OUTPUT_SHIFT.
+*/
+
+#define DECIMATOR_CIC_ORDER 4
+#define DECIMATOR_FIR_TAPS 79
+#define DECIMATOR_MAX_RATIO 16      // Potência de 2, de 4 até este valor
+#define DECIMATOR_OUTPUT_SHIFT 4    // Saída em 1/16 de LSB do ADC
+
+typedef struct {
+    uint32_t integrators[DECIMATOR_CIC_ORDER];
+    uint32_t combs[DECIMATOR_CIC_ORDER];
+    int16_t taps[(DECIMATOR_FIR_TAPS + 1) / 2];  // Metade do FIR simétrico, Q14
+    int32_t history[2 * DECIMATOR_FIR_TAPS];      // Saídas do CIC, duplicadas para evitar o módulo
+    uint32_t cic_ratio;   // ratio / 2
+    uint32_t cic_phase;
+    uint8_t cic_shift;    // Normaliza o ganho (ratio/2)^4 do CIC para DECIMATOR_OUTPUT_SHIFT
+    uint8_t history_pos;
+    bool fir_phase;
+    int32_t offset;       // Nível do ADC correspondente ao silêncio
+} decimator_t;
+
+bool decimator_init(decimator_t *dec, uint32_t ratio, int32_t offset);
+void decimator_reset(decimator_t *dec);
+uint32_t decimator_process(decimator_t *dec, const volatile uint16_t *in, uint32_t len, uint16_t *out);
+
+#endif
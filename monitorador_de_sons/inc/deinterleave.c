@@ -0,0 +1,23 @@
+#include "deinterleave.h"
+
+void deinterleave(const volatile uint16_t *in, uint32_t frames, uint8_t channels, uint16_t *out) {
+    if (channels == 2 && !((uintptr_t)in & 2u)) {
+        const volatile uint32_t *words = (const volatile uint32_t *)in;
+        uint16_t *second = out + frames;
+        for (uint32_t f = 0; f < frames; f++) {
+            uint32_t w = words[f];
+            out[f] = (uint16_t)w;
+            second[f] = (uint16_t)(w >> 16);
+        }
+        return;
+    }
+
+    for (uint8_t k = 0; k < channels; k++) {
+        const volatile uint16_t *src = in + k;
+        uint16_t *dst = out + (uint32_t)k * frames;
+        for (uint32_t f = 0; f < frames; f++) {
+            dst[f] = *src;
+            src += channels;
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef DEINTERLEAVE_H
+#define DEINTERLEAVE_H
+
+#include <stdint.h>
+
+/*
+Separação por canal das amostras do ADC em rodízio (round robin).
+
+Com N entradas no rodízio o DMA grava um único fluxo intercalado
+c0 c1 ... cN-1 c0 c1 ...; como o bloco tem um número inteiro de quadros e a
+captura sempre recomeça pela primeira entrada, todo bloco começa no canal 0.
+`deinterleave` copia cada canal para um trecho contíguo de `out`, com o canal
+k em out[k * frames], para que decimador, medidor e espectro continuem lendo
+amostras consecutivas.
+
+Cada canal é copiado em uma passada com passo N na leitura e escrita
+sequencial; com 2 canais e o bloco alinhado, cada palavra de 32 bits lida dá
+uma amostra de cada canal. O custo por amostra não depende de N.
+*/
+
+void deinterleave(const volatile uint16_t *in, uint32_t frames, uint8_t channels, uint16_t *out);
+
+#endif
@@ -0,0 +1,327 @@
+#include <string.h>
+#include "event_log.h"
+#include "telemetry.h"
+
+#define HEADER_LEN 12  // Magic, sequência do setor e número da partida
+
+static uint8_t *put_varint(uint8_t *p, uint32_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+static uint8_t *put_zigzag(uint8_t *p, int32_t value) {
+    return put_varint(p, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+// Lê um varint de [*p, end); retorna false se o campo passar do fim
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint32_t *value) {
+    uint32_t result = 0;
+    for (uint8_t shift = 0; shift < 35 && *p < end; shift += 7) {
+        uint8_t byte = *(*p)++;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_zigzag(const uint8_t **p, const uint8_t *end, int32_t *value) {
+    uint32_t raw;
+    if (!get_varint(p, end, &raw)) return false;
+    *value = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+    return true;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void delta_reset(event_log_delta_t *delta) {
+    memset(delta, 0, sizeof(*delta));
+}
+
+// Codifica um registro completo (com tipo, tamanho e CRC) e atualiza o estado de delta
+uint32_t event_log_encode(const event_log_record_t *record, event_log_delta_t *delta, uint8_t *out) {
+    uint8_t *p = out + 2;
+
+    if (record->type == EVENT_LOG_BOOT) {
+        p = put_varint(p, record->time_s);
+        p = put_varint(p, record->boot.count);
+    } else {
+        p = put_varint(p, record->time_s - delta->time_s);
+    }
+    delta->time_s = record->time_s;
+
+    if (record->type == EVENT_LOG_MINUTE) {
+        const int16_t levels[5] = {
+            record->minute.laeq_db_x10, record->minute.lafmax_db_x10,
+            record->minute.l10_db_x10, record->minute.l50_db_x10, record->minute.l90_db_x10
+        };
+        for (uint8_t i = 0; i < 5; i++) {
+            p = put_zigzag(p, levels[i] - delta->levels[i]);
+            delta->levels[i] = levels[i];
+        }
+        p = put_varint(p, record->minute.peak_max);
+        p = put_varint(p, record->minute.loud_blocks);
+        p = put_varint(p, record->minute.alerts);
+        p = put_varint(p, record->minute.gap_ms);
+    } else if (record->type == EVENT_LOG_ALERT) {
+        p = put_varint(p, record->alert.rules);
+        p = put_zigzag(p, record->alert.laf_db_x10);
+    }
+
+    out[0] = record->type;
+    out[1] = (uint8_t)(p - out - 2);
+    uint16_t crc = telemetry_crc16(out, p - out);
+    *p++ = crc & 0xFF;
+    *p++ = crc >> 8;
+    return (uint32_t)(p - out);
+}
+
+static bool decode_payload(const uint8_t *p, const uint8_t *end, event_log_delta_t *delta, event_log_record_t *record) {
+    uint32_t time, value;
+    int32_t level;
+
+    record->type = p[-2];
+    if (!get_varint(&p, end, &time)) return false;
+    if (record->type == EVENT_LOG_BOOT) {
+        if (!get_varint(&p, end, &value)) return false;
+        record->boot.count = value;
+        record->time_s = time;
+    } else {
+        record->time_s = delta->time_s + time;
+    }
+
+    if (record->type == EVENT_LOG_MINUTE) {
+        int16_t *levels[5] = {
+            &record->minute.laeq_db_x10, &record->minute.lafmax_db_x10,
+            &record->minute.l10_db_x10, &record->minute.l50_db_x10, &record->minute.l90_db_x10
+        };
+        for (uint8_t i = 0; i < 5; i++) {
+            if (!get_zigzag(&p, end, &level)) return false;
+            *levels[i] = (int16_t)(delta->levels[i] + level);
+        }
+        uint16_t *counts[4] = {
+            &record->minute.peak_max, &record->minute.loud_blocks, &record->minute.alerts, &record->minute.gap_ms
+        };
+        for (uint8_t i = 0; i < 4; i++) {
+            if (!get_varint(&p, end, &value)) return false;
+            *counts[i] = (uint16_t)value;
+        }
+        for (uint8_t i = 0; i < 5; i++) delta->levels[i] = *levels[i];
+    } else if (record->type == EVENT_LOG_ALERT) {
+        if (!get_varint(&p, end, &value) || !get_zigzag(&p, end, &level)) return false;
+        record->alert.rules = value;
+        record->alert.laf_db_x10 = (int16_t)level;
+    } else if (record->type != EVENT_LOG_BOOT) {
+        return false;
+    }
+    delta->time_s = record->time_s;
+    return p == end;
+}
+
+static bool sector_valid(const event_log_t *log, uint32_t sector, uint32_t *seq) {
+    const uint8_t *p = log->flash.base + sector * EVENT_LOG_SECTOR_SIZE;
+    if (get_u32(p) != EVENT_LOG_MAGIC) return false;
+    *seq = get_u32(p + 4);
+    return true;
+}
+
+// O número da partida vai no cabeçalho para sobreviver ao apagamento do setor
+// que tinha o registro de partida
+static uint32_t sector_boot(const event_log_t *log, uint32_t sector) {
+    return get_u32(log->flash.base + sector * EVENT_LOG_SECTOR_SIZE + 8);
+}
+
+// Percorre os registros de um setor, chamando `visit` para os válidos (se não
+// for NULL). Retorna a posição do primeiro byte livre.
+static uint32_t scan_sector(const event_log_t *log, uint32_t sector, event_log_visitor_t visit, void *ctx) {
+    const uint8_t *base = log->flash.base + sector * EVENT_LOG_SECTOR_SIZE;
+    event_log_delta_t delta;
+    delta_reset(&delta);
+
+    uint32_t pos = HEADER_LEN;
+    while (pos + 4 <= EVENT_LOG_SECTOR_SIZE && base[pos] != 0xFF) {
+        uint32_t len = base[pos + 1];
+        event_log_record_t record;
+        event_log_delta_t next = delta;
+        bool ok = pos + len + 4 <= EVENT_LOG_SECTOR_SIZE
+               && (base[pos + 2 + len] | (base[pos + 3 + len] << 8)) == telemetry_crc16(base + pos, len + 2)
+               && decode_payload(base + pos + 2, base + pos + 2 + len, &next, &record);
+        if (!ok) {
+            pos = (pos / EVENT_LOG_PAGE_SIZE + 1) * EVENT_LOG_PAGE_SIZE;  // Gravação interrompida
+            continue;
+        }
+        delta = next;
+        if (visit) visit(ctx, &record);
+        pos += len + 4;
+    }
+    return pos < EVENT_LOG_SECTOR_SIZE ? pos : EVENT_LOG_SECTOR_SIZE;
+}
+
+typedef struct {
+    event_log_delta_t delta;  // Estado após o último registro visitado
+    uint32_t last_boot;       // Maior número de partida encontrado
+    uint32_t records;
+} scan_state_t;
+
+static void scan_visitor(void *ctx, const event_log_record_t *record) {
+    scan_state_t *state = ctx;
+    state->delta.time_s = record->time_s;
+    if (record->type == EVENT_LOG_MINUTE) {
+        state->delta.levels[0] = record->minute.laeq_db_x10;
+        state->delta.levels[1] = record->minute.lafmax_db_x10;
+        state->delta.levels[2] = record->minute.l10_db_x10;
+        state->delta.levels[3] = record->minute.l50_db_x10;
+        state->delta.levels[4] = record->minute.l90_db_x10;
+    }
+    if (record->type == EVENT_LOG_BOOT && record->boot.count > state->last_boot) state->last_boot = record->boot.count;
+    state->records++;
+}
+
+// Localiza o setor mais recente, a posição de escrita e o estado de delta nele,
+// e enfileira o registro de partida.
+void event_log_init(event_log_t *log, const event_log_flash_t *flash) {
+    log->flash = *flash;
+    log->open = false;
+    log->sector = log->sector_seq = 0;
+    log->write_pos = HEADER_LEN;
+    log->queued = 0;
+    log->dropped = 0;
+    log->erases = 0;
+    delta_reset(&log->delta);
+
+    for (uint32_t s = 0; s < flash->sectors; s++) {
+        uint32_t seq;
+        if (!sector_valid(log, s, &seq)) continue;
+        if (!log->open || (int32_t)(seq - log->sector_seq) > 0) {
+            log->open = true;
+            log->sector = s;
+            log->sector_seq = seq;
+        }
+    }
+
+    scan_state_t state = {0};
+    for (uint32_t i = 1; log->open && i <= flash->sectors; i++) {
+        uint32_t s = (log->sector + i) % flash->sectors, seq;
+        if (!sector_valid(log, s, &seq)) continue;
+        delta_reset(&state.delta);
+        if (sector_boot(log, s) > state.last_boot) state.last_boot = sector_boot(log, s);
+        uint32_t end = scan_sector(log, s, scan_visitor, &state);
+        if (s == log->sector) log->write_pos = end;  // O atual é o último da volta
+    }
+    log->delta = state.delta;
+    log->boot_count = state.last_boot + 1;
+
+    event_log_record_t record = { .type = EVENT_LOG_BOOT, .time_s = 0 };
+    record.boot.count = log->boot_count;
+    event_log_append(log, &record);
+}
+
+bool event_log_append(event_log_t *log, const event_log_record_t *record) {
+    if (log->queued >= EVENT_LOG_QUEUE_SIZE) {
+        log->dropped++;
+        return false;
+    }
+    log->queue[log->queued++] = *record;
+    return true;
+}
+
+bool event_log_pending(const event_log_t *log) {
+    return log->queued > 0;
+}
+
+static void open_next_sector(event_log_t *log) {
+    log->sector = log->open ? (log->sector + 1) % log->flash.sectors : 0;
+    log->sector_seq++;
+    log->open = true;
+    log->erases++;
+
+    uint32_t offset = log->sector * EVENT_LOG_SECTOR_SIZE;
+    log->flash.erase_sector(offset);
+    memset(log->page, 0xFF, EVENT_LOG_PAGE_SIZE);
+    const uint32_t header[3] = { EVENT_LOG_MAGIC, log->sector_seq, log->boot_count };
+    for (uint8_t i = 0; i < HEADER_LEN; i++) log->page[i] = (uint8_t)(header[i / 4] >> (8 * (i % 4)));
+    log->flash.program_page(offset, log->page);
+
+    log->write_pos = HEADER_LEN;
+    delta_reset(&log->delta);
+}
+
+// Indica se gravar a fila agora vai apagar um setor: algum registro não cabe
+// mais no setor atual (ou ainda não há setor)
+bool event_log_commit_erases(const event_log_t *log) {
+    if (log->queued == 0) return false;
+    if (!log->open) return true;
+    event_log_delta_t delta = log->delta;
+    uint32_t pos = log->write_pos;
+    for (uint8_t i = 0; i < log->queued; i++) {
+        uint8_t buf[EVENT_LOG_RECORD_MAX];
+        pos += event_log_encode(&log->queue[i], &delta, buf);
+        if (pos > EVENT_LOG_SECTOR_SIZE) return true;
+    }
+    return false;
+}
+
+// Grava os registros enfileirados. Cada página tocada é lida da flash, recebe os
+// bytes novos e é programada de novo; como só bits 1 viram 0, os registros já
+// gravados não mudam. Um registro que não cabe no setor abre o próximo.
+void event_log_commit(event_log_t *log) {
+    uint32_t page_offset = UINT32_MAX;
+    for (uint8_t i = 0; i < log->queued; i++) {
+        uint8_t buf[EVENT_LOG_RECORD_MAX];
+        event_log_delta_t delta = log->delta;
+        uint32_t len = event_log_encode(&log->queue[i], &delta, buf);
+
+        if (!log->open || log->write_pos + len > EVENT_LOG_SECTOR_SIZE) {
+            if (page_offset != UINT32_MAX) log->flash.program_page(page_offset, log->page);
+            page_offset = UINT32_MAX;
+            open_next_sector(log);
+            delta = log->delta;
+            len = event_log_encode(&log->queue[i], &delta, buf);
+        }
+
+        for (uint32_t b = 0; b < len; b++) {
+            uint32_t offset = log->sector * EVENT_LOG_SECTOR_SIZE + log->write_pos;
+            uint32_t page = offset & ~(uint32_t)(EVENT_LOG_PAGE_SIZE - 1);
+            if (page != page_offset) {
+                if (page_offset != UINT32_MAX) log->flash.program_page(page_offset, log->page);
+                memcpy(log->page, log->flash.base + page, EVENT_LOG_PAGE_SIZE);
+                page_offset = page;
+            }
+            log->page[offset - page] = buf[b];
+            log->write_pos++;
+        }
+        log->delta = delta;
+    }
+    if (page_offset != UINT32_MAX) log->flash.program_page(page_offset, log->page);
+    log->queued = 0;
+}
+
+typedef struct {
+    event_log_visitor_t visit;
+    void *ctx;
+    uint32_t records;
+} read_state_t;
+
+static void read_visitor(void *ctx, const event_log_record_t *record) {
+    read_state_t *state = ctx;
+    state->records++;
+    state->visit(state->ctx, record);
+}
+
+// Entrega todos os registros válidos, do setor mais antigo ao mais recente. Retorna quantos foram lidos.
+uint32_t event_log_read(const event_log_t *log, event_log_visitor_t visit, void *ctx) {
+    read_state_t state = { visit, ctx, 0 };
+    for (uint32_t i = 1; log->open && i <= log->flash.sectors; i++) {
+        uint32_t s = (log->sector + i) % log->flash.sectors, seq;
+        if (sector_valid(log, s, &seq)) scan_sector(log, s, read_visitor, &state);
+    }
+    return state.records;
+}
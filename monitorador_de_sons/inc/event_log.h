@@ -0,0 +1,108 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Registro persistente de eventos em uma região reservada da flash.
+
+A região é dividida em setores usados em rodízio: quando um enche, o próximo é
+apagado e recebe um cabeçalho com uma sequência crescente e o número da partida
+atual. Cada setor é apagado uma vez por volta completa (nivelamento de
+desgaste) e o mais antigo é o primeiro a ser descartado. Dentro do setor os registros só são acrescentados:
+
+    tipo (1) | tamanho (1) | campos em varint | CRC-16 (2, little-endian)
+
+Os campos são codificados em relação ao registro anterior do mesmo setor
+(tempo e níveis em delta, com sinal em zigzag), e o primeiro registro de cada
+setor e os de partida usam valores absolutos, então cada setor é decodificado
+sozinho. Um registro com CRC inválido (gravação interrompida por falta de
+energia) faz a leitura pular para a próxima página; um byte 0xFF no início de
+um registro marca o fim dos dados do setor.
+
+`event_log_append` só enfileira na RAM; a flash é apagada e gravada apenas em
+`event_log_commit`. Um setor só é apagado no rodízio: as gravações comuns
+programam uma ou duas páginas (~1 ms cada), e `event_log_commit_erases` diz
+antes se a próxima vai apagar (dezenas de ms), para o chamador só então parar
+a captura. O acesso à flash é feito pelas funções de `event_log_flash_t`, o que
+permite testar o módulo no computador com uma flash simulada em RAM.
+
+O registro de minuto termina com `gap_ms`, o tempo em que a captura ficou
+parada no minuto.
+*/
+
+#define EVENT_LOG_SECTOR_SIZE 4096
+#define EVENT_LOG_PAGE_SIZE 256
+#define EVENT_LOG_QUEUE_SIZE 16
+#define EVENT_LOG_RECORD_MAX 40
+#define EVENT_LOG_MAGIC 0x474F4C4Du  // "MLOG"
+
+typedef enum {
+    EVENT_LOG_BOOT = 1,    // Partida do firmware
+    EVENT_LOG_MINUTE = 2,  // Agregado de um minuto de medição
+    EVENT_LOG_ALERT = 3    // Alerta disparado
+} event_log_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint32_t time_s;  // Segundos desde a partida
+    union {
+        struct {
+            uint32_t count;  // Número da partida, crescente
+        } boot;
+        struct {
+            int16_t laeq_db_x10, lafmax_db_x10;
+            int16_t l10_db_x10, l50_db_x10, l90_db_x10;
+            uint16_t peak_max;
+            uint16_t loud_blocks;
+            uint16_t alerts;
+            uint16_t gap_ms;  // Captura parada para apagar a flash durante o minuto
+        } minute;
+        struct {
+            uint32_t rules;  // Máscara das regras que dispararam
+            int16_t laf_db_x10;
+        } alert;
+    };
+} event_log_record_t;
+
+typedef struct {
+    const uint8_t *base;  // Região mapeada para leitura
+    uint32_t sectors;
+    void (*erase_sector)(uint32_t offset);                      // Offset relativo à região
+    void (*program_page)(uint32_t offset, const uint8_t *data);  // EVENT_LOG_PAGE_SIZE bytes
+} event_log_flash_t;
+
+// Estado da codificação em delta, reiniciado a cada setor
+typedef struct {
+    uint32_t time_s;
+    int16_t levels[5];
+} event_log_delta_t;
+
+typedef struct {
+    event_log_flash_t flash;
+    bool open;              // Há um setor válido em uso
+    uint32_t sector;
+    uint32_t sector_seq;
+    uint32_t write_pos;     // Próximo byte livre dentro do setor
+    event_log_delta_t delta;
+    uint32_t boot_count;
+    event_log_record_t queue[EVENT_LOG_QUEUE_SIZE];
+    uint8_t queued;
+    uint32_t dropped;       // Registros descartados com a fila cheia
+    uint32_t erases;
+    uint8_t page[EVENT_LOG_PAGE_SIZE];
+} event_log_t;
+
+typedef void (*event_log_visitor_t)(void *ctx, const event_log_record_t *record);
+
+void event_log_init(event_log_t *log, const event_log_flash_t *flash);
+bool event_log_append(event_log_t *log, const event_log_record_t *record);
+bool event_log_pending(const event_log_t *log);
+bool event_log_commit_erases(const event_log_t *log);
+void event_log_commit(event_log_t *log);
+uint32_t event_log_read(const event_log_t *log, event_log_visitor_t visit, void *ctx);
+
+uint32_t event_log_encode(const event_log_record_t *record, event_log_delta_t *delta, uint8_t *out);
+
+#endif
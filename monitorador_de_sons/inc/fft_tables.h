@@ -0,0 +1,72 @@
+#ifndef FFT_TABLES_H
+#define FFT_TABLES_H
+
+#include <stdint.h>
+
+// Tabelas em Q15 para a FFT real de 256 pontos (ficam na flash por serem const).
+// Geradas com: cos/sin(2*pi*k/256) e janela de Hann 0.5 - 0.5*cos(2*pi*n/256).
+
+#define FFT_TABLE_SIZE 256
+
+// {cos, sin} de 2*pi*k/256, k = 0..127
+static const int16_t fft_twiddle_q15[FFT_TABLE_SIZE / 2][2] = {
+    {32767, 0}, {32758, 804}, {32729, 1608}, {32679, 2411},
+    {32610, 3212}, {32522, 4011}, {32413, 4808}, {32286, 5602},
+    {32138, 6393}, {31972, 7180}, {31786, 7962}, {31581, 8740},
+    {31357, 9512}, {31114, 10279}, {30853, 11039}, {30572, 11793},
+    {30274, 12540}, {29957, 13279}, {29622, 14010}, {29269, 14733},
+    {28899, 15447}, {28511, 16151}, {28106, 16846}, {27684, 17531},
+    {27246, 18205}, {26791, 18868}, {26320, 19520}, {25833, 20160},
+    {25330, 20788}, {24812, 21403}, {24279, 22006}, {23732, 22595},
+    {23170, 23170}, {22595, 23732}, {22006, 24279}, {21403, 24812},
+    {20788, 25330}, {20160, 25833}, {19520, 26320}, {18868, 26791},
+    {18205, 27246}, {17531, 27684}, {16846, 28106}, {16151, 28511},
+    {15447, 28899}, {14733, 29269}, {14010, 29622}, {13279, 29957},
+    {12540, 30274}, {11793, 30572}, {11039, 30853}, {10279, 31114},
+    {9512, 31357}, {8740, 31581}, {7962, 31786}, {7180, 31972},
+    {6393, 32138}, {5602, 32286}, {4808, 32413}, {4011, 32522},
+    {3212, 32610}, {2411, 32679}, {1608, 32729}, {804, 32758},
+    {0, 32767}, {-804, 32758}, {-1608, 32729}, {-2411, 32679},
+    {-3212, 32610}, {-4011, 32522}, {-4808, 32413}, {-5602, 32286},
+    {-6393, 32138}, {-7180, 31972}, {-7962, 31786}, {-8740, 31581},
+    {-9512, 31357}, {-10279, 31114}, {-11039, 30853}, {-11793, 30572},
+    {-12540, 30274}, {-13279, 29957}, {-14010, 29622}, {-14733, 29269},
+    {-15447, 28899}, {-16151, 28511}, {-16846, 28106}, {-17531, 27684},
+    {-18205, 27246}, {-18868, 26791}, {-19520, 26320}, {-20160, 25833},
+    {-20788, 25330}, {-21403, 24812}, {-22006, 24279}, {-22595, 23732},
+    {-23170, 23170}, {-23732, 22595}, {-24279, 22006}, {-24812, 21403},
+    {-25330, 20788}, {-25833, 20160}, {-26320, 19520}, {-26791, 18868},
+    {-27246, 18205}, {-27684, 17531}, {-28106, 16846}, {-28511, 16151},
+    {-28899, 15447}, {-29269, 14733}, {-29622, 14010}, {-29957, 13279},
+    {-30274, 12540}, {-30572, 11793}, {-30853, 11039}, {-31114, 10279},
+    {-31357, 9512}, {-31581, 8740}, {-31786, 7962}, {-31972, 7180},
+    {-32138, 6393}, {-32286, 5602}, {-32413, 4808}, {-32522, 4011},
+    {-32610, 3212}, {-32679, 2411}, {-32729, 1608}, {-32758, 804}
+};
+
+static const int16_t fft_hann_q15[FFT_TABLE_SIZE] = {
+    0, 5, 20, 44, 79, 123, 177, 241, 315, 398, 491, 593,
+    705, 827, 958, 1098, 1247, 1406, 1573, 1749, 1935, 2128, 2331, 2542,
+    2761, 2989, 3224, 3468, 3719, 3978, 4244, 4518, 4799, 5087, 5381, 5682,
+    5990, 6304, 6624, 6950, 7282, 7619, 7961, 8308, 8661, 9018, 9379, 9745,
+    10114, 10487, 10864, 11245, 11628, 12014, 12403, 12794, 13188, 13583, 13980, 14378,
+    14778, 15179, 15580, 15982, 16384, 16786, 17188, 17589, 17990, 18390, 18788, 19185,
+    19580, 19974, 20365, 20754, 21140, 21523, 21904, 22281, 22654, 23023, 23389, 23750,
+    24107, 24460, 24807, 25149, 25486, 25818, 26144, 26464, 26778, 27086, 27387, 27681,
+    27969, 28250, 28524, 28790, 29049, 29300, 29544, 29779, 30007, 30226, 30437, 30640,
+    30833, 31019, 31195, 31362, 31521, 31670, 31810, 31941, 32063, 32175, 32277, 32370,
+    32453, 32527, 32591, 32645, 32689, 32724, 32748, 32763, 32767, 32763, 32748, 32724,
+    32689, 32645, 32591, 32527, 32453, 32370, 32277, 32175, 32063, 31941, 31810, 31670,
+    31521, 31362, 31195, 31019, 30833, 30640, 30437, 30226, 30007, 29779, 29544, 29300,
+    29049, 28790, 28524, 28250, 27969, 27681, 27387, 27086, 26778, 26464, 26144, 25818,
+    25486, 25149, 24807, 24460, 24107, 23750, 23389, 23023, 22654, 22281, 21904, 21523,
+    21140, 20754, 20365, 19974, 19580, 19185, 18788, 18390, 17990, 17589, 17188, 16786,
+    16384, 15982, 15580, 15179, 14778, 14378, 13980, 13583, 13188, 12794, 12403, 12014,
+    11628, 11245, 10864, 10487, 10114, 9745, 9379, 9018, 8661, 8308, 7961, 7619,
+    7282, 6950, 6624, 6304, 5990, 5682, 5381, 5087, 4799, 4518, 4244, 3978,
+    3719, 3468, 3224, 2989, 2761, 2542, 2331, 2128, 1935, 1749, 1573, 1406,
+    1247, 1098, 958, 827, 705, 593, 491, 398, 315, 241, 177, 123,
+    79, 44, 20, 5
+};
+
+#endif
@@ -0,0 +1,22 @@
+#include "isr_log.h"
+
+void isr_log_init(isr_log_t *log) {
+    atomic_store_explicit(&log->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&log->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&log->dropped, 0, memory_order_relaxed);
+}
+
+// Lado do consumidor (laço principal).
+bool isr_log_pop(isr_log_t *log, isr_log_entry_t *entry) {
+    uint32_t tail = atomic_load_explicit(&log->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&log->head, memory_order_acquire);
+    if (head == tail) return false;
+
+    *entry = log->items[tail & (ISR_LOG_SIZE - 1)];
+    atomic_store_explicit(&log->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t isr_log_dropped(const isr_log_t *log) {
+    return atomic_load_explicit((_Atomic uint32_t *)&log->dropped, memory_order_relaxed);
+}
@@ -0,0 +1,61 @@
+#ifndef ISR_LOG_H
+#define ISR_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/*
+Registro de mensagens geradas em interrupções, formatadas depois fora delas.
+
+Uma ISR não deve chamar printf: a saída pela UART e pelo USB pode bloquear por
+milissegundos e atrasar a ISR do DMA que esvazia o ADC. Em vez disso a ISR
+grava um registro binário de tamanho fixo (instante, identificador da mensagem
+e um argumento) em uma fila SPSC sem travas, e uma tarefa do laço principal
+retira e formata os registros com `isr_log_pop`.
+
+`isr_log_push` é inline e faz só duas leituras, três escritas do registro e a
+publicação de `head`, sem laços nem chamadas. Com a fila cheia o registro é
+descartado e `dropped` incrementado; a ordem dos registros entregues é sempre a
+de gravação. Um único produtor é suportado: todas as ISRs que registram devem
+rodar no mesmo core com a mesma prioridade, para não se interromperem.
+*/
+
+#define ISR_LOG_SIZE 32  // Potência de 2
+
+typedef struct {
+    uint32_t time_us;  // Instante da gravação, em µs desde a partida
+    uint16_t id;       // Mensagem, definida pelo chamador
+    uint16_t arg;
+} isr_log_entry_t;
+
+typedef struct {
+    isr_log_entry_t items[ISR_LOG_SIZE];
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    _Atomic uint32_t dropped;  // Registros descartados com a fila cheia
+} isr_log_t;
+
+void isr_log_init(isr_log_t *log);
+bool isr_log_pop(isr_log_t *log, isr_log_entry_t *entry);
+uint32_t isr_log_dropped(const isr_log_t *log);
+
+// Lado do produtor (ISR). Nunca bloqueia.
+static inline bool isr_log_push(isr_log_t *log, uint32_t time_us, uint16_t id, uint16_t arg) {
+    uint32_t head = atomic_load_explicit(&log->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&log->tail, memory_order_acquire);
+    if (head - tail >= ISR_LOG_SIZE) {
+        uint32_t dropped = atomic_load_explicit(&log->dropped, memory_order_relaxed);
+        atomic_store_explicit(&log->dropped, dropped + 1, memory_order_relaxed);
+        return false;
+    }
+
+    isr_log_entry_t *entry = &log->items[head & (ISR_LOG_SIZE - 1)];
+    entry->time_us = time_us;
+    entry->id = id;
+    entry->arg = arg;
+    atomic_store_explicit(&log->head, head + 1, memory_order_release);
+    return true;
+}
+
+#endif
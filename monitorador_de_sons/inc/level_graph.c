@@ -0,0 +1,83 @@
+#include "level_graph.h"
+
+#define GRAPH_ROWS 64
+#define TICK_DB_X10 100  // Marcas do eixo a cada 10 dB
+
+// Linha correspondente ao nível, arredondada e recortada à área
+static uint8_t level_row(const level_graph_t *graph, int32_t level) {
+    int32_t span = graph->max_db_x10 - graph->min_db_x10;
+    int32_t offset = level - graph->min_db_x10;
+    if (offset <= 0) return GRAPH_ROWS - 1;
+    if (offset >= span) return 0;
+    return (uint8_t)(GRAPH_ROWS - 1 - (offset * (GRAPH_ROWS - 1) + span / 2) / span);
+}
+
+// Barra do nível até a base, com o ponto do limiar invertido nas colunas pares
+static void draw_column(const level_graph_t *graph, ssd1306_t *ssd, uint8_t i) {
+    uint32_t rows0 = 0, rows1 = 0;
+    int16_t level = graph->levels[i];
+    if (level != LEVEL_GRAPH_EMPTY && level >= graph->min_db_x10) {
+        uint8_t top = level_row(graph, level);
+        rows0 = top < 32 ? 0xFFFFFFFFu << top : 0;
+        rows1 = top <= 32 ? 0xFFFFFFFFu : 0xFFFFFFFFu << (top - 32);
+    }
+    uint8_t x = graph->x0 + i;
+    if (!(x & 1)) {
+        if (graph->threshold_row < 32) rows0 ^= 1u << graph->threshold_row;
+        else rows1 ^= 1u << (graph->threshold_row - 32);
+    }
+    ssd1306_column(ssd, x, rows0, rows1);
+}
+
+// Dois dígitos centrados na linha; ssd1306_draw_string pararia antes da última linha de texto
+static void draw_label(ssd1306_t *ssd, int32_t db, uint8_t row) {
+    int32_t y = row - 3;
+    if (y < 0) y = 0;
+    if (y > GRAPH_ROWS - 8) y = GRAPH_ROWS - 8;
+    ssd1306_draw_char(ssd, (char)('0' + db / 10 % 10), 0, (uint8_t)y);
+    ssd1306_draw_char(ssd, (char)('0' + db % 10), 8, (uint8_t)y);
+}
+
+// A faixa deve caber em dois dígitos (até 99 dB) e x0 deixar espaço para os
+// rótulos (16 colunas) e as marcas do eixo
+void level_graph_init(level_graph_t *graph, uint8_t x0, uint8_t width, int16_t min_db_x10, int16_t max_db_x10,
+                      int16_t threshold_db_x10) {
+    if (width > LEVEL_GRAPH_MAX_COLUMNS) width = LEVEL_GRAPH_MAX_COLUMNS;
+    graph->x0 = x0;
+    graph->width = width;
+    graph->head = 0;
+    graph->min_db_x10 = min_db_x10;
+    graph->max_db_x10 = max_db_x10;
+    graph->threshold_row = level_row(graph, threshold_db_x10);
+    for (uint8_t i = 0; i < width; i++) graph->levels[i] = LEVEL_GRAPH_EMPTY;
+}
+
+// Grava o nível na coluna atual e avança o cursor. Com `ssd` NULL só a RAM do
+// gráfico é atualizada (o display mostra outra tela).
+void level_graph_push(level_graph_t *graph, ssd1306_t *ssd, int16_t level_db_x10) {
+    uint8_t i = graph->head;
+    graph->levels[i] = level_db_x10;
+    graph->head = i + 1 < graph->width ? i + 1 : 0;
+    if (!ssd) return;
+    draw_column(graph, ssd, i);
+    ssd1306_column(ssd, graph->x0 + graph->head, 0, 0);
+}
+
+void level_graph_draw(const level_graph_t *graph, ssd1306_t *ssd) {
+    ssd1306_fill(ssd, false);
+    uint8_t axis = graph->x0 - 1;
+    ssd1306_vline(ssd, axis, 0, GRAPH_ROWS - 1, true);
+
+    int32_t first = (graph->min_db_x10 + TICK_DB_X10 - 1) / TICK_DB_X10 * TICK_DB_X10;
+    for (int32_t db = first; db <= graph->max_db_x10; db += TICK_DB_X10) {
+        ssd1306_hline(ssd, axis - 2, axis, level_row(graph, db), true);
+    }
+    int32_t middle = (graph->min_db_x10 + graph->max_db_x10) / 2 / TICK_DB_X10 * TICK_DB_X10;
+    draw_label(ssd, graph->max_db_x10 / 10, 0);
+    draw_label(ssd, middle / 10, level_row(graph, middle));
+    draw_label(ssd, graph->min_db_x10 / 10, GRAPH_ROWS - 1);
+
+    for (uint8_t i = 0; i < graph->width; i++) {
+        if (i != graph->head) draw_column(graph, ssd, i);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef LEVEL_GRAPH_H
+#define LEVEL_GRAPH_H
+
+#include <stdint.h>
+#include "ssd1306.h"
+
+/*
+Gráfico do histórico de nível no display, com uma coluna por intervalo.
+
+O gráfico varre a tela como um osciloscópio: cada nível novo é gravado na
+coluna `head` e a seguinte é apagada como cursor, então as colunas antigas não
+são deslocadas e cada atualização altera só duas colunas vizinhas, que o
+ssd1306 envia em uma única janela (~26 bytes de I2C em vez de ~1 kB do quadro).
+O controlador não tem rolagem horizontal de passo único utilizável com escrita
+na RAM (a rolagem contínua corrompe o que é escrito durante ela), por isso o
+anel fica no índice da coluna e não no hardware.
+
+Os níveis ficam também em RAM, na posição da tela, para que o quadro inteiro
+(eixo em dB com rótulos, marcas a cada 10 dB, linha pontilhada do limiar e todas
+as colunas) possa ser redesenhado depois que outra tela ocupou o display.
+*/
+
+#define LEVEL_GRAPH_MAX_COLUMNS 128
+#define LEVEL_GRAPH_EMPTY INT16_MIN  // Coluna ainda sem nível
+
+typedef struct {
+    int16_t levels[LEVEL_GRAPH_MAX_COLUMNS];  // dB x10 de cada coluna da área do gráfico
+    uint8_t head;             // Próxima coluna, relativa a x0
+    uint8_t x0, width;        // Área do gráfico; à esquerda de x0 ficam o eixo e os rótulos
+    int16_t min_db_x10, max_db_x10;  // Nível na última e na primeira linha
+    uint8_t threshold_row;    // Linha da marca do limiar de alerta
+} level_graph_t;
+
+void level_graph_init(level_graph_t *graph, uint8_t x0, uint8_t width, int16_t min_db_x10, int16_t max_db_x10,
+                      int16_t threshold_db_x10);
+void level_graph_push(level_graph_t *graph, ssd1306_t *ssd, int16_t level_db_x10);
+void level_graph_draw(const level_graph_t *graph, ssd1306_t *ssd);
+
+#endif
@@ -0,0 +1,63 @@
+#include <math.h>
+#include "level_stats.h"
+
+void level_stats_reset(level_stats_t *stats) {
+    for (uint16_t i = 0; i < LEVEL_STATS_BINS; i++) stats->histogram[i] = 0;
+    stats->blocks = 0;
+    stats->samples = 0;
+    stats->amplitude_sum = 0;
+    stats->square_sum = 0;
+    stats->peak_max = 0;
+    stats->loud_blocks = 0;
+    stats->loud_peak_sum = 0;
+}
+
+void level_stats_add_block(level_stats_t *stats, int32_t level_db_x10, uint32_t amplitude_sum, uint64_t square_sum,
+                           uint32_t samples, uint16_t peak, bool loud) {
+    int32_t bin = (level_db_x10 - LEVEL_STATS_MIN_DB_X10) / LEVEL_STATS_BIN_DB_X10;
+    if (bin < 0) bin = 0;
+    if (bin >= LEVEL_STATS_BINS) bin = LEVEL_STATS_BINS - 1;
+    stats->histogram[bin]++;
+    stats->blocks++;
+
+    stats->samples += samples;
+    stats->amplitude_sum += amplitude_sum;
+    stats->square_sum += square_sum;
+    if (peak > stats->peak_max) stats->peak_max = peak;
+    if (loud) {
+        stats->loud_blocks++;
+        stats->loud_peak_sum += peak;
+    }
+}
+
+// Nível excedido em `percent`% dos blocos (L10: percent = 10). Percorre o
+// histograma do topo para baixo e interpola linearmente dentro da faixa.
+int32_t level_stats_exceeded_db_x10(const level_stats_t *stats, uint8_t percent) {
+    if (stats->blocks == 0) return LEVEL_STATS_MIN_DB_X10;
+
+    // Posição em centésimos de bloco, para não perder resolução em janelas curtas
+    uint64_t target = (uint64_t)stats->blocks * percent;
+    uint64_t above = 0;
+    for (int32_t bin = LEVEL_STATS_BINS - 1; bin >= 0; bin--) {
+        uint64_t count = (uint64_t)stats->histogram[bin] * 100;
+        if (count == 0) continue;
+        if (above + count >= target) {
+            int32_t top = LEVEL_STATS_MIN_DB_X10 + (bin + 1) * LEVEL_STATS_BIN_DB_X10;
+            return top - (int32_t)(((target - above) * LEVEL_STATS_BIN_DB_X10) / count);
+        }
+        above += count;
+    }
+    return LEVEL_STATS_MIN_DB_X10;
+}
+
+uint32_t level_stats_mean_amplitude(const level_stats_t *stats) {
+    return stats->samples ? (uint32_t)(stats->amplitude_sum / stats->samples) : 0;
+}
+
+uint32_t level_stats_rms_amplitude(const level_stats_t *stats) {
+    return stats->samples ? (uint32_t)lround(sqrt((double)stats->square_sum / stats->samples)) : 0;
+}
+
+uint32_t level_stats_mean_loud_peak(const level_stats_t *stats) {
+    return stats->loud_blocks ? (uint32_t)(stats->loud_peak_sum / stats->loud_blocks) : 0;
+}
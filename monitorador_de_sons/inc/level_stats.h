@@ -0,0 +1,43 @@
+#ifndef LEVEL_STATS_H
+#define LEVEL_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Estatísticas de uma janela de relatório com memória constante.
+
+Cada bloco analisado entra com seu nível em décimos de dB em um histograma de
+faixas de 0,5 dB (espaçadas logaritmicamente em amplitude), de onde saem os
+níveis de excedência L10, L50 e L90: o nível ultrapassado em 10%, 50% e 90%
+dos blocos da janela. Níveis fora da faixa coberta caem nas faixas extremas.
+
+A soma dos quadrados das amplitudes dá a amplitude RMS da janela, sem
+ponderação. Somas usam 64 bits, e as médias retornam 0 em janelas vazias em vez de
+dividir por zero. A inserção é O(1), só somas e um incremento.
+*/
+
+#define LEVEL_STATS_MIN_DB_X10 200  // Limite inferior da primeira faixa
+#define LEVEL_STATS_BIN_DB_X10 5    // Largura de cada faixa
+#define LEVEL_STATS_BINS 200        // Cobre 20 a 120 dB
+
+typedef struct {
+    uint32_t histogram[LEVEL_STATS_BINS];
+    uint32_t blocks;
+    uint64_t samples;
+    uint64_t amplitude_sum;   // Soma de |x - silêncio| de todas as amostras
+    uint64_t square_sum;      // Soma dos quadrados dessas amplitudes
+    uint16_t peak_max;
+    uint32_t loud_blocks;     // Blocos com pico acima do limiar do chamador
+    uint64_t loud_peak_sum;
+} level_stats_t;
+
+void level_stats_reset(level_stats_t *stats);
+void level_stats_add_block(level_stats_t *stats, int32_t level_db_x10, uint32_t amplitude_sum, uint64_t square_sum,
+                           uint32_t samples, uint16_t peak, bool loud);
+int32_t level_stats_exceeded_db_x10(const level_stats_t *stats, uint8_t percent);
+uint32_t level_stats_mean_amplitude(const level_stats_t *stats);
+uint32_t level_stats_rms_amplitude(const level_stats_t *stats);
+uint32_t level_stats_mean_loud_peak(const level_stats_t *stats);
+
+#endif
@@ -0,0 +1,141 @@
+#include <math.h>
+#include "metering.h"
+
+#define COEF_SHIFT 28
+#define TAU_FAST_MS 125
+#define TAU_SLOW_MS 1000
+
+// Polos do filtro de ponderação A (IEC 61672), em Hz
+#define A_F1 20.598997
+#define A_F2 107.65265
+#define A_F3 737.86223
+#define A_F4 12194.217
+
+// log2(1 + i/32) em Q16, para interpolação linear
+static const uint16_t log2_table[33] = {
+    0, 2909, 5732, 8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711,
+    27936, 30109, 32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904,
+    47705, 49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534,
+    64047, 65535
+};
+
+// Projeta uma seção s^2/((s+a)(s+b)) (highpass) ou 1/((s+a)(s+b)) (lowpass) pela
+// transformação bilinear e normaliza o ganho em 1 kHz. Só roda na inicialização.
+static void design_section(biquad_t *bq, double fs, double fa, double fb, bool highpass) {
+    double k = 2.0 * fs;
+    double a = 2.0 * M_PI * fa, b = 2.0 * M_PI * fb;
+    double d0 = (k + a) * (k + b);
+    double d1 = ((k + a) * (b - k) + (a - k) * (k + b)) / d0;
+    double d2 = ((a - k) * (b - k)) / d0;
+    double n0 = 1.0, n1 = highpass ? -2.0 : 2.0, n2 = 1.0;
+
+    double w = 2.0 * M_PI * 1000.0 / fs;
+    double nr = n0 + n1 * cos(w) + n2 * cos(2 * w), ni = -(n1 * sin(w) + n2 * sin(2 * w));
+    double dr = 1.0 + d1 * cos(w) + d2 * cos(2 * w), di = -(d1 * sin(w) + d2 * sin(2 * w));
+    double g = sqrt((dr * dr + di * di) / (nr * nr + ni * ni));
+
+    double scale = (double)(1L << COEF_SHIFT);
+    bq->b0 = (int32_t)lround(g * n0 * scale);
+    bq->b1 = (int32_t)lround(g * n1 * scale);
+    bq->b2 = (int32_t)lround(g * n2 * scale);
+    bq->a1 = (int32_t)lround(d1 * scale);
+    bq->a2 = (int32_t)lround(d2 * scale);
+    bq->x1 = bq->x2 = bq->y1 = bq->y2 = 0;
+}
+
+static inline int32_t biquad_step(biquad_t *bq, int32_t x) {
+    int64_t acc = (int64_t)bq->b0 * x + (int64_t)bq->b1 * bq->x1 + (int64_t)bq->b2 * bq->x2
+                - (int64_t)bq->a1 * bq->y1 - (int64_t)bq->a2 * bq->y2;
+    int32_t y = (int32_t)((acc + (1 << (COEF_SHIFT - 1))) >> COEF_SHIFT);
+    bq->x2 = bq->x1; bq->x1 = x;
+    bq->y2 = bq->y1; bq->y1 = y;
+    return y;
+}
+
+static uint32_t ema_alpha_q16(uint32_t sample_rate_hz, uint32_t block_len, uint32_t tau_ms) {
+    uint64_t alpha = ((uint64_t)block_len * 65536u * 1000u) / ((uint64_t)sample_rate_hz * tau_ms);
+    return alpha > 65536u ? 65536u : (uint32_t)alpha;
+}
+
+static inline uint64_t ema_update(uint64_t avg, uint64_t value, uint32_t alpha_q16) {
+    return (uint64_t)((int64_t)avg + (((int64_t)value - (int64_t)avg) * alpha_q16) / 65536);
+}
+
+// log2(x) em Q16
+static int32_t log2_q16(uint64_t x) {
+    if (x == 0) x = 1;
+    int msb = 63 - __builtin_clzll(x);
+    uint32_t norm = msb >= 16 ? (uint32_t)(x >> (msb - 16)) : (uint32_t)(x << (16 - msb));
+    uint32_t frac = norm - 65536u;
+    uint32_t idx = frac >> 11, rem = frac & 0x7FF;
+    int32_t interp = log2_table[idx] + (((log2_table[idx + 1] - log2_table[idx]) * rem) >> 11);
+    return (msb << 16) + interp;
+}
+
+void metering_init(meter_t *meter, uint32_t sample_rate_hz, uint32_t block_len, int32_t offset, uint8_t sample_shift, int32_t cal_db_x10) {
+    double fs = sample_rate_hz;
+    design_section(&meter->sections[0], fs, A_F1, A_F1, true);
+    design_section(&meter->sections[1], fs, A_F2, A_F3, true);
+    design_section(&meter->sections[2], fs, A_F4, A_F4, false);
+
+    meter->offset = offset;
+    meter->input_shift = sample_shift < METERING_INPUT_SHIFT ? METERING_INPUT_SHIFT - sample_shift : 0;
+    meter->cal_db_x10 = cal_db_x10;
+    meter->alpha_fast_q16 = ema_alpha_q16(sample_rate_hz, block_len, TAU_FAST_MS);
+    meter->alpha_slow_q16 = ema_alpha_q16(sample_rate_hz, block_len, TAU_SLOW_MS);
+    meter->block_ms = meter->fast_ms = meter->slow_ms = 0;
+    metering_reset_window(meter);
+}
+
+void metering_process_block(meter_t *meter, const volatile uint16_t *samples, uint32_t len) {
+    if (len == 0) return;
+
+    uint64_t sum_sq = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        int32_t x = ((int32_t)samples[i] - meter->offset) * (1 << meter->input_shift);
+        for (uint8_t s = 0; s < METERING_SECTIONS; s++) {
+            x = biquad_step(&meter->sections[s], x);
+        }
+        sum_sq += (uint64_t)((int64_t)x * x);
+    }
+
+    meter->block_ms = sum_sq / len;
+    meter->fast_ms = ema_update(meter->fast_ms, meter->block_ms, meter->alpha_fast_q16);
+    meter->slow_ms = ema_update(meter->slow_ms, meter->block_ms, meter->alpha_slow_q16);
+    meter->leq_sum += sum_sq;
+    meter->leq_count += len;
+    if (meter->fast_ms > meter->fast_max_ms) meter->fast_max_ms = meter->fast_ms;
+}
+
+void metering_reset_window(meter_t *meter) {
+    meter->leq_sum = 0;
+    meter->leq_count = 0;
+    meter->fast_max_ms = 0;
+}
+
+// 10*log10(power) em décimos de dB, sem escala nem calibração
+int32_t metering_power_db_x10(uint64_t power) {
+    return (int32_t)(((int64_t)log2_q16(power) * 30103) / (65536 * 1000));
+}
+
+// Nível em décimos de dB, já descontando a escala de entrada e somando a calibração
+int32_t metering_db_x10(const meter_t *meter, uint64_t mean_square) {
+    return metering_power_db_x10(mean_square) - METERING_INPUT_SCALE_DB_X10 + meter->cal_db_x10;
+}
+
+int32_t metering_laf_db_x10(const meter_t *meter) {
+    return metering_db_x10(meter, meter->fast_ms);
+}
+
+int32_t metering_las_db_x10(const meter_t *meter) {
+    return metering_db_x10(meter, meter->slow_ms);
+}
+
+int32_t metering_laeq_db_x10(const meter_t *meter) {
+    if (meter->leq_count == 0) return metering_db_x10(meter, 0);
+    return metering_db_x10(meter, meter->leq_sum / meter->leq_count);
+}
+
+int32_t metering_lafmax_db_x10(const meter_t *meter) {
+    return metering_db_x10(meter, meter->fast_max_ms);
+}
@@ -0,0 +1,60 @@
+#ifndef METERING_H
+#define METERING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Medidor de nível sonoro em ponto fixo, executado a cada bloco do DMA.
+
+- Ponderação A por uma cascata de 3 biquads (coeficientes Q28, estado int32,
+  acumulador de 64 bits). Os coeficientes são calculados uma única vez na
+  inicialização por transformação bilinear do filtro analógico da IEC 61672;
+  o processamento por amostra é só aritmética inteira.
+- Médias quadráticas com ponderação temporal Fast (125 ms) e Slow (1 s),
+  atualizadas por bloco, e soma de quadrados de 64 bits para o LAeq da janela.
+
+As amostras podem vir do ADC (12 bits) ou do decimador, já com `sample_shift`
+bits fracionários; o filtro sempre trabalha com METERING_INPUT_SHIFT.
+
+Todos os níveis são devolvidos em décimos de dB. O dB "SPL" é o nível em
+relação a 1 LSB RMS somado a `cal_db_x10`, que deve ser ajustado com um
+decibelímetro de referência.
+*/
+
+#define METERING_SECTIONS 3
+#define METERING_INPUT_SHIFT 4            // Bits fracionários do filtro em relação ao LSB do ADC
+#define METERING_INPUT_SCALE_DB_X10 241   // 20*log10(1 << METERING_INPUT_SHIFT)
+
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;  // Q28, a0 normalizado em 1
+    int32_t x1, x2, y1, y2;
+} biquad_t;
+
+typedef struct {
+    biquad_t sections[METERING_SECTIONS];
+    int32_t offset;          // Nível do ADC correspondente ao silêncio
+    uint8_t input_shift;     // Escala até METERING_INPUT_SHIFT bits fracionários
+    int32_t cal_db_x10;      // Calibração: dB SPL = dB(LSB) + cal
+    uint32_t alpha_fast_q16; // Coeficientes das médias exponenciais por bloco
+    uint32_t alpha_slow_q16;
+    uint64_t block_ms;       // Média quadrática do último bloco (LSB^2 << 8)
+    uint64_t fast_ms;
+    uint64_t slow_ms;
+    uint64_t leq_sum;        // Soma de quadrados da janela atual
+    uint32_t leq_count;
+    uint64_t fast_max_ms;    // Maior LAF da janela atual
+} meter_t;
+
+void metering_init(meter_t *meter, uint32_t sample_rate_hz, uint32_t block_len, int32_t offset, uint8_t sample_shift, int32_t cal_db_x10);
+void metering_process_block(meter_t *meter, const volatile uint16_t *samples, uint32_t len);
+void metering_reset_window(meter_t *meter);
+
+int32_t metering_power_db_x10(uint64_t power);
+int32_t metering_db_x10(const meter_t *meter, uint64_t mean_square);
+int32_t metering_laf_db_x10(const meter_t *meter);
+int32_t metering_las_db_x10(const meter_t *meter);
+int32_t metering_laeq_db_x10(const meter_t *meter);
+int32_t metering_lafmax_db_x10(const meter_t *meter);
+
+#endif
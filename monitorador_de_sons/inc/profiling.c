@@ -0,0 +1,129 @@
+#include "profiling.h"
+
+#if PROFILING_ENABLED
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+
+static const char *const stage_names[PROF_STAGE_COUNT] = {
+    "dma_irq", "analise", "leds", "display", "alerta", "telemetria", "relatorio", "classe"
+};
+
+// Cada etapa roda sempre no mesmo core e nunca se aninha consigo mesma, então
+// suas estatísticas têm um único escritor.
+static prof_stats_t stats[PROF_STAGE_COUNT];
+static prof_event_t trace[2][PROF_TRACE_SIZE];
+static _Atomic uint32_t trace_head[2];
+static volatile uint32_t adc_overruns = 0;
+
+// SysTick é por core: precisa ser ligado em cada um
+void profiling_init(void) {
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;  // Habilita, fonte = clk_sys, sem interrupção
+}
+
+void profiling_reset(void) {
+    for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++) {
+        stats[i].count = 0;
+        stats[i].total_cycles = 0;
+        stats[i].min_cycles = UINT32_MAX;
+        stats[i].max_cycles = 0;
+        for (uint16_t b = 0; b < PROF_HIST_BUCKETS; b++) stats[i].histogram[b] = 0;
+    }
+    adc_overruns = 0;
+}
+
+// Faixa do histograma: oitava do valor + PROF_HIST_SUB_BITS bits seguintes
+static uint16_t hist_bucket(uint32_t cycles) {
+    if (cycles < (1u << PROF_HIST_SUB_BITS)) return cycles;
+    uint8_t msb = 31 - __builtin_clz(cycles);
+    uint32_t sub = (cycles >> (msb - PROF_HIST_SUB_BITS)) & ((1u << PROF_HIST_SUB_BITS) - 1);
+    return ((msb - PROF_HIST_SUB_BITS + 1) << PROF_HIST_SUB_BITS) + sub;
+}
+
+// Menor valor que cai acima da faixa (limite superior usado no p99)
+static uint32_t hist_upper(uint16_t bucket) {
+    if (bucket < (1u << PROF_HIST_SUB_BITS)) return bucket + 1;
+    uint8_t msb = (bucket >> PROF_HIST_SUB_BITS) + PROF_HIST_SUB_BITS - 1;
+    uint32_t sub = bucket & ((1u << PROF_HIST_SUB_BITS) - 1);
+    return ((1u << PROF_HIST_SUB_BITS) + sub + 1) << (msb - PROF_HIST_SUB_BITS);
+}
+
+void profiling_record(prof_stage_t stage, uint32_t start) {
+    uint32_t cycles = (start - profiling_now()) & 0x00FFFFFF;
+    prof_stats_t *s = &stats[stage];
+    s->count++;
+    s->total_cycles += cycles;
+    if (cycles < s->min_cycles) s->min_cycles = cycles;
+    if (cycles > s->max_cycles) s->max_cycles = cycles;
+    s->histogram[hist_bucket(cycles)]++;
+
+    // O anel do core é compartilhado entre tarefas e ISRs desse core
+    uint core = get_core_num();
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t head = atomic_load_explicit(&trace_head[core], memory_order_relaxed);
+    prof_event_t *event = &trace[core][head & (PROF_TRACE_SIZE - 1)];
+    event->timestamp_us = time_us_32();
+    event->cycles = cycles;
+    event->stage = stage;
+    atomic_store_explicit(&trace_head[core], head + 1, memory_order_release);
+    restore_interrupts(irq_state);
+}
+
+void profiling_count_adc_overrun(void) {
+    adc_overruns++;
+}
+
+static uint32_t percentile_cycles(const prof_stats_t *s, uint8_t percent) {
+    uint64_t target = ((uint64_t)s->count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint16_t b = 0; b < PROF_HIST_BUCKETS; b++) {
+        seen += s->histogram[b];
+        if (seen >= target) {
+            uint32_t upper = hist_upper(b);
+            return upper < s->max_cycles ? upper : s->max_cycles;
+        }
+    }
+    return s->max_cycles;
+}
+
+// Tempos em us com uma casa decimal
+static void print_us(uint32_t cycles, uint32_t cycles_per_us) {
+    uint32_t tenths = (uint32_t)(((uint64_t)cycles * 10) / cycles_per_us);
+    printf(" %6u.%u", (uint)(tenths / 10), (uint)(tenths % 10));
+}
+
+void profiling_dump(void) {
+    uint32_t cycles_per_us = clock_get_hz(clk_sys) / 1000000;
+    printf("\n-- PERFIL (us) --\n");
+    printf("%-11s %8s %8s %8s %8s %8s\n", "etapa", "n", "min", "media", "max", "p99");
+    for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++) {
+        const prof_stats_t *s = &stats[i];
+        if (s->count == 0) continue;
+        printf("%-11s %8u", stage_names[i], (uint)s->count);
+        print_us(s->min_cycles, cycles_per_us);
+        print_us((uint32_t)(s->total_cycles / s->count), cycles_per_us);
+        print_us(s->max_cycles, cycles_per_us);
+        print_us(percentile_cycles(s, 99), cycles_per_us);
+        printf("\n");
+    }
+    printf("Overruns do FIFO do ADC -- %u\n", (uint)adc_overruns);
+
+    for (uint8_t core = 0; core < 2; core++) {
+        uint32_t head = atomic_load_explicit(&trace_head[core], memory_order_acquire);
+        uint32_t n = head < PROF_TRACE_SIZE ? head : PROF_TRACE_SIZE;
+        printf("Últimos %u eventos do core %u:\n", (uint)n, core);
+        for (uint32_t k = head - n; k != head; k++) {
+            const prof_event_t *e = &trace[core][k & (PROF_TRACE_SIZE - 1)];
+            printf("  %10u %-11s", (uint)e->timestamp_us, stage_names[e->stage]);
+            print_us(e->cycles, cycles_per_us);
+            printf("\n");
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Medição de tempo das etapas do firmware (ISR, análise, LEDs, display...).
+
+PROF_BEGIN/PROF_END marcam entrada e saída de uma etapa com o contador do
+SysTick do core atual (ciclos de clk_sys, 24 bits, até ~134 ms a 125 MHz). Cada
+etapa acumula contagem, mínimo, média, máximo e um histograma logarítmico de
+onde sai o p99; cada core tem também um anel com os últimos eventos.
+
+Só existe com PROFILING_ENABLED=1 (builds Debug ou -DMONITOR_PROFILING=ON). Sem
+ele as macros somem e nada deste módulo é compilado no firmware.
+*/
+
+#ifndef PROFILING_ENABLED
+#define PROFILING_ENABLED 0
+#endif
+
+typedef enum {
+    PROF_STAGE_DMA_IRQ,
+    PROF_STAGE_ANALYSIS,
+    PROF_STAGE_LEDS,
+    PROF_STAGE_DISPLAY,
+    PROF_STAGE_ALERT,
+    PROF_STAGE_TELEMETRY,
+    PROF_STAGE_REPORT,
+    PROF_STAGE_CLASSIFY,
+    PROF_STAGE_COUNT
+} prof_stage_t;
+
+#if PROFILING_ENABLED
+
+#include "hardware/structs/systick.h"
+
+#define PROF_TRACE_SIZE 64     // Eventos por core (potência de 2)
+#define PROF_HIST_SUB_BITS 2   // Subdivisões por oitava no histograma
+#define PROF_HIST_BUCKETS (23 << PROF_HIST_SUB_BITS)  // Cobre os 24 bits do SysTick
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_cycles, max_cycles;
+    uint64_t total_cycles;
+    uint32_t histogram[PROF_HIST_BUCKETS];
+} prof_stats_t;
+
+typedef struct {
+    uint32_t timestamp_us;  // Saída da etapa
+    uint32_t cycles;
+    uint8_t stage;
+} prof_event_t;
+
+void profiling_init(void);
+void profiling_record(prof_stage_t stage, uint32_t start);
+void profiling_count_adc_overrun(void);
+void profiling_reset(void);
+void profiling_dump(void);
+
+// O SysTick conta para baixo
+static inline uint32_t profiling_now(void) {
+    return systick_hw->cvr;
+}
+
+#define PROF_BEGIN(stage) uint32_t prof_start_##stage = profiling_now()
+#define PROF_END(stage) profiling_record(stage, prof_start_##stage)
+
+#else
+
+#define PROF_BEGIN(stage) ((void)0)
+#define PROF_END(stage) ((void)0)
+
+#endif
+
+#endif
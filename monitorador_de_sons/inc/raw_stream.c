@@ -0,0 +1,105 @@
+#include "raw_stream.h"
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+// Os campos fixos do cabeçalho são montados uma vez; por quadro só muda a sequência
+void raw_stream_init(raw_stream_t *rs, uint16_t *blocks, uint32_t rate_hz, uint16_t samples,
+                     uint8_t channels, uint8_t shift, uint16_t center) {
+    rs->blocks = blocks;
+    rs->block_samples = (uint32_t)samples * channels;
+    put_u32(&rs->header[0], RAW_STREAM_MAGIC);
+    put_u32(&rs->header[8], rate_hz);
+    put_u16(&rs->header[12], samples);
+    rs->header[14] = channels;
+    rs->header[15] = shift;
+    put_u16(&rs->header[16], center);
+    rs->header[18] = RAW_STREAM_VERSION;
+    rs->header[19] = 0;
+    atomic_store_explicit(&rs->head, 0, memory_order_relaxed);
+    raw_stream_start(rs);
+}
+
+// Bloco em que o produtor deve escrever o próximo resultado. Enquanto não for
+// publicado, chamadas seguintes devolvem o mesmo bloco.
+uint16_t *raw_stream_slot(raw_stream_t *rs) {
+    uint32_t head = atomic_load_explicit(&rs->head, memory_order_relaxed);
+    return rs->blocks + (head & (RAW_STREAM_BLOCKS - 1)) * rs->block_samples;
+}
+
+void raw_stream_publish(raw_stream_t *rs, uint32_t seq) {
+    uint32_t head = atomic_load_explicit(&rs->head, memory_order_relaxed);
+    rs->seqs[head & (RAW_STREAM_BLOCKS - 1)] = seq;
+    atomic_store_explicit(&rs->head, head + 1, memory_order_release);
+}
+
+// Começa pelo próximo bloco publicado, descartando o que já estava no anel
+void raw_stream_start(raw_stream_t *rs) {
+    rs->tail = atomic_load_explicit(&rs->head, memory_order_acquire);
+    rs->sent = 0;
+    rs->frames = rs->skipped = rs->overwritten = 0;
+}
+
+// Entrega quadros enquanto houver blocos publicados e a escrita aceitar bytes.
+// Retorna quantos bytes foram entregues nesta chamada.
+size_t raw_stream_service(raw_stream_t *rs, raw_stream_write_t write) {
+    uint32_t payload_len = rs->block_samples * 2;
+    uint32_t payload_end = RAW_STREAM_HEADER_LEN + payload_len;
+    uint32_t frame_len = payload_end + RAW_STREAM_TRAILER_LEN;
+    size_t total = 0;
+
+    while (true) {
+        uint32_t head = atomic_load_explicit(&rs->head, memory_order_acquire);
+        uint32_t slot = rs->tail & (RAW_STREAM_BLOCKS - 1);
+
+        if (rs->sent == 0) {
+            if (head == rs->tail) break;
+            // O bloco de índice head está sendo escrito; salta para o mais recente completo
+            if (head - rs->tail >= RAW_STREAM_BLOCKS) {
+                rs->skipped += head - 1 - rs->tail;
+                rs->tail = head - 1;
+                continue;
+            }
+            // seqs[slot] muda se o produtor alcançar o bloco: o quadro usa a do cabeçalho
+            rs->seq = rs->seqs[slot];
+            put_u32(&rs->header[4], rs->seq);
+        }
+
+        const uint8_t *data;
+        uint32_t len;
+        if (rs->sent < RAW_STREAM_HEADER_LEN) {
+            data = rs->header + rs->sent;
+            len = RAW_STREAM_HEADER_LEN - rs->sent;
+        } else if (rs->sent < payload_end) {
+            data = (const uint8_t *)(rs->blocks + slot * rs->block_samples) + (rs->sent - RAW_STREAM_HEADER_LEN);
+            len = payload_end - rs->sent;
+        } else {
+            // Todo o bloco já foi copiado pela escrita; se o produtor o alcançou
+            // nesse meio-tempo, o quadro é marcado como inválido
+            if (rs->sent == payload_end) {
+                put_u32(rs->trailer, head - rs->tail >= RAW_STREAM_BLOCKS ? ~rs->seq : rs->seq);
+            }
+            data = rs->trailer + (rs->sent - payload_end);
+            len = frame_len - rs->sent;
+        }
+
+        size_t accepted = write(data, len);
+        if (accepted == 0) break;
+        rs->sent += (uint32_t)accepted;
+        total += accepted;
+        if (rs->sent == frame_len) {
+            if (rs->trailer[0] != (uint8_t)rs->seq) rs->overwritten++;  // ~seq difere em todos os bytes
+            rs->sent = 0;
+            rs->tail++;
+            rs->frames++;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,71 @@
+#ifndef RAW_STREAM_H
+#define RAW_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/*
+Captura bruta: envia as amostras de cada bloco analisado, as mesmas que entram
+na medição, para gravação no computador (tools/raw_stream_wav.py). Com
+OVERSAMPLE_FACTOR 16 são a saída do decimador, 16 kS/s com 4 bits fracionários
+além dos 12 do ADC; com OVERSAMPLE_FACTOR 1, as leituras do ADC. O cabeçalho
+do quadro informa a taxa e os bits fracionários.
+
+A análise (produtor) escreve direto em um anel de RAW_STREAM_BLOCKS blocos,
+obtido com `raw_stream_slot`, e publica o bloco com `raw_stream_publish`; não
+há cópia entre a análise e o envio. O consumidor (`raw_stream_service`, no laço
+principal) entrega cada bloco à função de escrita em pedaços, conforme ela
+aceita, e retoma do mesmo byte na chamada seguinte. Cada bloco vira um quadro:
+
+    "MRAW" (4) | sequência (4) | taxa em Hz (4) | amostras por canal (2) |
+    canais (1) | bits fracionários (1) | nível do silêncio (2) | versão (1) |
+    reservado (1) | amostras uint16, um canal após o outro | sequência (4)
+
+Tudo em little-endian. A sequência é a do bloco de captura, então um salto
+entre quadros revela blocos perdidos. O anel não bloqueia o produtor: se o
+envio atrasar mais de RAW_STREAM_BLOCKS - 1 blocos, o consumidor salta para o
+mais recente, e se o bloco em envio for sobrescrito no meio do caminho o
+quadro sai com a sequência final invertida (~seq), para ser descartado.
+
+Um único produtor e um único consumidor; o produtor escreve só `head` e os
+blocos, o consumidor só o restante.
+*/
+
+#define RAW_STREAM_BLOCKS 8  // Potência de 2
+#define RAW_STREAM_MAGIC 0x5741524Du  // "MRAW"
+#define RAW_STREAM_VERSION 1
+#define RAW_STREAM_HEADER_LEN 20
+#define RAW_STREAM_TRAILER_LEN 4
+
+// Entrega até `len` bytes e retorna quantos aceitou (0: sem espaço agora)
+typedef size_t (*raw_stream_write_t)(const uint8_t *data, size_t len);
+
+typedef struct {
+    uint16_t *blocks;         // RAW_STREAM_BLOCKS * block_samples amostras, do chamador
+    uint32_t block_samples;   // channels * samples
+    uint32_t seqs[RAW_STREAM_BLOCKS];
+    _Atomic uint32_t head;    // Blocos publicados
+    uint32_t tail;            // Próximo bloco a enviar
+    uint32_t sent;            // Bytes do quadro atual já entregues
+    uint32_t seq;             // Sequência do quadro atual, fixada no cabeçalho
+    uint32_t frames;          // Quadros completos desde raw_stream_start
+    uint32_t skipped;         // Blocos pulados com o envio atrasado
+    uint32_t overwritten;     // Quadros sobrescritos durante o envio
+    uint8_t header[RAW_STREAM_HEADER_LEN];
+    uint8_t trailer[RAW_STREAM_TRAILER_LEN];
+} raw_stream_t;
+
+void raw_stream_init(raw_stream_t *rs, uint16_t *blocks, uint32_t rate_hz, uint16_t samples,
+                     uint8_t channels, uint8_t shift, uint16_t center);
+
+// Lado do produtor
+uint16_t *raw_stream_slot(raw_stream_t *rs);
+void raw_stream_publish(raw_stream_t *rs, uint32_t seq);
+
+// Lado do consumidor
+void raw_stream_start(raw_stream_t *rs);
+size_t raw_stream_service(raw_stream_t *rs, raw_stream_write_t write);
+
+#endif
@@ -0,0 +1,104 @@
+#include "scheduler.h"
+
+static inline bool time_reached(uint32_t now_ms, uint32_t due_ms) {
+    return (int32_t)(now_ms - due_ms) >= 0;
+}
+
+void sched_init(scheduler_t *sched) {
+    sched->count = 0;
+    sched->ready = 0;
+    sched->posted = 0;
+}
+
+// Registra uma tarefa, inicialmente sem prazo. Retorna o id ou -1 sem espaço.
+int sched_add(scheduler_t *sched, sched_fn_t fn, uint8_t priority) {
+    if (sched->count == SCHED_MAX_TASKS) return -1;
+    int id = sched->count++;
+    sched_task_t *task = &sched->tasks[id];
+    task->fn = fn;
+    task->priority = priority;
+    task->armed = false;
+    task->period_ms = 0;
+
+    // Inserção ordenada; empates mantêm a ordem de registro
+    uint8_t pos = id;
+    while (pos > 0 && sched->tasks[sched->order[pos - 1]].priority > priority) {
+        sched->order[pos] = sched->order[pos - 1];
+        pos--;
+    }
+    sched->order[pos] = id;
+    return id;
+}
+
+void sched_every(scheduler_t *sched, int id, uint32_t now_ms, uint32_t period_ms) {
+    sched_task_t *task = &sched->tasks[id];
+    task->period_ms = period_ms;
+    task->due_ms = now_ms + period_ms;
+    task->armed = true;
+}
+
+// Disparo único daqui a `delay_ms`. Um prazo já armado mais cedo é mantido.
+void sched_in(scheduler_t *sched, int id, uint32_t now_ms, uint32_t delay_ms) {
+    sched_task_t *task = &sched->tasks[id];
+    uint32_t due = now_ms + delay_ms;
+    if (task->armed && time_reached(due, task->due_ms)) return;
+    task->period_ms = 0;
+    task->due_ms = due;
+    task->armed = true;
+}
+
+void sched_cancel(scheduler_t *sched, int id) {
+    sched->tasks[id].armed = false;
+    sched->ready &= ~(1u << id);
+}
+
+// Só para ISRs do core que executa sched_run: o |= não é atômico em relação a elas.
+void sched_post(scheduler_t *sched, int id) {
+    sched->posted |= 1u << id;
+}
+
+uint32_t sched_take_posted(scheduler_t *sched) {
+    uint32_t posted = sched->posted;
+    sched->posted = 0;
+    return posted;
+}
+
+// Executa a tarefa pronta de maior prioridade. Retorna false se nenhuma estava pronta.
+bool sched_run(scheduler_t *sched, uint32_t posted, uint32_t now_ms) {
+    sched->ready |= posted;
+    for (uint8_t i = 0; i < sched->count; i++) {
+        uint8_t id = sched->order[i];
+        sched_task_t *task = &sched->tasks[id];
+        bool due = task->armed && time_reached(now_ms, task->due_ms);
+        if (!due && !(sched->ready & (1u << id))) continue;
+
+        sched->ready &= ~(1u << id);
+        if (due) {
+            if (task->period_ms == 0) {
+                task->armed = false;
+            } else {
+                task->due_ms += task->period_ms;
+                if (time_reached(now_ms, task->due_ms)) {
+                    task->due_ms += ((now_ms - task->due_ms) / task->period_ms + 1) * task->period_ms;
+                }
+            }
+        }
+        task->fn(now_ms);
+        return true;
+    }
+    return false;
+}
+
+// Menor prazo armado. Retorna false se nenhuma tarefa tem prazo.
+bool sched_next_due(const scheduler_t *sched, uint32_t *due_ms) {
+    bool found = false;
+    uint32_t best = 0;
+    for (uint8_t id = 0; id < sched->count; id++) {
+        const sched_task_t *task = &sched->tasks[id];
+        if (!task->armed) continue;
+        if (!found || (int32_t)(task->due_ms - best) < 0) best = task->due_ms;
+        found = true;
+    }
+    if (found) *due_ms = best;
+    return found;
+}
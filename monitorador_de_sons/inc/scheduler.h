@@ -0,0 +1,56 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Escalonador cooperativo sem tick para o laço principal.
+
+Cada tarefa tem uma prioridade fixa (0 é a mais alta) e pode ficar pronta de
+dois jeitos: por prazo (`sched_every`/`sched_in`, em ms) ou por evento
+(`sched_post`, chamado de uma ISR do mesmo core; no laço principal use
+`sched_in` com atraso 0). `sched_run` executa uma
+tarefa pronta por vez, sempre a de maior prioridade, e retorna false quando
+não há nada a fazer; então o chamador pode dormir até `sched_next_due`.
+
+Tarefas periódicas avançam o prazo em múltiplos exatos do período, sem
+acumular atraso; períodos inteiros perdidos são pulados, não executados em
+rajada.
+
+Não depende do hardware: o tempo é sempre passado pelo chamador. `posted` é o
+único campo escrito por ISRs; o chamador deve ler e limpar com
+`sched_take_posted` com as interrupções desligadas.
+*/
+
+#define SCHED_MAX_TASKS 8
+
+typedef void (*sched_fn_t)(uint32_t now_ms);
+
+typedef struct {
+    sched_fn_t fn;
+    uint8_t priority;
+    bool armed;          // Há um prazo pendente em due_ms
+    uint32_t due_ms;
+    uint32_t period_ms;  // 0: tarefa de disparo único
+} sched_task_t;
+
+typedef struct {
+    sched_task_t tasks[SCHED_MAX_TASKS];
+    uint8_t order[SCHED_MAX_TASKS];  // Índices das tarefas por prioridade
+    uint8_t count;
+    uint32_t ready;                  // Eventos já recolhidos, ainda não executados
+    volatile uint32_t posted;        // Eventos sinalizados pelas ISRs
+} scheduler_t;
+
+void sched_init(scheduler_t *sched);
+int sched_add(scheduler_t *sched, sched_fn_t fn, uint8_t priority);
+void sched_every(scheduler_t *sched, int id, uint32_t now_ms, uint32_t period_ms);
+void sched_in(scheduler_t *sched, int id, uint32_t now_ms, uint32_t delay_ms);
+void sched_cancel(scheduler_t *sched, int id);
+void sched_post(scheduler_t *sched, int id);
+uint32_t sched_take_posted(scheduler_t *sched);
+bool sched_run(scheduler_t *sched, uint32_t posted, uint32_t now_ms);
+bool sched_next_due(const scheduler_t *sched, uint32_t *due_ms);
+
+#endif
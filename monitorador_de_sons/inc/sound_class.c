@@ -0,0 +1,259 @@
+#include <math.h>
+#include "sound_class.h"
+
+// Razão de potência 10^(dB/10) em Q8; só na inicialização
+static uint32_t ratio_q8(int32_t db_x10) {
+    return (uint32_t)lround(256.0 * pow(10.0, db_x10 / 100.0));
+}
+
+// x >= ref * razão, sem estourar os 64 bits com referências altas
+static bool at_least_ratio(uint64_t x, uint64_t ref, uint32_t ratio_q8) {
+    if (ref > (UINT64_MAX >> 8) / ratio_q8) return false;
+    return x >= (ref * ratio_q8) >> 8;
+}
+
+void sound_class_init(sound_class_t *sc, const sound_class_config_t *config, uint32_t sample_rate_hz,
+                      uint32_t block_len, uint8_t sample_shift, int32_t cal_db_x10) {
+    sc->config = *config;
+    sc->sample_rate_hz = sample_rate_hz;
+    sc->block_us = (uint32_t)(((uint64_t)block_len * 1000000u) / sample_rate_hz);
+    uint32_t frame_blocks = (SOUND_CLASS_FRAME_MS * 1000u + sc->block_us / 2) / sc->block_us;
+    sc->frame_blocks = frame_blocks ? (uint16_t)frame_blocks : 1;
+    sc->hysteresis = SOUND_CLASS_ZCR_HYSTERESIS << sample_shift;
+
+    // Inverso de metering_db_x10: energia média por amostra na escala de block_ms
+    double active_ms = pow(10.0, (config->active_db_x10 - cal_db_x10 + METERING_INPUT_SCALE_DB_X10) / 100.0);
+    sc->active_ms = (uint64_t)active_ms;
+    sc->rise_q8 = ratio_q8(config->impulse_rise_db_x10);
+    sc->crest_sq_q8 = ratio_q8(config->impulse_crest_db_x10);
+    sc->decay_q8 = ratio_q8(config->impulse_decay_db_x10);
+    sc->impulses = 0;
+    sound_class_reset(sc);
+}
+
+// Esquece o histórico (ex.: ao retomar a captura); mantém a contagem de impulsos
+void sound_class_reset(sound_class_t *sc) {
+    sc->frame_energy = 0;
+    sc->frame_crossings = sc->frame_samples = 0;
+    sc->frame_fill = sc->frame_active = 0;
+    sc->above = false;
+    sc->head = sc->filled = sc->zcr_frames = 0;
+    sc->level_sum = 0;
+    sc->level_square_sum = 0;
+    sc->zcr_sum = 0;
+    sc->zcr_square_sum = 0;
+    for (uint8_t i = 0; i < SOUND_CLASS_ONSET_FRAMES; i++) sc->recent[i] = UINT64_MAX;
+    sc->recent_head = 0;
+    sc->impulse = SOUND_IMPULSE_NONE;
+    sc->label = sc->frame_label = SOUND_CLASS_QUIET;
+    sc->frame_level_db_x10 = 0;
+    sc->history_max_db_x10 = INT16_MIN;
+    sc->zcr_hz = 0;
+}
+
+// Cruzamentos do nível DC com histerese: ruído menor que a faixa não conta
+static uint32_t count_crossings(sound_class_t *sc, const volatile uint16_t *samples, uint32_t len, int32_t offset) {
+    int32_t low = offset - sc->hysteresis, high = offset + sc->hysteresis;
+    bool above = sc->above;
+    uint32_t crossings = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        int32_t x = samples[i];
+        if (above ? x < low : x > high) {
+            above = !above;
+            crossings++;
+        }
+    }
+    sc->above = above;
+    return crossings;
+}
+
+// Fundo antes de um ataque: o quadro mais baixo entre os últimos sem impulso
+static uint64_t background(const sound_class_t *sc) {
+    uint64_t low = sc->recent[0];
+    for (uint8_t i = 1; i < SOUND_CLASS_ONSET_FRAMES; i++) {
+        if (sc->recent[i] < low) low = sc->recent[i];
+    }
+    return low;
+}
+
+// Ataque: subida brusca sobre o fundo com crista alta (pico² x n >= crista² x soma dos quadrados)
+// e acima de tudo o que se ouviu no último segundo. A saturação do ADC achata a
+// crista, então um bloco saturado passa nesse teste.
+static bool is_onset(const sound_class_t *sc, uint64_t energy, const meter_t *meter, const block_stats_t *stats,
+                     uint32_t len) {
+    if (energy < sc->active_ms || !at_least_ratio(energy, background(sc), sc->rise_q8)) return false;
+    uint64_t peak_power = (uint64_t)stats->peak * stats->peak * len;
+    if (stats->peak < SOUND_CLASS_CLIP_PEAK && !at_least_ratio(peak_power, stats->square_sum, sc->crest_sq_q8)) {
+        return false;
+    }
+    // Só aqui o logaritmo: os testes acima descartam quase todos os blocos
+    return metering_db_x10(meter, energy) >= sc->history_max_db_x10 + sc->config.impulse_novelty_db_x10;
+}
+
+static void start_impulse(sound_class_t *sc, uint64_t energy) {
+    sc->impulse = SOUND_IMPULSE_CANDIDATE;
+    sc->impulse_peak = sc->impulse_low = energy;
+    sc->impulse_blocks = sc->impulse_near_blocks = 1;
+    sc->label = SOUND_CLASS_IMPULSE;
+}
+
+static void impulse_block(sound_class_t *sc, uint64_t energy, const meter_t *meter, const block_stats_t *stats,
+                          uint32_t len) {
+    switch (sc->impulse) {
+    case SOUND_IMPULSE_NONE:
+        if (is_onset(sc, energy, meter, stats, len)) start_impulse(sc, energy);
+        break;
+
+    case SOUND_IMPULSE_CANDIDATE:
+        sc->impulse_blocks++;
+        // Depois do ataque o nível só pode cair; subir mais 3 dB é uma sílaba ou um som crescendo
+        bool rising = sc->impulse_blocks * sc->block_us > sc->config.impulse_attack_ms * 1000u
+                      && energy >= sc->impulse_peak << 1;
+        if (energy > sc->impulse_peak) sc->impulse_peak = sc->impulse_low = energy;
+        // A menos de 6 dB do pico; no bloco saturado o nível real é desconhecido
+        if (energy >= sc->impulse_peak >> 2 && stats->peak < SOUND_CLASS_CLIP_PEAK) sc->impulse_near_blocks++;
+        // A cauda de uma batida só desce: subir 6 dB sobre o mínimo desde o pico
+        // é outra sílaba
+        bool rebound = energy >= sc->impulse_low << 2;
+        if (energy < sc->impulse_low) sc->impulse_low = energy;
+        bool decayed = at_least_ratio(sc->impulse_peak, energy, sc->decay_q8);
+        // Na reverberação o nível cai em dB a passo constante: de -6 dB até a
+        // queda leva ao menos metade do tempo perto do pico. Queda antes de
+        // `impulse_min_ms` (estalo, estouro de uma oclusiva) ou depois de um
+        // platô (sílaba que termina de uma vez) não é batida.
+        bool not_reverb = decayed && (sc->impulse_blocks * sc->block_us < sc->config.impulse_min_ms * 1000u
+                                      || 2 * sc->impulse_blocks < 3 * sc->impulse_near_blocks);
+        if (rising || rebound || not_reverb
+            || sc->impulse_near_blocks * sc->block_us > sc->config.impulse_sustain_ms * 1000u
+            || sc->impulse_blocks * sc->block_us > sc->config.impulse_max_ms * 1000u) {
+            // Som que se manteve: o próximo quadro decide entre fala e contínuo
+            sc->impulse = SOUND_IMPULSE_NONE;
+            sc->label = SOUND_CLASS_STEADY;
+        } else if (decayed) {
+            sc->impulse = SOUND_IMPULSE_TAIL;
+            sc->impulse_blocks = 0;
+            sc->impulses++;
+        }
+        break;
+
+    case SOUND_IMPULSE_TAIL:
+        sc->impulse_blocks++;
+        // Só um ataque tão forte quanto o anterior é outra batida; o resto é a reverberação
+        if (energy >= sc->impulse_peak && is_onset(sc, energy, meter, stats, len)) {
+            start_impulse(sc, energy);
+        } else {
+            // A cauda termina quando o LAF chega a 3 dB da energia atual (ou do fundo)
+            uint64_t floor = background(sc);
+            uint64_t current = energy > floor ? energy : floor;
+            if (meter->fast_ms < current << 1 || sc->impulse_blocks * sc->block_us > sc->config.tail_max_ms * 1000u) {
+                sc->impulse = SOUND_IMPULSE_NONE;
+                sc->label = sc->frame_label;
+            }
+        }
+        break;
+    }
+}
+
+// Pausas dentro da janela de uma conversa continuam sendo fala
+static sound_class_label_t decide(const sound_class_t *sc, bool active) {
+    sound_class_label_t otherwise = active ? SOUND_CLASS_STEADY : SOUND_CLASS_QUIET;
+    if (sc->filled < SOUND_CLASS_HISTORY / 2 || sc->zcr_frames < 2) return otherwise;
+
+    // Variâncias sem divisão: n² var = n Σx² - (Σx)²
+    int64_t n = sc->filled;
+    int64_t level_var_n2 = n * sc->level_square_sum - (int64_t)sc->level_sum * sc->level_sum;
+    int64_t min_std = sc->config.speech_min_std_db_x10;
+    if (level_var_n2 < min_std * min_std * n * n) return otherwise;
+
+    uint64_t z = sc->zcr_frames;
+    uint32_t zcr_mean = sc->zcr_sum / sc->zcr_frames;
+    if (zcr_mean < sc->config.speech_zcr_min_hz || zcr_mean > sc->config.speech_zcr_max_hz) return otherwise;
+    uint64_t zcr_var_n2 = z * sc->zcr_square_sum - (uint64_t)sc->zcr_sum * sc->zcr_sum;
+    uint64_t min_zcr_std = sc->config.speech_zcr_min_std_hz;
+    if (zcr_var_n2 < min_zcr_std * min_zcr_std * z * z) return otherwise;
+    return SOUND_CLASS_SPEECH;
+}
+
+// `level` entra nas estatísticas de modulação; `heard` é o nível real do quadro
+static void push_frame(sound_class_t *sc, int16_t level, int16_t heard, uint16_t zcr) {
+    if (sc->filled == SOUND_CLASS_HISTORY) {
+        int16_t old_level = sc->levels[sc->head];
+        uint16_t old_zcr = sc->zcrs[sc->head];
+        sc->level_sum -= old_level;
+        sc->level_square_sum -= (int32_t)old_level * old_level;
+        if (old_zcr) {
+            sc->zcr_sum -= old_zcr;
+            sc->zcr_square_sum -= (uint32_t)old_zcr * old_zcr;
+            sc->zcr_frames--;
+        }
+    } else {
+        sc->filled++;
+    }
+    sc->levels[sc->head] = level;
+    sc->heard[sc->head] = heard;
+    sc->zcrs[sc->head] = zcr;
+    sc->level_sum += level;
+    sc->level_square_sum += (int32_t)level * level;
+    if (zcr) {
+        sc->zcr_sum += zcr;
+        sc->zcr_square_sum += (uint32_t)zcr * zcr;
+        sc->zcr_frames++;
+    }
+    sc->head = (uint8_t)((sc->head + 1) % SOUND_CLASS_HISTORY);
+}
+
+static void close_frame(sound_class_t *sc, const meter_t *meter) {
+    uint64_t energy = sc->frame_energy / sc->frame_fill;
+    int32_t level = metering_db_x10(meter, energy);
+    bool active = energy >= sc->active_ms && sc->frame_samples > 0;
+    uint32_t zcr = active ? (uint32_t)(((uint64_t)sc->frame_crossings * sc->sample_rate_hz) / sc->frame_samples) : 0;
+    sc->frame_level_db_x10 = level;
+    sc->zcr_hz = zcr;
+
+    int32_t floor = sc->config.active_db_x10 - SOUND_CLASS_FLOOR_DB_X10;
+    int16_t heard = (int16_t)(level < floor ? floor : level);
+    if (sc->impulse == SOUND_IMPULSE_NONE) {
+        sc->recent[sc->recent_head] = energy;
+        sc->recent_head = (uint8_t)((sc->recent_head + 1) % SOUND_CLASS_ONSET_FRAMES);
+        // Só quadros ativos do início ao fim entram nos cruzamentos: no bloco em
+        // que um som começa ou acaba a taxa é a do ruído de fundo misturada à dele
+        bool whole = active && sc->frame_active == sc->frame_fill;
+        push_frame(sc, heard, heard, whole ? (uint16_t)(zcr ? (zcr < UINT16_MAX ? zcr : UINT16_MAX) : 1) : 0);
+    } else {
+        // Quadros do impulso repetem o anterior para não inflar a modulação
+        uint8_t last = (uint8_t)((sc->head + SOUND_CLASS_HISTORY - 1) % SOUND_CLASS_HISTORY);
+        push_frame(sc, sc->filled ? sc->levels[last] : (int16_t)floor, heard, 0);
+    }
+    // O impulso conta para o máximo: a fala que segue uma batida tem de superar
+    // o que já se ouviu para ser outro ataque
+    int16_t max = sc->heard[0];
+    for (uint8_t i = 1; i < sc->filled; i++) {
+        if (sc->heard[i] > max) max = sc->heard[i];
+    }
+    sc->history_max_db_x10 = max;
+
+    sc->frame_label = decide(sc, active);
+    if (sc->impulse == SOUND_IMPULSE_NONE) sc->label = sc->frame_label;
+    sc->frame_energy = 0;
+    sc->frame_crossings = sc->frame_samples = 0;
+    sc->frame_fill = sc->frame_active = 0;
+}
+
+// Processa um bloco já medido por `meter` (block_ms, fast_ms e offset do bloco)
+// e com as estatísticas de amplitude em `stats`. Retorna o rótulo do bloco.
+sound_class_label_t sound_class_process_block(sound_class_t *sc, const volatile uint16_t *samples, uint32_t len,
+                                              const meter_t *meter, const block_stats_t *stats) {
+    // Só blocos ativos entram na taxa de cruzamentos: bordas de um som não a diluem
+    uint32_t crossings = count_crossings(sc, samples, len, meter->offset);
+    if (meter->block_ms >= sc->active_ms) {
+        sc->frame_crossings += crossings;
+        sc->frame_samples += len;
+        sc->frame_active++;
+    }
+    sc->frame_energy += meter->block_ms;
+    sc->frame_fill++;
+
+    impulse_block(sc, meter->block_ms, meter, stats, len);
+    if (sc->frame_fill == sc->frame_blocks) close_frame(sc, meter);
+    return sc->label;
+}
@@ -0,0 +1,132 @@
+#ifndef SOUND_CLASS_H
+#define SOUND_CLASS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "metering.h"
+#include "block_stats.h"
+
+/*
+Classificador de eventos sonoros por bloco: silêncio, ruído contínuo, fala ou
+impulso (porta batendo, objeto caindo).
+
+Atributos, todos em inteiros a partir do que a análise já calcula:
+- taxa de cruzamentos por zero, contada com histerese em torno do nível DC (um
+  laço de comparações por amostra, o único trabalho novo por amostra);
+- fator de crista do bloco (pico² x n contra a soma dos quadrados de
+  block_stats), sem raiz nem divisão; separa ataques de tons, mas some quando
+  o ADC satura, então blocos saturados não são julgados por ele;
+- nível de cada quadro de SOUND_CLASS_FRAME_MS (média da energia ponderada A
+  dos blocos) e a variância desse nível em SOUND_CLASS_HISTORY quadros (1 s),
+  mantida com somas deslizantes.
+
+Modelo de decisão, com os limiares de sound_class_config_t:
+- Impulso: um bloco sobe `impulse_rise` acima do fundo (menor quadro recente)
+  e `impulse_novelty` acima do quadro mais alto do último segundo, com crista
+  alta; a segunda condição separa uma batida das plosivas de uma conversa.
+  Enquanto não se decide o bloco já é rotulado impulso; se o nível cai
+  `impulse_decay` dentro de `impulse_max_ms` sem ter ficado perto do pico por
+  mais de `impulse_sustain_ms`, o impulso é confirmado e o rótulo segue
+  enquanto o LAF ainda for dominado pela cauda dele (2x a energia atual).
+  A cauda da reverberação cai em dB a passo constante, sem voltar a subir: uma
+  queda antes de `impulse_min_ms` (estouro de uma oclusiva, estalo), depois de
+  um platô perto do pico (sílaba) ou com o nível subindo 6 dB sobre o mínimo
+  desde o pico (outra sílaba) não é batida. Senão, o som é reclassificado como
+  fala ou contínuo.
+- Fala: variância do nível dos quadros acima de `speech_min_std`² (a modulação
+  silábica, ~4 Hz, alterna vogais e pausas), cruzamentos por zero médios na
+  faixa da voz e variando entre quadros (vogais e consoantes), o que separa a
+  fala de um bipe ligando e desligando. Só quadros ativos do início ao fim
+  entram nos cruzamentos: nas bordas de um bipe a taxa é a do fundo misturada
+  à do tom e imitaria a variação da fala. Com isso o fluxo espectral não é
+  necessário (host/tests/test_sound_class.c separa as quatro classes sem ele).
+  Quadros de impulso ficam fora das estatísticas, mas contam para o máximo.
+- Contínuo: ativo sem modulação (ventilação, motor, tom).
+
+O rótulo muda por bloco no impulso e por quadro nos demais.
+*/
+
+#define SOUND_CLASS_FRAME_MS 25
+#define SOUND_CLASS_HISTORY 40       // Quadros nas estatísticas de modulação (1 s)
+#define SOUND_CLASS_ONSET_FRAMES 4   // Quadros que definem o fundo antes do ataque
+#define SOUND_CLASS_ZCR_HYSTERESIS 8 // LSB do ADC em torno do nível DC
+#define SOUND_CLASS_FLOOR_DB_X10 150 // Quadros abaixo de (ativo - piso) entram como o piso
+#define SOUND_CLASS_CLIP_PEAK 2000   // Pico (LSB) a partir do qual o bloco é tratado como saturado
+
+typedef enum {
+    SOUND_CLASS_QUIET,
+    SOUND_CLASS_STEADY,
+    SOUND_CLASS_SPEECH,
+    SOUND_CLASS_IMPULSE,
+    SOUND_CLASS_COUNT
+} sound_class_label_t;
+
+typedef struct {
+    int32_t active_db_x10;          // Nível de quadro mínimo para não ser silêncio
+    int32_t impulse_rise_db_x10;    // Subida do bloco em relação ao fundo
+    int32_t impulse_crest_db_x10;   // Fator de crista mínimo do bloco do ataque
+    int32_t impulse_novelty_db_x10; // Subida sobre o quadro mais alto do último segundo
+    int32_t impulse_decay_db_x10;   // Queda em relação ao pico que confirma o impulso
+    uint16_t impulse_attack_ms;     // Tempo até o pico; depois dele o nível não pode subir
+    uint16_t impulse_sustain_ms;    // Tempo máximo a menos de 6 dB do pico
+    uint16_t impulse_min_ms;        // Tempo mínimo até a queda (cauda da reverberação)
+    uint16_t impulse_max_ms;        // Tempo máximo até a queda
+    uint16_t tail_max_ms;           // Duração máxima do rótulo depois da confirmação
+    int32_t speech_min_std_db_x10;  // Desvio padrão mínimo do nível dos quadros
+    uint16_t speech_zcr_min_hz, speech_zcr_max_hz;  // Média dos cruzamentos por segundo
+    uint16_t speech_zcr_min_std_hz; // Desvio padrão mínimo dos cruzamentos
+} sound_class_config_t;
+
+typedef enum {
+    SOUND_IMPULSE_NONE,
+    SOUND_IMPULSE_CANDIDATE,
+    SOUND_IMPULSE_TAIL
+} sound_impulse_state_t;
+
+typedef struct {
+    sound_class_config_t config;
+    uint32_t sample_rate_hz;
+    uint32_t block_us;
+    uint16_t frame_blocks;
+    int32_t hysteresis;            // Em unidades das amostras (com os bits fracionários)
+    uint64_t active_ms;            // Limiares convertidos para a escala de meter_t.block_ms
+    uint32_t rise_q8, crest_sq_q8, decay_q8;
+
+    // Quadro em formação
+    uint64_t frame_energy;
+    uint32_t frame_crossings, frame_samples;  // Nos blocos ativos
+    uint16_t frame_fill, frame_active;
+    bool above;                    // Lado do nível DC em que o sinal está (histerese)
+
+    // Histórico de quadros
+    int16_t levels[SOUND_CLASS_HISTORY];
+    int16_t heard[SOUND_CLASS_HISTORY];  // Nível real, com os quadros de impulso
+    uint16_t zcrs[SOUND_CLASS_HISTORY];  // 0 nos quadros em silêncio
+    uint8_t head, filled, zcr_frames;
+    int32_t level_sum;
+    int64_t level_square_sum;
+    uint32_t zcr_sum;
+    uint64_t zcr_square_sum;
+    int16_t history_max_db_x10;    // Quadro mais alto do histórico (em heard)
+    uint64_t recent[SOUND_CLASS_ONSET_FRAMES];  // Energia dos últimos quadros sem impulso
+    uint8_t recent_head;
+
+    // Impulso
+    sound_impulse_state_t impulse;
+    uint64_t impulse_peak, impulse_low;  // Pico do impulso e menor energia desde ele
+    uint32_t impulse_blocks, impulse_near_blocks;
+
+    sound_class_label_t label;
+    sound_class_label_t frame_label;  // Última decisão por quadro, fora dos impulsos
+    int32_t frame_level_db_x10;       // Atributos do último quadro, para o relatório
+    uint32_t zcr_hz;
+    uint32_t impulses;                // Impulsos confirmados desde a inicialização
+} sound_class_t;
+
+void sound_class_init(sound_class_t *sc, const sound_class_config_t *config, uint32_t sample_rate_hz,
+                      uint32_t block_len, uint8_t sample_shift, int32_t cal_db_x10);
+sound_class_label_t sound_class_process_block(sound_class_t *sc, const volatile uint16_t *samples, uint32_t len,
+                                              const meter_t *meter, const block_stats_t *stats);
+void sound_class_reset(sound_class_t *sc);
+
+#endif
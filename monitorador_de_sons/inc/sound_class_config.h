@@ -0,0 +1,26 @@
+#ifndef SOUND_CLASS_CONFIG_H
+#define SOUND_CLASS_CONFIG_H
+
+#include "sound_class.h"
+
+// Limiares do classificador de eventos usados pelo firmware. Ajustados com os
+// trechos rotulados sintetizados de host/tests/test_sound_class.c (batidas de
+// porta, fala e ruídos contínuos), que incluem este mesmo arquivo.
+static const sound_class_config_t sound_class_config = {
+    .active_db_x10 = 500,
+    .impulse_rise_db_x10 = 150,
+    .impulse_crest_db_x10 = 60,      // Acima de um tom (3 dB), abaixo de ruído e fala (9 a 13 dB)
+    .impulse_novelty_db_x10 = 100,
+    .impulse_decay_db_x10 = 150,
+    .impulse_attack_ms = 10,
+    .impulse_sustain_ms = 80,        // Uma vogal fica mais tempo perto do pico
+    .impulse_min_ms = 30,            // Oclusivas caem em até 20 ms; batidas levam 40 ms ou mais
+    .impulse_max_ms = 300,
+    .tail_max_ms = 2000,
+    .speech_min_std_db_x10 = 50,
+    .speech_zcr_min_hz = 300,
+    .speech_zcr_max_hz = 6000,
+    .speech_zcr_min_std_hz = 150     // Bipes variam até ~90 Hz entre quadros; a fala, 250 Hz ou mais
+};
+
+#endif
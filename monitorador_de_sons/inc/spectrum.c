@@ -0,0 +1,115 @@
+#include "spectrum.h"
+#include "fft_tables.h"
+#include "metering.h"
+
+// Bins de cada banda [início, fim) para 16 kHz / 256 pontos (62,5 Hz por bin):
+// 62-250 Hz (zumbido de ventilação/HVAC), 250-500, 500-1k, 1-2k e 2-8 kHz (voz, sibilância)
+static const uint8_t band_edges[SPECTRUM_BANDS][2] = {
+    {1, 4}, {4, 8}, {8, 16}, {16, 32}, {32, SPECTRUM_FFT_SIZE / 2}
+};
+
+// Compensa o fator 2/N do espectro unilateral escalado, a metade de |X[k]| em
+// fft_q15_real_power e a perda de potência da janela de Hann (3/8):
+// 10*log10(16/3) em décimos de dB
+#define BAND_SCALE_DB_X10 73
+
+void spectrum_init(spectrum_t *spectrum, int32_t offset, uint8_t sample_shift) {
+    spectrum->fill = 0;
+    spectrum->offset = offset;
+    spectrum->input_shift = sample_shift < METERING_INPUT_SHIFT ? METERING_INPUT_SHIFT - sample_shift : 0;
+    spectrum->frames = 0;
+    for (uint8_t b = 0; b < SPECTRUM_BANDS; b++) spectrum->band_power[b] = 0;
+}
+
+// Acumula amostras e analisa cada quadro completo. Retorna true se as bandas mudaram.
+bool spectrum_feed(spectrum_t *spectrum, const volatile uint16_t *samples, uint32_t len) {
+    bool updated = false;
+    for (uint32_t i = 0; i < len; i++) {
+        int32_t x = ((int32_t)samples[i] - spectrum->offset) * (1 << spectrum->input_shift);
+        if (x > 32767) x = 32767;
+        if (x < -32768) x = -32768;
+        spectrum->frame[spectrum->fill] = (int16_t)((x * fft_hann_q15[spectrum->fill]) >> 15);
+
+        if (++spectrum->fill == SPECTRUM_FFT_SIZE) {
+            spectrum_analyze(spectrum);
+            spectrum->fill = 0;
+            updated = true;
+        }
+    }
+    return updated;
+}
+
+void spectrum_analyze(spectrum_t *spectrum) {
+    uint32_t power[SPECTRUM_FFT_SIZE / 2];
+    fft_q15_real_power(spectrum->frame, power);
+
+    for (uint8_t b = 0; b < SPECTRUM_BANDS; b++) {
+        uint64_t sum = 0;
+        for (uint8_t k = band_edges[b][0]; k < band_edges[b][1]; k++) sum += power[k];
+        spectrum->band_power[b] = sum;
+    }
+    spectrum->frames++;
+}
+
+// Nível da banda na mesma escala de calibração do medidor (sem ponderação A)
+int32_t spectrum_band_db_x10(const spectrum_t *spectrum, uint8_t band, int32_t cal_db_x10) {
+    return metering_power_db_x10(spectrum->band_power[band]) + BAND_SCALE_DB_X10
+         - METERING_INPUT_SCALE_DB_X10 + cal_db_x10;
+}
+
+// FFT complexa in-place, radix-2 com decimação no tempo, dados intercalados
+// {re, im} em Q15. `points` deve ser potência de 2 e no máximo FFT_TABLE_SIZE.
+// A saída fica escalada por 1/points.
+void fft_q15_complex(int16_t *data, uint32_t points) {
+    for (uint32_t i = 1, j = 0; i < points; i++) {
+        uint32_t bit = points >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            int16_t tr = data[2 * i], ti = data[2 * i + 1];
+            data[2 * i] = data[2 * j]; data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = tr; data[2 * j + 1] = ti;
+        }
+    }
+
+    for (uint32_t size = 2; size <= points; size <<= 1) {
+        uint32_t half = size >> 1;
+        uint32_t step = FFT_TABLE_SIZE / size;
+        for (uint32_t start = 0; start < points; start += size) {
+            for (uint32_t k = 0; k < half; k++) {
+                int32_t wr = fft_twiddle_q15[k * step][0];
+                int32_t wi = -fft_twiddle_q15[k * step][1];
+                int16_t *a = &data[2 * (start + k)];
+                int16_t *b = &data[2 * (start + k + half)];
+                int32_t tr = (wr * b[0] - wi * b[1]) >> 15;
+                int32_t ti = (wr * b[1] + wi * b[0]) >> 15;
+                int32_t ar = a[0], ai = a[1];
+                a[0] = (int16_t)((ar + tr) >> 1); a[1] = (int16_t)((ai + ti) >> 1);
+                b[0] = (int16_t)((ar - tr) >> 1); b[1] = (int16_t)((ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+// FFT real de FFT_TABLE_SIZE pontos: trata `data` como FFT_TABLE_SIZE/2 números
+// complexos (pares nas partes reais, ímpares nas imaginárias), transforma e separa
+// o espectro. Escreve (|X[k]|/2)^2 para k = 0..FFT_TABLE_SIZE/2 - 1; `data` é destruído.
+void fft_q15_real_power(int16_t *data, uint32_t *power) {
+    const uint32_t m = FFT_TABLE_SIZE / 2;
+    fft_q15_complex(data, m);
+
+    for (uint32_t k = 0; k < m; k++) {
+        uint32_t kc = (m - k) & (m - 1);
+        int32_t zr = data[2 * k], zi = data[2 * k + 1];
+        int32_t cr = data[2 * kc], ci = -data[2 * kc + 1];
+
+        int32_t er = (zr + cr) >> 1, ei = (zi + ci) >> 1;  // Parte par
+        int32_t or = (zi - ci) >> 1, oi = -((zr - cr) >> 1); // Parte ímpar
+        int32_t wr = fft_twiddle_q15[k][0], wi = -fft_twiddle_q15[k][1];
+
+        // xr e xi chegam a ±65535: metade deles ao quadrado ainda cabe em int32 e a soma em uint32
+        int32_t xr = (er + ((wr * or - wi * oi) >> 15)) >> 1;
+        int32_t xi = (ei + ((wr * oi + wi * or) >> 15)) >> 1;
+        power[k] = (uint32_t)(xr * xr) + (uint32_t)(xi * xi);
+    }
+}
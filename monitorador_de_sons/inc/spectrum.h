@@ -0,0 +1,36 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Analisador de espectro em ponto fixo para o modo de bandas da matriz 5x5.
+
+As amostras dos blocos do DMA são acumuladas em quadros de 256 pontos, janelados
+com Hann e transformados por uma FFT real em Q15 (FFT complexa radix-2 de 128
+pontos + separação par/ímpar). Cada estágio divide por 2, então não há
+saturação. O espectro é somado em 5 bandas de oitava, uma por coluna.
+*/
+
+#define SPECTRUM_FFT_SIZE 256
+#define SPECTRUM_BANDS 5
+
+typedef struct {
+    int16_t frame[SPECTRUM_FFT_SIZE];
+    uint16_t fill;
+    int32_t offset;                       // Nível do ADC correspondente ao silêncio
+    uint8_t input_shift;                  // Escala até METERING_INPUT_SHIFT bits fracionários
+    uint64_t band_power[SPECTRUM_BANDS];  // Soma de |X[k]|^2 de cada banda no último quadro
+    uint32_t frames;
+} spectrum_t;
+
+void spectrum_init(spectrum_t *spectrum, int32_t offset, uint8_t sample_shift);
+bool spectrum_feed(spectrum_t *spectrum, const volatile uint16_t *samples, uint32_t len);
+void spectrum_analyze(spectrum_t *spectrum);
+int32_t spectrum_band_db_x10(const spectrum_t *spectrum, uint8_t band, int32_t cal_db_x10);
+
+void fft_q15_complex(int16_t *data, uint32_t points);
+void fft_q15_real_power(int16_t *data, uint32_t *power);
+
+#endif
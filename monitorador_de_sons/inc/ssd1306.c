@@ -1,47 +1,69 @@
+#include <string.h>
 #include "ssd1306.h"
-#include "font.h"
+#include "display_assets.h"  // Gerado no build a partir de inc/font.txt
+
+// A RAM fica em colunas de 8 páginas (índice (x << 3) + página, duas palavras de
+// 32 linhas por coluna), o formato de ssd1306_column e das telas geradas
+_Static_assert(HEIGHT == 64, "ram_buffer tem 8 páginas por coluna");
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+  // Só painéis de 64 linhas: com outra altura as colunas sairiam do ram_buffer
+  if (height != HEIGHT) height = HEIGHT;
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
-  ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-  ssd->ram_buffer[0] = 0x40;
+  ssd->bufsize = ssd->pages * ssd->width;
+  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));  // Alinhado: cada coluna são 2 palavras
   ssd->port_buffer[0] = 0x80;
+  ssd->dirty = calloc(ssd->width, sizeof(uint8_t));
+  ssd->sent_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->last_flush_bytes = 0;
+  ssd->full_refresh = true;
+  ssd->tx_aborts = 0;
+
+  // Pior caso: quadro inteiro = 8 palavras de comando + controle + dados
+  ssd->stream = malloc((ssd->bufsize + 9) * sizeof(uint16_t));
+  ssd->stream_len = 0;
+  ssd->dma_channel = dma_claim_unused_channel(true);
+  dma_channel_config cfg = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, false);
+  channel_config_set_dreq(&cfg, i2c_get_dreq(i2c, true));
+  dma_channel_configure(ssd->dma_channel, &cfg, &i2c_get_hw(i2c)->data_cmd, ssd->stream, 0, false);
 }
 
+// Todos os comandos de configuração vão em uma única transação (byte de controle 0x00)
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  const uint8_t commands[] = {
+    0x00,
+    SET_DISP | 0x00,
+    SET_MEM_ADDR, 0x01,
+    SET_DISP_START_LINE | 0x00,
+    SET_SEG_REMAP | 0x01,
+    SET_MUX_RATIO, HEIGHT - 1,
+    SET_COM_OUT_DIR | 0x08,
+    SET_DISP_OFFSET, 0x00,
+    SET_COM_PIN_CFG, 0x12,
+    SET_DISP_CLK_DIV, 0x80,
+    SET_PRECHARGE, 0xF1,
+    SET_VCOM_DESEL, 0x30,
+    SET_CONTRAST, 0xFF,
+    SET_ENTIRE_ON,
+    SET_NORM_INV,
+    SET_CHARGE_PUMP, 0x14,
+    SET_DISP | 0x01
+  };
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
+  i2c_write_blocking(ssd->i2c_port, ssd->address, commands, sizeof(commands), false);
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -52,68 +74,287 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+static inline void ssd1306_stream_put(ssd1306_t *ssd, uint8_t byte) {
+  ssd->stream[ssd->stream_len++] = byte;
+}
+
+// Encerra a transação atual: o controlador gera STOP após este byte e inicia uma
+// nova transação (START + endereço) quando chegar o próximo.
+static inline void ssd1306_stream_stop(ssd1306_t *ssd) {
+  ssd->stream[ssd->stream_len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+}
+
+static void ssd1306_stream_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  ssd1306_stream_put(ssd, 0x00);
+  ssd1306_stream_put(ssd, SET_COL_ADDR);
+  ssd1306_stream_put(ssd, x0);
+  ssd1306_stream_put(ssd, x1);
+  ssd1306_stream_put(ssd, SET_PAGE_ADDR);
+  ssd1306_stream_put(ssd, page0);
+  ssd1306_stream_put(ssd, page1);
+  ssd1306_stream_stop(ssd);
+
+  // No modo de endereçamento vertical as páginas de uma coluna são consecutivas
+  ssd1306_stream_put(ssd, 0x40);
+  for (uint16_t x = x0; x <= x1; ++x) {
+    for (uint8_t page = page0; page <= page1; ++page) {
+      uint16_t index = (x << 3) + page;
+      ssd1306_stream_put(ssd, ssd->ram_buffer[index]);
+      ssd->sent_buffer[index] = ssd->ram_buffer[index];
+    }
+  }
+  ssd1306_stream_stop(ssd);
+}
+
+// Percorre as colunas alteradas de cada página agrupando-as em janelas. Retorna
+// o custo em bytes de I2C e, se `emit`, coloca as janelas no stream.
+static size_t ssd1306_flush_windows(ssd1306_t *ssd, bool emit) {
+  size_t cost = 0;
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    uint8_t mask = 1 << page;
+    int16_t start = -1, end = -1;
+    for (uint16_t x = 0; x < ssd->width; ++x) {
+      if (!(ssd->dirty[x] & mask)) continue;
+      uint16_t index = (x << 3) + page;
+      if (ssd->ram_buffer[index] == ssd->sent_buffer[index]) continue;
+      if (start >= 0 && x - end - 1 > SSD1306_WINDOW_OVERHEAD) {
+        cost += SSD1306_WINDOW_OVERHEAD + (end - start + 1);
+        if (emit) ssd1306_stream_window(ssd, start, end, page, page);
+        start = -1;
+      }
+      if (start < 0) start = x;
+      end = x;
+    }
+    if (start >= 0) {
+      cost += SSD1306_WINDOW_OVERHEAD + (end - start + 1);
+      if (emit) ssd1306_stream_window(ssd, start, end, page, page);
+    }
+  }
+  return cost;
+}
+
+// Páginas da coluna x que mudaram desde o último envio
+static inline uint8_t ssd1306_column_changes(ssd1306_t *ssd, uint16_t x) {
+  uint8_t changed = 0;
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    uint16_t index = (x << 3) + page;
+    if ((ssd->dirty[x] & (1 << page)) && ssd->ram_buffer[index] != ssd->sent_buffer[index])
+      changed |= 1 << page;
+  }
+  return changed;
+}
+
+// Alternativa às janelas por página: colunas alteradas vizinhas viram uma janela
+// com a união das suas páginas. Sai mais barato quando as alterações são
+// verticais (ex.: uma coluna inteira de um gráfico), que por página custariam
+// uma janela para cada página.
+static size_t ssd1306_flush_columns(ssd1306_t *ssd, bool emit) {
+  size_t cost = 0;
+  int16_t start = -1, end = -1;
+  uint8_t pages = 0;
+  for (uint16_t x = 0; x <= ssd->width; ++x) {
+    uint8_t changed = x < ssd->width ? ssd1306_column_changes(ssd, x) : 0;
+    if (!changed && x < ssd->width) continue;
+    if (start >= 0 && (x == ssd->width || x - end - 1 > SSD1306_WINDOW_OVERHEAD / ssd->pages)) {
+      uint8_t page0 = __builtin_ctz(pages), page1 = 31 - __builtin_clz(pages);
+      cost += SSD1306_WINDOW_OVERHEAD + (end - start + 1) * (page1 - page0 + 1);
+      if (emit) ssd1306_stream_window(ssd, start, end, page0, page1);
+      start = -1;
+      pages = 0;
+    }
+    if (x == ssd->width) break;
+    if (start < 0) start = x;
+    end = x;
+    pages |= changed;
+  }
+  return cost;
+}
+
+// Indica se ainda há uma transferência em andamento. Também trata abortos do
+// controlador (ex.: NACK), forçando o reenvio do quadro inteiro no próximo envio.
+bool ssd1306_busy(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    dma_channel_abort(ssd->dma_channel);
+    (void)hw->clr_tx_abrt;
+    ssd->tx_aborts++;
+    ssd->full_refresh = true;
+    return false;
+  }
+  return dma_channel_is_busy(ssd->dma_channel)
+      || !(hw->status & I2C_IC_STATUS_TFE_BITS)
+      || (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+// Monta as janelas alteradas (ou o quadro inteiro, quando as janelas custariam
+// mais que ele) e dispara o DMA. Nunca espera o barramento: se a transferência
+// anterior ainda não terminou retorna false e as alterações ficam pendentes.
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  if (ssd1306_busy(ssd))
+    return false;
+
+  size_t full_cost = SSD1306_WINDOW_OVERHEAD + ssd->bufsize;
+  size_t cost = full_cost, column_cost = full_cost;
+  if (!ssd->full_refresh) {
+    cost = ssd1306_flush_windows(ssd, false);
+    column_cost = ssd1306_flush_columns(ssd, false);
+  }
+
+  ssd->stream_len = 0;
+  if (cost >= full_cost && column_cost >= full_cost) {
+    ssd1306_stream_window(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+    cost = full_cost;
+    ssd->full_refresh = false;
+  } else if (column_cost < cost) {
+    ssd1306_flush_columns(ssd, true);
+    cost = column_cost;
+  } else if (cost > 0) {
+    ssd1306_flush_windows(ssd, true);
+  }
+  memset(ssd->dirty, 0, ssd->width);
+  ssd->last_flush_bytes = cost;
+
+  if (ssd->stream_len > 0) {
+    i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+    hw->enable = 0;
+    hw->tar = ssd->address;
+    hw->enable = 1;
+    dma_channel_transfer_from_buffer_now(ssd->dma_channel, ssd->stream, ssd->stream_len);
+  }
+  return true;
+}
+
+// Versão bloqueante, usada na inicialização
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  while (!ssd1306_send_data_async(ssd))
+    tight_loop_contents();
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
+}
+
+// Máscara de bits de uma página por byte alterado em uma palavra de coluna
+static inline uint8_t ssd1306_changed_pages(uint32_t diff) {
+  return ((diff & 0x000000FF) ? 0x1 : 0) | ((diff & 0x0000FF00) ? 0x2 : 0)
+       | ((diff & 0x00FF0000) ? 0x4 : 0) | ((diff & 0xFF000000) ? 0x8 : 0);
+}
+
+// Bits [y0, y1] que caem na palavra que começa na linha `base`
+static inline uint32_t ssd1306_word_mask(int y0, int y1, int base) {
+  if (y1 < base || y0 > base + 31) return 0;
+  uint32_t lo = y0 <= base ? 0xFFFFFFFFu : 0xFFFFFFFFu << (y0 - base);
+  uint32_t hi = y1 >= base + 31 ? 0xFFFFFFFFu : 0xFFFFFFFFu >> (31 - (y1 - base));
+  return lo & hi;
+}
+
+// Liga/desliga os bits de `mask0`/`mask1` (linhas 0-31 e 32-63) da coluna x de uma vez
+static inline void ssd1306_column_apply(ssd1306_t *ssd, uint8_t x, uint32_t mask0, uint32_t mask1, bool value) {
+  uint32_t *column = (uint32_t *)&ssd->ram_buffer[x << 3];
+  uint32_t old0 = column[0], old1 = column[1];
+  uint32_t new0 = value ? (old0 | mask0) : (old0 & ~mask0);
+  uint32_t new1 = value ? (old1 | mask1) : (old1 & ~mask1);
+  uint32_t diff0 = old0 ^ new0, diff1 = old1 ^ new1;
+  if (diff0 | diff1) {
+    column[0] = new0;
+    column[1] = new1;
+    ssd->dirty[x] |= ssd1306_changed_pages(diff0) | (ssd1306_changed_pages(diff1) << 4);
+  }
+}
+
+// Escreve os bits de `mask` de um byte de página, marcando a página se algo mudou
+static inline void ssd1306_byte_apply(ssd1306_t *ssd, uint8_t x, uint8_t page, uint8_t mask, uint8_t bits) {
+  uint16_t index = (x << 3) + page;
+  uint8_t old = ssd->ram_buffer[index];
+  uint8_t new = (old & ~mask) | (bits & mask);
+  if (new != old) {
+    ssd->ram_buffer[index] = new;
+    ssd->dirty[x] |= 1 << page;
+  }
+}
+
+// Preenche o retângulo [x0, x1] x [y0, y1], recortado aos limites do display
+static void ssd1306_span(ssd1306_t *ssd, int x0, int x1, int y0, int y1, bool value) {
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 >= ssd->width) x1 = ssd->width - 1;
+  if (y1 >= ssd->height) y1 = ssd->height - 1;
+  if (x0 > x1 || y0 > y1)
+    return;
+
+  // Dentro de uma única página basta um byte por coluna
+  if ((y0 >> 3) == (y1 >> 3)) {
+    uint8_t mask = (0xFF << (y0 & 0b111)) & (0xFF >> (7 - (y1 & 0b111)));
+    for (int x = x0; x <= x1; ++x)
+      ssd1306_byte_apply(ssd, x, y0 >> 3, mask, value ? mask : 0);
+    return;
+  }
+
+  uint32_t mask0 = ssd1306_word_mask(y0, y1, 0);
+  uint32_t mask1 = ssd1306_word_mask(y0, y1, 32);
+  for (int x = x0; x <= x1; ++x)
+    ssd1306_column_apply(ssd, x, mask0, mask1, value);
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
-  if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
-  else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint8_t bit = 1 << (y & 0b111);
+  ssd1306_byte_apply(ssd, x, y >> 3, bit, value ? bit : 0);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Substitui a coluna x inteira: linhas 0-31 nos bits de `rows0`, 32-63 nos de `rows1`
+void ssd1306_column(ssd1306_t *ssd, uint8_t x, uint32_t rows0, uint32_t rows1) {
+  if (x >= ssd->width)
+    return;
+  uint32_t *column = (uint32_t *)&ssd->ram_buffer[x << 3];
+  uint32_t diff0 = column[0] ^ rows0, diff1 = column[1] ^ rows1;
+  column[0] = rows0;
+  column[1] = rows1;
+  ssd->dirty[x] |= ssd1306_changed_pages(diff0) | (ssd1306_changed_pages(diff1) << 4);
+}
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+// Substitui o quadro inteiro por uma imagem no formato da RAM (8 bytes por coluna,
+// como as telas geradas de inc/screens.txt) com uma única cópia. Todas as páginas
+// ficam marcadas; o envio compara com sent_buffer e só transmite o que mudou.
+void ssd1306_load_frame(ssd1306_t *ssd, const uint8_t *frame) {
+  memcpy(ssd->ram_buffer, frame, ssd->bufsize);
+  memset(ssd->dirty, (1 << ssd->pages) - 1, ssd->width);
 }
 
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  for (uint8_t x = 0; x < ssd->width; ++x)
+    ssd1306_column_apply(ssd, x, 0xFFFFFFFFu, 0xFFFFFFFFu, value);
+}
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+  // Mesmos pixels da versão original, que desenhava as bordas em (left + width - 1)
+  // e (top + height - 1) truncados para 8 bits mesmo com largura ou altura zero
+  uint8_t right = left + width - 1;
+  uint8_t bottom = top + height - 1;
+
+  if (width > 0) {
+    ssd1306_span(ssd, left, left + width - 1, top, top, value);
+    ssd1306_span(ssd, left, left + width - 1, bottom, bottom, value);
   }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+  if (height > 0) {
+    ssd1306_span(ssd, left, left, top, top + height - 1, value);
+    ssd1306_span(ssd, right, right, top, top + height - 1, value);
   }
 
-  if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
-  }
+  if (fill)
+    ssd1306_span(ssd, left + 1, left + width - 2, top + 1, top + height - 2, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Linhas horizontais e verticais viram spans de palavra/byte
+    if (y0 == y1) {
+        ssd1306_span(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_span(ssd, x0, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -143,46 +384,66 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_span(ssd, x0, x1, y, y, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_span(ssd, x, x, y0, y1, value);
 }
 
-// Função para desenhar um caractere
+// Desenha o glifo do código Latin-1 `c` (os caracteres ASCII valem o próprio
+// código); códigos sem glifo aparecem em branco
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
-  char ver=c;
-  if (c >= 'A' && c <= 'Z')
-  {
-    index = (c - 'A' + 11) * 8; // Para letras maiúsculas
-  }else  if (c >= '0' && c <= '9')
+  uint8_t code = (uint8_t)c;
+  if (code < FONT_FIRST || code > FONT_LAST)
+    code = FONT_FIRST;
+  const uint8_t *glyph = font_glyphs[code - FONT_FIRST];
+
+  // Cada coluna do glifo é um byte: com y alinhado à página vira uma única escrita,
+  // senão é dividida entre duas páginas com máscaras
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+  for (uint8_t i = 0; i < FONT_GLYPH_BYTES; ++i)
   {
-    index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
-  }else if(c >= 'a' && c <= 'z'){
-    index = (c - 'a' + 37) * 8; // Para letras minúsculas
+    uint16_t column = x + i;
+    if (column >= ssd->width)
+      break;
+    uint8_t line = glyph[i];
+    if (page < ssd->pages)
+      ssd1306_byte_apply(ssd, column, page, 0xFF << shift, line << shift);
+    if (shift && page + 1 < ssd->pages)
+      ssd1306_byte_apply(ssd, column, page + 1, 0xFF >> (8 - shift), line >> (8 - shift));
   }
-  
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
-    }
+}
+
+// Próximo caractere de um texto em UTF-8 como código Latin-1. Caracteres acima
+// de U+00FF (e bytes inválidos) viram 0, que é desenhado em branco.
+static const char *ssd1306_next_code(const char *str, uint8_t *code)
+{
+  uint8_t lead = (uint8_t)*str++;
+  *code = 0;
+  if (lead < 0x80) {
+    *code = lead;
+  } else if ((lead & 0xE0) == 0xC0 && ((uint8_t)*str & 0xC0) == 0x80) {
+    uint16_t point = ((lead & 0x1F) << 6) | ((uint8_t)*str++ & 0x3F);
+    if (point <= 0xFF)
+      *code = (uint8_t)point;
+  } else {
+    while (((uint8_t)*str & 0xC0) == 0x80)
+      str++;
   }
+  return str;
 }
 
-// Função para desenhar uma string
+// Função para desenhar uma string (UTF-8)
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
   while (*str)
   {
-    ssd1306_draw_char(ssd, *str++, x, y);
+    uint8_t code;
+    str = ssd1306_next_code(str, &code);
+    ssd1306_draw_char(ssd, (char)code, x, y);
     x += 8;
     if (x + 8 >= ssd->width)
     {
@@ -194,4 +455,4 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
       break;
     }
   }
-}
\ No newline at end of file
+}
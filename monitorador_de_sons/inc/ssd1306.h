@@ -1,10 +1,18 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
 
 #define WIDTH 128
 #define HEIGHT 64
 
+// Bytes de I2C gastos para abrir uma janela (endereço, controle e 6 comandos em uma
+// transação + endereço e controle dos dados). Lacunas menores são reenviadas junto.
+#define SSD1306_WINDOW_OVERHEAD 10
+
 typedef enum {
   SET_CONTRAST = 0x81,
   SET_ENTIRE_ON = 0xA4,
@@ -32,18 +40,32 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t *dirty;       // Por coluna, máscara das páginas alteradas desde o último envio
+  uint8_t *sent_buffer; // Cópia do que o painel já recebeu, para descartar alterações desfeitas
+  uint16_t *stream;     // Palavras para o IC_DATA_CMD (byte + bit de STOP), enviadas por DMA
+  size_t stream_len;
+  int dma_channel;
+  uint32_t tx_aborts;   // Transferências abortadas pelo controlador (ex.: NACK)
+  size_t last_flush_bytes;
+  bool full_refresh;    // Força o envio do quadro inteiro (a RAM do painel começa com lixo)
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_send_data_async(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+void ssd1306_load_frame(ssd1306_t *ssd, const uint8_t *frame);
+void ssd1306_column(ssd1306_t *ssd, uint8_t x, uint32_t rows0, uint32_t rows1);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#endif
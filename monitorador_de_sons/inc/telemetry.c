@@ -0,0 +1,107 @@
+#include "telemetry.h"
+
+static inline uint8_t *put_u16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static inline uint8_t *put_u32(uint8_t *p, uint32_t v) {
+    p = put_u16(p, v & 0xFFFF);
+    return put_u16(p, v >> 16);
+}
+
+// CRC-16/CCITT-FALSE, bit a bit: o registro é curto e a tabela custaria 512 bytes
+uint16_t telemetry_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// Codifica `len` bytes em COBS (sem o 0x00 final). `dst` precisa de len + len/254 + 1 bytes.
+size_t telemetry_cobs_encode(const uint8_t *src, size_t len, uint8_t *dst) {
+    size_t code_at = 0, out = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            dst[code_at] = code;
+            code_at = out++;
+            code = 1;
+            continue;
+        }
+        dst[out++] = src[i];
+        if (++code == 0xFF) {
+            dst[code_at] = code;
+            code_at = out++;
+            code = 1;
+        }
+    }
+    dst[code_at] = code;
+    return out;
+}
+
+// Monta o quadro completo (registro + CRC, em COBS, com o delimitador 0x00).
+// `frame` precisa de TELEMETRY_FRAME_MAX bytes; retorna o tamanho usado.
+size_t telemetry_encode_frame(const telemetry_record_t *record, uint16_t dropped_records, uint8_t *frame) {
+    uint8_t raw[TELEMETRY_RECORD_LEN + 2];
+    uint8_t *p = raw;
+    *p++ = TELEMETRY_VERSION;
+    *p++ = TELEMETRY_TYPE_BLOCK;
+    p = put_u32(p, record->seq);
+    p = put_u32(p, record->timestamp_us);
+    p = put_u16(p, record->peak);
+    p = put_u16(p, record->mean);
+    p = put_u16(p, record->peak_samples);
+    p = put_u16(p, (uint16_t)record->block_db_x10);
+    p = put_u16(p, (uint16_t)record->laf_db_x10);
+    p = put_u16(p, record->alert_peaks);
+    p = put_u16(p, record->overruns);
+    p = put_u16(p, record->dropped_blocks);
+    p = put_u16(p, dropped_records);
+    put_u16(p, telemetry_crc16(raw, TELEMETRY_RECORD_LEN));
+
+    size_t len = telemetry_cobs_encode(raw, sizeof(raw), frame);
+    frame[len++] = 0x00;
+    return len;
+}
+
+void telemetry_queue_init(telemetry_queue_t *queue) {
+    atomic_store_explicit(&queue->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->dropped, 0, memory_order_relaxed);
+}
+
+// Lado do produtor (análise). Com a fila cheia o registro é descartado e contado.
+bool telemetry_queue_push(telemetry_queue_t *queue, const telemetry_record_t *record) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head - tail >= TELEMETRY_QUEUE_SIZE) {
+        uint32_t dropped = atomic_load_explicit(&queue->dropped, memory_order_relaxed);
+        atomic_store_explicit(&queue->dropped, dropped + 1, memory_order_relaxed);
+        return false;
+    }
+
+    queue->items[head & (TELEMETRY_QUEUE_SIZE - 1)] = *record;
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+// Lado do consumidor (laço principal, que alimenta o DMA da UART).
+bool telemetry_queue_pop(telemetry_queue_t *queue, telemetry_record_t *record) {
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (head == tail) return false;
+
+    *record = queue->items[tail & (TELEMETRY_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t telemetry_queue_dropped(const telemetry_queue_t *queue) {
+    return atomic_load_explicit((_Atomic uint32_t *)&queue->dropped, memory_order_relaxed);
+}
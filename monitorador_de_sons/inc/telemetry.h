@@ -0,0 +1,71 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/*
+Telemetria binária: um registro por bloco analisado (ou a cada N blocos),
+enviado em quadros COBS terminados em 0x00 e verificados por CRC-16/CCITT.
+
+Formato do registro (little-endian), antes do CRC e da codificação COBS:
+
+  off  tam  campo
+    0    1  versão (TELEMETRY_VERSION)
+    1    1  tipo (TELEMETRY_TYPE_BLOCK)
+    2    4  seq do bloco de captura
+    6    4  instante da análise, em us desde o boot (32 bits, dá a volta)
+   10    2  pico de amplitude do bloco (|x - silêncio|)
+   12    2  amplitude média do bloco
+   14    2  amostras do bloco com amplitude >= limiar de pico
+   16    2  nível RMS do bloco, ponderação A (décimos de dB, com sinal)
+   18    2  LAF (décimos de dB, com sinal)
+   20    2  picos de nível acumulados para o alerta
+   22    2  overruns do anel de captura (total, truncado em 16 bits)
+   24    2  blocos descartados na fila de análise (total, truncado)
+   26    2  registros de telemetria descartados (total, truncado)
+   28    2  CRC-16/CCITT (polinômio 0x1021, inicial 0xFFFF) dos bytes 0..27
+
+O decodificador do computador fica em tools/telemetry_csv.py. Mudanças de
+formato devem incrementar TELEMETRY_VERSION.
+*/
+
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_TYPE_BLOCK 1
+#define TELEMETRY_RECORD_LEN 28
+#define TELEMETRY_FRAME_MAX (TELEMETRY_RECORD_LEN + 2 + 2)  // + CRC, overhead COBS e delimitador
+#define TELEMETRY_QUEUE_SIZE 16  // Potência de 2
+
+typedef struct {
+    uint32_t seq;
+    uint32_t timestamp_us;
+    uint16_t peak;
+    uint16_t mean;
+    uint16_t peak_samples;
+    int16_t block_db_x10;
+    int16_t laf_db_x10;
+    uint16_t alert_peaks;
+    uint16_t overruns;
+    uint16_t dropped_blocks;
+} telemetry_record_t;
+
+// Fila SPSC entre a análise (produtor) e o envio pela UART (consumidor)
+typedef struct {
+    telemetry_record_t items[TELEMETRY_QUEUE_SIZE];
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    _Atomic uint32_t dropped;
+} telemetry_queue_t;
+
+uint16_t telemetry_crc16(const uint8_t *data, size_t len);
+size_t telemetry_cobs_encode(const uint8_t *src, size_t len, uint8_t *dst);
+size_t telemetry_encode_frame(const telemetry_record_t *record, uint16_t dropped_records, uint8_t *frame);
+
+void telemetry_queue_init(telemetry_queue_t *queue);
+bool telemetry_queue_push(telemetry_queue_t *queue, const telemetry_record_t *record);
+bool telemetry_queue_pop(telemetry_queue_t *queue, telemetry_record_t *record);
+uint32_t telemetry_queue_dropped(const telemetry_queue_t *queue);
+
+#endif
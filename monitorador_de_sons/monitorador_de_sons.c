@@ -6,18 +6,43 @@ Data de Finalização: 26/02/2025
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include "pico/bootrom.h"
 #include "pico/stdlib.h"
 #include "pico/time.h"
+#include "pico/multicore.h"
+#include "tusb.h"
 #include "hardware/adc.h"
 #include "hardware/i2c.h"
 #include "hardware/pwm.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "hardware/dma.h"
+#include "hardware/uart.h"
+#include "hardware/flash.h"
 #include "pio_matrix.pio.h"
 #include "./inc/ssd1306.h"
-#include "./inc/font.h"
+#include "display_assets.h"  // Fonte e telas fixas geradas no build (inc/font.txt, inc/screens.txt)
+#include "./inc/capture_ring.h"
+#include "./inc/block_queue.h"
+#include "./inc/metering.h"
+#include "./inc/spectrum.h"
+#include "./inc/alert.h"
+#include "./inc/telemetry.h"
+#include "./inc/scheduler.h"
+#include "./inc/level_stats.h"
+#include "./inc/profiling.h"
+#include "./inc/decimator.h"
+#include "./inc/dc_tracker.h"
+#include "./inc/alert_rules.h"
+#include "./inc/event_log.h"
+#include "./inc/isr_log.h"
+#include "./inc/block_stats.h"
+#include "./inc/deinterleave.h"
+#include "./inc/raw_stream.h"
+#include "./inc/level_graph.h"
+#include "./inc/sound_class.h"
+#include "./inc/sound_class_config.h"
 
 // Comunicação Serial I2C
 #define I2C_PORT i2c1
@@ -26,12 +51,47 @@ Data de Finalização: 26/02/2025
 
 #define DELAY_UART_MS 3000
 
+// Telemetria binária pela UART (o relatório em texto sai só pelo USB)
+#define TELEMETRY_UART uart0
+#define TELEMETRY_TX_PIN 0
+#define TELEMETRY_BAUD 921600
+#define TELEMETRY_BLOCKS_PER_RECORD 1  // 1: um registro por bloco do DMA (~202 por segundo)
+#define TELEMETRY_TX_FRAMES 8          // Quadros enviados por transferência do DMA
+
+// Registro persistente na flash (inc/event_log.h); gravado uma vez por minuto
+#define EVENT_LOG_SECTORS 16  // 64 kB no fim da flash, longe do programa
+#define EVENT_LOG_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - EVENT_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define LOG_MINUTE_SAMPLES (60u * ADC_SAMPLE_RATE_HZ)
+
+// Tarefas do laço principal (prioridade: 0 é a mais alta)
+#define PRIO_ANALYSIS 0
+#define PRIO_ALERT 1
+#define PRIO_DISPLAY 2
+#define PRIO_MONITOR 3
+#define PRIO_REPORT 4
+#define PRIO_STREAM 5
+#define MONITOR_INTERVAL_MS 20  // Telemetria e verificação de alerta (a fila comporta ~79 ms)
+#define DISPLAY_RETRY_MS 5      // Nova tentativa enquanto o I2C ainda envia o quadro anterior
+
 // Definições do Display 
 #define SSD_ADDR 0x3C
 #define SSD_WIDTH 128
 #define SSD_HEIGHT 64
 #define BORDER_DUR_MS 50
 
+#if SCREEN_WIDTH != SSD_WIDTH || SCREEN_HEIGHT != SSD_HEIGHT
+#error "O 'size' de inc/screens.txt deve ser o do display (SSD_WIDTH x SSD_HEIGHT)"
+#endif
+
+// Gráfico do histórico de nível no display (inc/level_graph.h); o comando 'g' alterna com o texto
+#ifndef OLED_GRAPH_DEFAULT
+#define OLED_GRAPH_DEFAULT 0  // 1: o display já começa no gráfico
+#endif
+#define GRAPH_BLOCKS_PER_COLUMN 20  // Maior LAF de ~99 ms por coluna: 108 colunas cobrem ~10,7 s
+#define GRAPH_X0 20                 // Rótulos e eixo ocupam as colunas à esquerda
+#define GRAPH_MIN_DB_X10 300
+#define GRAPH_MAX_DB_X10 900
+
 // Definições do PWM para LEDs (10 kHz)
 #define WRAP 2048
 #define CLK_DIV 6.1
@@ -40,6 +100,7 @@ Data de Finalização: 26/02/2025
 #define BUZZER_WRAP 62500  // 125 MHz / 2000 Hz = 62500
 #define BUZZER_CLK_DIV 1.0
 #define BUZZER_DURATION_MS 500
+#define ALERT_TICK_MS 10  // Passo da tarefa do alerta enquanto há um em andamento
 
 // Buzzers
 #define BUZZER_A_PIN 21  // PWM 5A
@@ -48,29 +109,114 @@ Data de Finalização: 26/02/2025
 // Matriz de Leds 
 #define MATRIZ_LEDS_PIN 7
 #define NUM_LEDS 25
+#define LED_BRIGHTNESS 256  // Brilho global, de 0 a 256 (256: cores da paleta sem atenuação)
 
-// Microfone e DMA
-#define MICROPHONE_PIN 28
-#define MIC_CHANNEL 2
-#define ADC_CLK_DIV 21.f
-#define SILENCE_LEVEL 2048
-#define DMA_BUFFER_SIZE 79
-#define AMPL_LEVEL_1 100
-#define AMPL_LEVEL_2 250
-#define AMPL_LEVEL_3 350
-#define AMPL_LEVEL_4 450
+// Microfones e DMA. Com mais de uma entrada o ADC converte em rodízio (round robin)
+// e cada bloco do DMA é separado por canal antes da análise (inc/deinterleave.h).
+#define MIC_CHANNEL 2  // Microfone da placa (GPIO 28); o espectro da matriz vem dele
+#ifndef MIC_CHANNEL_MASK
+#define MIC_CHANNEL_MASK (1u << MIC_CHANNEL)  // Entradas com microfone; ADC0 e ADC1 são os GPIO 26 e 27
+#endif
+#ifndef CAPTURE_TEMPERATURE
+#define CAPTURE_TEMPERATURE 0  // 1: inclui o sensor de temperatura do chip (ADC4) no rodízio
+#endif
+#define COUNT_BITS4(m) (((m) & 1) + (((m) >> 1) & 1) + (((m) >> 2) & 1) + (((m) >> 3) & 1))
+#define MIC_CHANNELS COUNT_BITS4(MIC_CHANNEL_MASK)
+#define PRIMARY_MIC COUNT_BITS4(MIC_CHANNEL_MASK & ((1u << MIC_CHANNEL) - 1))  // Posição de MIC_CHANNEL no rodízio
+#define ADC_INPUTS (MIC_CHANNELS + CAPTURE_TEMPERATURE)
+#define ADC_ROUND_ROBIN_MASK (MIC_CHANNEL_MASK | (CAPTURE_TEMPERATURE << 4))  // Convertidas em ordem crescente
+#if (MIC_CHANNEL_MASK & ~0xFu) || !(MIC_CHANNEL_MASK & (1u << MIC_CHANNEL))
+#error "MIC_CHANNEL_MASK deve usar só as entradas 0 a 3 e incluir MIC_CHANNEL"
+#endif
+#define ADC_SAMPLE_RATE_HZ 16000  // Taxa das amostras analisadas, por entrada
+#ifndef OVERSAMPLE_FACTOR  // 1: ADC na taxa de análise; 4 a 16 (potência de 2): sobreamostragem + decimador
+#if ADC_INPUTS == 1
+#define OVERSAMPLE_FACTOR 16
+#elif ADC_INPUTS <= 3
+#define OVERSAMPLE_FACTOR 8
+#else
+#define OVERSAMPLE_FACTOR 4
+#endif
+#endif
+#define ADC_CAPTURE_RATE_HZ (ADC_SAMPLE_RATE_HZ * OVERSAMPLE_FACTOR * ADC_INPUTS)  // Conversões de todas as entradas
+#define ADC_CLK_DIV (48000000.f / ADC_CAPTURE_RATE_HZ - 1.f)  // Período = (1 + div) ciclos de 48 MHz
+#define SILENCE_LEVEL 2048  // Polarização nominal do microfone; a real é estimada continuamente
+#define DC_SETTLE_MS 1000   // Calibração do nível DC na partida, sem alertas nem estatísticas
+#define DMA_BUFFER_SIZE 79  // Amostras analisadas por bloco
+#define CAPTURE_CHANNEL_SAMPLES (DMA_BUFFER_SIZE * OVERSAMPLE_FACTOR)  // Amostras de cada entrada por bloco
+#define CAPTURE_BLOCK_SAMPLES (CAPTURE_CHANNEL_SAMPLES * ADC_INPUTS)      // Amostras do ADC por bloco do DMA
+#if OVERSAMPLE_FACTOR > 1
+#define SAMPLE_SHIFT DECIMATOR_OUTPUT_SHIFT  // Bits fracionários das amostras analisadas
+#else
+#define SAMPLE_SHIFT 0
+#endif
+#define SAMPLE_OFFSET (SILENCE_LEVEL << SAMPLE_SHIFT)  // Estimativa inicial do nível DC
+#if OVERSAMPLE_FACTOR > DECIMATOR_MAX_RATIO
+#error "OVERSAMPLE_FACTOR acima de DECIMATOR_MAX_RATIO"
+#endif
+#if ADC_CAPTURE_RATE_HZ > 500000
+#error "OVERSAMPLE_FACTOR e as entradas do rodízio excedem a taxa máxima do ADC (500 kS/s)"
+#endif
+#define CAPTURE_BLOCKS 8  // Blocos no anel de captura (2 ficam sempre com o DMA)
+#if CAPTURE_BLOCKS < 4 || CAPTURE_BLOCKS > CAPTURE_RING_MAX_BLOCKS || (CAPTURE_BLOCKS & (CAPTURE_BLOCKS - 1))
+#error "CAPTURE_BLOCKS deve ser potência de 2 entre 4 e CAPTURE_RING_MAX_BLOCKS (seq % CAPTURE_BLOCKS é o slot do DMA)"
+#endif
+#ifndef ANALYSIS_ON_CORE1
+#define ANALYSIS_ON_CORE1 1  // 1: análise e LEDs no core 1; 0: no laço principal
+#endif
 #define AMPL_LEVEL_5 750
 #define UPDATE_INTERVAL_MS 75
 
+// Medição de nível (décimos de dB, ponderação A, Fast)
+#define METER_CAL_DB_X10 200  // dB SPL = dB(1 LSB RMS) + calibração; ajustar com decibelímetro
+#define DB_LEVEL_1 570
+#define DB_LEVEL_2 649
+#define DB_LEVEL_3 679
+#define DB_LEVEL_4 700
+#define DB_LEVEL_5 745
+
+// Regras de alerta (inc/alert_rules.h), com histerese entre entrada e saída
+#define PEAK_RULE_WINDOW_MS 10000
+#define PEAK_RULE_ENTER 20                    // Blocos com LAF >= DB_LEVEL_5 na janela
+#define PEAK_RULE_EXIT 5
+#define LEQ_RULE_WINDOW_MS 5000
+#define LEQ_RULE_ENTER_DB_X10 DB_LEVEL_4      // LAeq da janela
+#define LEQ_RULE_EXIT_DB_X10 (DB_LEVEL_4 - 30)
+#define TALK_RULE_WINDOW_MS 30000             // Conversa: blocos rotulados fala com LAF >= DB_LEVEL_1
+#define TALK_RULE_WINDOW_BLOCKS ((uint64_t)TALK_RULE_WINDOW_MS * ADC_SAMPLE_RATE_HZ / (1000u * DMA_BUFFER_SIZE))
+#define TALK_RULE_ENTER (TALK_RULE_WINDOW_BLOCKS / 2)  // Metade da janela
+#define TALK_RULE_EXIT (TALK_RULE_WINDOW_BLOCKS / 5)
+#define ALERT_COOLDOWN_MS 15000               // Intervalo mínimo entre disparos da mesma regra
+
+// Captura bruta pelo USB (inc/raw_stream.h): comando 's' ou Joystick com o Botão B pressionado
+#ifndef RAW_STREAM_KEEP_ANALYSIS
+#define RAW_STREAM_KEEP_ANALYSIS 1  // 0: suspende a análise (alertas, LEDs e estatísticas) durante a captura
+#endif
+#define STREAM_INTERVAL_MS 1  // Passo da tarefa de envio; o FIFO do CDC guarda só 256 bytes
+
 // Definições de Botões
 #define BUTTON_A_PIN 5 
 #define BUTTON_B_PIN 6
 #define BUTTON_JOY_PIN 22 
+#define LONG_PRESS_MS 1000  // Segurar o Botão B alterna o modo da matriz
+
+// Modos da Matriz de Leds
+#define MODE_HISTORY 0   // Histórico do nível ao longo do tempo
+#define MODE_SPECTRUM 1  // Bandas de oitava do espectro, uma por coluna
+
+// Mensagens gravadas pelas ISRs (inc/isr_log.h) e formatadas por isr_log_print
+#define ISR_MSG_MATRIX_MODE 1  // arg: modo da matriz
+#define ISR_MSG_BUZZERS 2      // arg: buzzers habilitados
+#define ISR_MSG_CAPTURE 3      // arg: captação ativada
+#define ISR_MSG_SERIAL_ON 4
 
 // Variáveis globais
 ssd1306_t ssd;
-uint dma_channel;
-dma_channel_config dma_cfg;
+uint dma_channels[2];
+dma_channel_config dma_cfgs[2];
+volatile uint8_t next_dma = 0;
+capture_ring_t capture_ring;
+block_queue_t block_queue;
 PIO pio = pio0;
 uint sm;
 const uint coluns_index[5][5] = {
@@ -81,66 +227,645 @@ const uint coluns_index[5][5] = {
     {0, 9, 10, 19, 20}
 };
 volatile uint8_t heights[5] = {0};
-volatile uint16_t mic_buffer[DMA_BUFFER_SIZE];
+// Cores GRB (G << 24 | R << 16 | B << 8) por altura da coluna, em brilho máximo
+const uint32_t level_palette[6] = {
+    0x00000000,  // 0: apagado
+    0xFF000000,  // 1: verde
+    0xBF7F0000,  // 2: verde-amarelado
+    0xFFFF0000,  // 3: amarelo
+    0x7FFF0000,  // 4: laranja
+    0x00FF0000   // 5: vermelho
+};
+uint32_t led_palette[6];  // level_palette já escalada pelo brilho
+uint32_t led_frame[NUM_LEDS];  // Só o core da análise escreve (update_leds e clear_leds)
+uint led_dma;
+volatile bool leds_clear_requested = false;  // Pedido do botão A para apagar a matriz
+volatile uint16_t mic_buffer[CAPTURE_BLOCKS][CAPTURE_BLOCK_SAMPLES];
 volatile uint event_time = 0;
-volatile bool pwm_enable = true, dma_enabled = true, buzzers_enable = true, border_on = true, serial_on = true;
-volatile uint32_t last_update_time = 0, last_buzzer_on = 0, last_border_blink = 0;
+volatile bool pwm_enable = true, dma_enabled = true, buzzers_enable = true, serial_on = true;
+volatile uint32_t last_update_time = 0;
 volatile uint8_t peak_height = 0;
-volatile uint amplitude_peak_count = 0, max_peak = 0, sum_peaks = 0, count_peaks = 0, sum_sounds = 0, count_sounds = 0;
+alert_rules_t alert_rules;
+int rule_peaks, rule_leq, rule_talk;
+sound_class_t sound_class;
+uint32_t window_class_blocks[SOUND_CLASS_COUNT], report_class_blocks[SOUND_CLASS_COUNT];
+volatile uint32_t alert_fired_seq = 0, alert_fired_rules = 0;  // Escritos pela análise
+uint32_t alert_seen_seq = 0;
+event_log_t event_log;
+level_stats_t minute_stats;  // Minuto em acumulação para o registro
+uint64_t minute_power[MIC_CHANNELS];  // Soma de block_ms de cada microfone no minuto
+int32_t minute_lafmax = 0;
+uint32_t minute_samples = 0;
+event_log_record_t log_minute;
+volatile bool log_minute_ready = false;
+uint16_t log_minute_alerts = 0;
+uint32_t log_gap_ms = 0;  // Captura parada para apagar a flash desde o último minuto
+isr_log_t isr_log;
+uint32_t isr_log_reported_drops = 0;
+uint8_t mic_inputs[MIC_CHANNELS];  // Entrada do ADC de cada microfone, na ordem do rodízio
+meter_t meters[MIC_CHANNELS];
+dc_tracker_t dc_trackers[MIC_CHANNELS];
+uint8_t loud_mic = 0;  // Microfone com o maior LAF no último bloco; define o nível do bloco
+volatile int32_t laf_db_x10 = 0, las_db_x10 = 0;
+level_stats_t window_stats, report_stats;  // Janela em acumulação e última janela fechada
+int32_t report_laeq_db_x10 = 0, report_lafmax_db_x10 = 0;  // Maior entre os microfones
+int32_t report_mic_laeq_db_x10[MIC_CHANNELS], report_mic_lafmax_db_x10[MIC_CHANNELS], report_dc_x10[MIC_CHANNELS];
+volatile bool report_requested = false, report_ready = false;
+spectrum_t spectrum;
+#if ADC_INPUTS > 1
+uint16_t adc_lanes[CAPTURE_BLOCK_SAMPLES] __attribute__((aligned(4)));  // Bloco separado por entrada
+#endif
+#if OVERSAMPLE_FACTOR > 1
+decimator_t decimators[MIC_CHANNELS];
+#endif
+// Anel da captura bruta; com sobreamostragem é também a saída do decimador, lida em palavras
+uint16_t stream_blocks[RAW_STREAM_BLOCKS][MIC_CHANNELS * DMA_BUFFER_SIZE] __attribute__((aligned(4)));
+raw_stream_t raw_stream;
+volatile bool raw_stream_on = false, raw_stream_toggle = false;
+#if CAPTURE_TEMPERATURE
+uint64_t temperature_sum = 0;  // Códigos do ADC4 na janela do relatório
+uint32_t temperature_samples = 0;
+int32_t report_temperature_x10 = 0;
+#endif
+volatile uint8_t display_mode = MODE_HISTORY;
+level_graph_t level_graph;
+bool oled_graph = OLED_GRAPH_DEFAULT;
+int32_t graph_peak = 0;  // Acumulação da coluna, na análise
+uint8_t graph_blocks = 0;
+volatile int16_t graph_column_db_x10 = 0;
+volatile uint32_t graph_column_seq = 0;  // Colunas publicadas pela análise
+uint32_t graph_seen_seq = 0;
+volatile uint32_t button_b_pressed_at = 0;
+bool display_pending = false;
+alert_t alert;
+scheduler_t scheduler;
+int task_analysis, task_alert, task_display, task_monitor, task_report, task_stream;
+alarm_id_t wake_alarm = 0;
+telemetry_queue_t telemetry_queue;
+telemetry_record_t telemetry_acc;
+uint32_t telemetry_acc_blocks = 0, telemetry_acc_sum = 0;
+uint telemetry_dma;
+uint8_t telemetry_tx[TELEMETRY_TX_FRAMES * TELEMETRY_FRAME_MAX];
+// Batidas isoladas não contam nos picos nem no LAeq; a conversa tem a própria regra
+#define CLASSES_EXCEPT_IMPULSE (((1u << SOUND_CLASS_COUNT) - 1) & ~(1u << SOUND_CLASS_IMPULSE))
+const alert_rule_config_t peak_rule = {
+    .kind = ALERT_RULE_EVENTS,
+    .window_ms = PEAK_RULE_WINDOW_MS,
+    .event_db_x10 = DB_LEVEL_5,
+    .class_mask = CLASSES_EXCEPT_IMPULSE,
+    .enter = PEAK_RULE_ENTER,
+    .exit = PEAK_RULE_EXIT,
+    .cooldown_ms = ALERT_COOLDOWN_MS
+};
+const alert_rule_config_t leq_rule = {
+    .kind = ALERT_RULE_LEQ,
+    .window_ms = LEQ_RULE_WINDOW_MS,
+    .class_mask = CLASSES_EXCEPT_IMPULSE,
+    .enter = LEQ_RULE_ENTER_DB_X10,
+    .exit = LEQ_RULE_EXIT_DB_X10,
+    .cooldown_ms = ALERT_COOLDOWN_MS
+};
+const alert_rule_config_t talk_rule = {
+    .kind = ALERT_RULE_EVENTS,
+    .window_ms = TALK_RULE_WINDOW_MS,
+    .event_db_x10 = DB_LEVEL_1,
+    .class_mask = 1u << SOUND_CLASS_SPEECH,
+    .enter = TALK_RULE_ENTER,
+    .exit = TALK_RULE_EXIT,
+    .cooldown_ms = ALERT_COOLDOWN_MS
+};
+const alert_pattern_t noise_alert_pattern = {
+    .duration_ms = BUZZER_DURATION_MS,
+    .buzzer_on_ms = BUZZER_DURATION_MS,
+    .buzzer_off_ms = 0,
+    .blink_ms = BORDER_DUR_MS
+};
 
 // Protótipos
 void setup();
+void init_scheduler();
 void setup_adc_dma();
+void start_capture();
+void stop_capture();
+void process_block(const volatile uint16_t *samples, uint32_t seq);
+void telemetry_collect(uint32_t seq, uint16_t peak, uint32_t sum, uint16_t peak_samples);
+void graph_collect(int32_t level);
+void graph_update(uint32_t columns, int16_t level);
+void init_telemetry();
+void telemetry_service();
+void analysis_drain();
+void temperature_collect(const uint16_t *samples);
+void core1_main();
 void init_buttons();
 void init_buzzers();
 void init_i2c_display(ssd1306_t *ssd);
 void init_matrix_leds();
 void button_irq_handler(uint gpio, uint32_t events);
 void update_leds();
+void clear_leds();
+void wake_analysis();
+void set_led_brightness(uint16_t brightness);
+uint8_t level_to_height(int32_t level);
 void noise_alert();
-uint32_t matrix_led_color(float red, float green, float blue);
+void alert_task(uint32_t now);
+void display_task(uint32_t now);
+void monitor_task(uint32_t now);
+void report_task(uint32_t now);
+void stream_task(uint32_t now);
+void set_raw_stream(bool on, uint32_t now);
+size_t usb_stream_write(const uint8_t *data, size_t len);
+void close_report_window();
+void print_report();
+void serial_command_poll();
+void benchmark_block_stats();
+void init_event_log();
+void event_log_flush();
+void log_collect(int32_t level, const block_stats_t *block);
+void log_alert(uint32_t rules, uint32_t now);
+void log_print_record(void *ctx, const event_log_record_t *record);
+void isr_log_print();
+void analysis_task(uint32_t now);
+void sleep_until_next_event();
+void set_buzzers(bool on);
+void show_monitor_screen();
+void show_alert_screen();
+void display_update();
+void display_service();
 
 void main() {
     stdio_init_all();
     setup();
 
-    ssd1306_rect(&ssd, 3, 3, 122, 60, 1, 0);
-    ssd1306_draw_string(&ssd, "MONITORANDO", (SSD_WIDTH/2) - ((sizeof("MONITORANDO") * 8) / 2), 20);
-    ssd1306_draw_string(&ssd, "SONS", (SSD_WIDTH/2) - ((sizeof("SONS") * 8) / 2), 35);
+    show_monitor_screen();
     ssd1306_send_data(&ssd);
 
     while (true) {
-        if (amplitude_peak_count > 0 && amplitude_peak_count % 20 == 0) {
-            noise_alert();
-            amplitude_peak_count = 0;  // Resetar após o alerta
-            ssd1306_fill(&ssd, false);
-            ssd1306_rect(&ssd, 3, 3, 122, 60, 1, 0);
-            ssd1306_draw_string(&ssd, "MONITORANDO", (SSD_WIDTH/2) - ((sizeof("MONITORANDO") * 8) / 2), 20);
-            ssd1306_draw_string(&ssd, "SONS", (SSD_WIDTH/2) - ((sizeof("SONS") * 8) / 2), 35);
-            ssd1306_send_data(&ssd);
+        uint32_t irq_state = save_and_disable_interrupts();
+        uint32_t posted = sched_take_posted(&scheduler);
+        restore_interrupts(irq_state);
+
+        if (!sched_run(&scheduler, posted, to_ms_since_boot(get_absolute_time()))) {
+            sleep_until_next_event();
         }
+    }
+}
+
+int64_t wake_alarm_callback(alarm_id_t id, void *user_data) {
+    return 0;  // Só tira o core do __wfi()
+}
+
+// Dorme até o próximo prazo ou evento. As interrupções ficam desligadas entre a
+// verificação e o __wfi(), que acorda mesmo assim com uma IRQ pendente; então
+// um evento sinalizado nesse meio-tempo não se perde.
+void sleep_until_next_event() {
+    uint32_t due;
+    bool has_due = sched_next_due(&scheduler, &due);
+    if (has_due) {
+        int32_t delay = (int32_t)(due - to_ms_since_boot(get_absolute_time()));
+        if (delay <= 0) return;
+        if (wake_alarm > 0) cancel_alarm(wake_alarm);
+        wake_alarm = add_alarm_in_ms(delay, wake_alarm_callback, NULL, false);
+        if (wake_alarm <= 0) return;
+    }
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (scheduler.posted == 0) __wfi();
+    restore_interrupts(irq_state);
+}
+
+void analysis_task(uint32_t now) {
+    analysis_drain();
+}
+
+void alert_task(uint32_t now) {
+    PROF_BEGIN(PROF_STAGE_ALERT);
+    uint8_t events = alert_tick(&alert, now);
+    if (events & ALERT_EVT_BUZZER_ON) set_buzzers(buzzers_enable);
+    if (events & ALERT_EVT_BUZZER_OFF) set_buzzers(false);
+    if (events & (ALERT_EVT_SHOW | ALERT_EVT_RESTORE)) {
+        if (alert_busy(&alert)) show_alert_screen();
+        else show_monitor_screen();
+        display_update();
+    }
+    if ((events & ALERT_EVT_BORDER) && alert_busy(&alert)) {
+        ssd1306_rect(&ssd, 3, 3, 122, 60, alert.border_on, 0);
+        display_update();
+    }
+    if (alert_busy(&alert)) sched_in(&scheduler, task_alert, now, ALERT_TICK_MS);
+    PROF_END(PROF_STAGE_ALERT);
+}
+
+void display_task(uint32_t now) {
+    PROF_BEGIN(PROF_STAGE_DISPLAY);
+    display_service();
+    PROF_END(PROF_STAGE_DISPLAY);
+    if (display_pending) sched_in(&scheduler, task_display, now, DISPLAY_RETRY_MS);
+}
 
-        if (to_ms_since_boot(get_absolute_time()) % DELAY_UART_MS == 0) {
-          if (serial_on) {
-            printf("\n");
-            printf("RELATÓRIO GERADO A CADA -- %ims --:\n", DELAY_UART_MS);
-            printf("Nível da Amplitude Máxima -- %i\n", max_peak);
-            printf("Nível Médio de Amplitudes maiores que %i -- %i\n", AMPL_LEVEL_5, sum_peaks / count_peaks);
-            printf("Quantidade de amostras maiores que %i -- %i\n", AMPL_LEVEL_5, count_peaks);
-            printf("Nível Médio de Amplitude -- %i\n", sum_sounds / count_sounds);
-            printf("Quantidade de amostras: -- %i\n", count_sounds); 
-          }
-          sum_peaks = 0; count_peaks = 0; sum_sounds = 0; count_sounds = 0; max_peak = 0;
+// Tarefas que dependem do que o core 1 produz: alerta por picos e telemetria
+void monitor_task(uint32_t now) {
+    if (alert_fired_seq != alert_seen_seq) {
+        alert_seen_seq = alert_fired_seq;
+        __mem_fence_acquire();
+        noise_alert();
+        log_alert(alert_fired_rules, now);
+    }
+    uint32_t graph_seq = graph_column_seq;
+    if (graph_seq != graph_seen_seq) {
+        __mem_fence_acquire();
+        graph_update(graph_seq - graph_seen_seq, graph_column_db_x10);
+        graph_seen_seq = graph_seq;
+    }
+    if (log_minute_ready) {
+        __mem_fence_acquire();
+        event_log_record_t record = log_minute;
+        log_minute_ready = false;
+        record.time_s = now / 1000;
+        record.minute.alerts = log_minute_alerts;
+        log_minute_alerts = 0;
+        record.minute.gap_ms = (uint16_t)(log_gap_ms > UINT16_MAX ? UINT16_MAX : log_gap_ms);
+        log_gap_ms = 0;
+        event_log_append(&event_log, &record);
+        event_log_flush();  // Os alertas do minuto vão junto, em uma só gravação
+    }
+    PROF_BEGIN(PROF_STAGE_TELEMETRY);
+    telemetry_service();
+    PROF_END(PROF_STAGE_TELEMETRY);
+
+    if (report_ready) {
+        __mem_fence_acquire();
+        report_ready = false;
+        PROF_BEGIN(PROF_STAGE_REPORT);
+        print_report();
+        PROF_END(PROF_STAGE_REPORT);
+    }
+    if (!raw_stream_on) isr_log_print();  // Texto no meio da captura bruta corromperia os quadros
+    serial_command_poll();
+}
+
+// Formata as mensagens que as ISRs deixaram na fila, na ordem em que foram gravadas
+void isr_log_print() {
+    isr_log_entry_t entry;
+    while (isr_log_pop(&isr_log, &entry)) {
+        uint ms = (uint)(entry.time_us / 1000);
+        printf("\n[%u.%03u s] ", ms / 1000, ms % 1000);
+        switch (entry.id) {
+            case ISR_MSG_MATRIX_MODE:
+                printf("--> Modo da Matriz: %s\n", entry.arg == MODE_SPECTRUM ? "Espectro" : "Histórico");
+                break;
+            case ISR_MSG_BUZZERS:
+                printf("--> Buzzers Passivos foram: %s\n", entry.arg ? "Ativados" : "Desativados");
+                break;
+            case ISR_MSG_CAPTURE:
+                printf("--> Captação de Som foi: %s\n", entry.arg ? "Ativada" : "Desativada");
+                break;
+            case ISR_MSG_SERIAL_ON:
+                printf("-- COMUNICAÇÃO ATIVADA --\n");
+                break;
         }
     }
+    uint32_t dropped = isr_log_dropped(&isr_log);
+    if (dropped != isr_log_reported_drops) {
+        printf("--> %u mensagens de interrupção descartadas com a fila cheia\n", (uint)(dropped - isr_log_reported_drops));
+        isr_log_reported_drops = dropped;
+    }
+}
+
+#if PROFILING_ENABLED
+// Ciclos do kernel de estatísticas do bloco (SWAR) e da referência escalar, de
+// 64 a 1024 amostras, com um sinal pseudoaleatório na faixa das amostras analisadas
+void benchmark_block_stats() {
+    static uint16_t bench[1024] __attribute__((aligned(4)));
+    uint32_t seed = 1;
+    for (uint i = 0; i < 1024; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        bench[i] = (uint16_t)(seed >> (20 - SAMPLE_SHIFT));
+    }
+
+    printf("\n-- ESTATÍSTICAS DO BLOCO (ciclos) --\n");
+    printf("%8s %8s %8s %8s\n", "amostras", "swar", "escalar", "iguais");
+    for (uint32_t len = 64; len <= 1024; len *= 2) {
+        block_stats_t swar, scalar;
+        uint32_t irq_state = save_and_disable_interrupts();
+        uint32_t start = profiling_now();
+        block_stats_compute(bench, len, SAMPLE_OFFSET, SAMPLE_SHIFT, AMPL_LEVEL_5, &swar);
+        uint32_t swar_cycles = (start - profiling_now()) & 0x00FFFFFF;
+        start = profiling_now();
+        block_stats_reference(bench, len, SAMPLE_OFFSET, SAMPLE_SHIFT, AMPL_LEVEL_5, &scalar);
+        uint32_t scalar_cycles = (start - profiling_now()) & 0x00FFFFFF;
+        restore_interrupts(irq_state);
+
+        bool same = swar.sum == scalar.sum && swar.square_sum == scalar.square_sum &&
+                    swar.peak == scalar.peak && swar.loud == scalar.loud;
+        printf("%8u %8u %8u %8s\n", (uint)len, (uint)swar_cycles, (uint)scalar_cycles, same ? "sim" : "NAO");
+    }
+}
+#endif
+
+// Comandos de um caractere recebidos pelo USB
+void serial_command_poll() {
+    int c = getchar_timeout_us(0);
+    if (c == PICO_ERROR_TIMEOUT) return;
+    if (c == 's') set_raw_stream(!raw_stream_on, to_ms_since_boot(get_absolute_time()));
+    if (raw_stream_on) return;  // Durante a captura bruta só 's' é aceito
+#if PROFILING_ENABLED
+    if (c == 'p') profiling_dump();
+    if (c == 'k') benchmark_block_stats();
+    if (c == 'z') {
+        profiling_reset();
+        printf("\n--> Perfil zerado\n");
+    }
+#else
+    if (c == 'p' || c == 'z' || c == 'k') printf("\n--> Perfil desativado neste build (use Debug ou MONITOR_PROFILING)\n");
+#endif
+    if (c == 'g') {
+        oled_graph = !oled_graph;
+        printf("\n--> Display: %s\n", oled_graph ? "Gráfico do nível" : "Texto");
+        if (!alert_busy(&alert)) {
+            show_monitor_screen();
+            display_update();
+        }
+    }
+    if (c == 'l') {
+        printf("\n--> Registro da flash (partida,t,n | minuto,t,LAeq,LAFmax,L10,L50,L90,pico,blocos_altos,alertas,lacuna_ms | alerta,t,regras,LAF)\n");
+        uint32_t records = event_log_read(&event_log, log_print_record, NULL);
+        printf("--> %u registros, partida %u, %u aguardando gravação, %u descartados\n",
+               (uint)records, (uint)event_log.boot_count, event_log.queued, (uint)event_log.dropped);
+    }
+}
+
+void log_print_record(void *ctx, const event_log_record_t *record) {
+    if (record->type == EVENT_LOG_BOOT) {
+        printf("partida,%u,%u\n", (uint)record->time_s, (uint)record->boot.count);
+    } else if (record->type == EVENT_LOG_MINUTE) {
+        const int16_t levels[5] = {
+            record->minute.laeq_db_x10, record->minute.lafmax_db_x10,
+            record->minute.l10_db_x10, record->minute.l50_db_x10, record->minute.l90_db_x10
+        };
+        printf("minuto,%u", (uint)record->time_s);
+        for (uint8_t i = 0; i < 5; i++) printf(",%i.%i", levels[i] / 10, abs(levels[i] % 10));
+        printf(",%u,%u,%u,%u\n", record->minute.peak_max, record->minute.loud_blocks, record->minute.alerts,
+               record->minute.gap_ms);
+    } else if (record->type == EVENT_LOG_ALERT) {
+        printf("alerta,%u,%u,%i.%i\n", (uint)record->time_s, (uint)record->alert.rules,
+               record->alert.laf_db_x10 / 10, abs(record->alert.laf_db_x10 % 10));
+    }
+}
+
+// Enquanto a flash é apagada ou programada nada pode executar dela: as
+// interrupções ficam desligadas só durante cada operação
+void log_flash_erase(uint32_t offset) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    flash_range_erase(EVENT_LOG_FLASH_OFFSET + offset, FLASH_SECTOR_SIZE);
+    restore_interrupts(irq_state);
+}
+
+void log_flash_program(uint32_t offset, const uint8_t *data) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    flash_range_program(EVENT_LOG_FLASH_OFFSET + offset, data, FLASH_PAGE_SIZE);
+    restore_interrupts(irq_state);
+}
+
+// Localiza o fim do registro e grava a partida. Roda antes do core 1 e da captura.
+void init_event_log() {
+    const event_log_flash_t flash = {
+        .base = (const uint8_t *)(XIP_BASE + EVENT_LOG_FLASH_OFFSET),
+        .sectors = EVENT_LOG_SECTORS,
+        .erase_sector = log_flash_erase,
+        .program_page = log_flash_program
+    };
+    event_log_init(&event_log, &flash);
+    level_stats_reset(&minute_stats);
+    event_log_commit(&event_log);
+}
+
+// Grava a fila do registro com o core 1 retido (ele executa da flash). Sem
+// apagamento são uma ou duas páginas de ~1 ms, menos que um bloco: a captura
+// continua e a ISR do DMA só atrasa. Quando um setor vai ser apagado (dezenas
+// de ms, uma vez a cada ~200 minutos) a captura é parada, com as interrupções
+// desligadas para o botão A não religá-la no meio, e o tempo parado entra no
+// próximo registro de minuto.
+void event_log_flush() {
+    if (!event_log_pending(&event_log)) return;
+#if ANALYSIS_ON_CORE1
+    multicore_lockout_start_blocking();
+#endif
+    if (event_log_commit_erases(&event_log)) {
+        uint32_t irq_state = save_and_disable_interrupts();
+        bool capturing = dma_enabled;
+        uint32_t stopped_at = time_us_32();
+        if (capturing) stop_capture();
+        event_log_commit(&event_log);
+        if (capturing) {
+            start_capture();
+            log_gap_ms += (time_us_32() - stopped_at + 999) / 1000;
+        }
+        restore_interrupts(irq_state);
+    } else {
+        event_log_commit(&event_log);
+    }
+#if ANALYSIS_ON_CORE1
+    multicore_lockout_end_blocking();
+#endif
+}
+
+// Acumula um minuto de medição; roda no core da análise e entrega o agregado
+// ao laço principal, que o grava.
+void log_collect(int32_t level, const block_stats_t *block) {
+    level_stats_add_block(&minute_stats, level, block->sum, block->square_sum, DMA_BUFFER_SIZE, block->peak, block->peak >= AMPL_LEVEL_5);
+    for (uint8_t k = 0; k < MIC_CHANNELS; k++) minute_power[k] += meters[k].block_ms;
+    if (minute_stats.blocks == 1 || level > minute_lafmax) minute_lafmax = level;
+    minute_samples += DMA_BUFFER_SIZE;
+    if (minute_samples < LOG_MINUTE_SAMPLES) return;
+
+    log_minute.type = EVENT_LOG_MINUTE;
+    // LAeq de cada microfone com o seu medidor; vale o maior, como no relatório
+    int32_t laeq = 0;
+    for (uint8_t k = 0; k < MIC_CHANNELS; k++) {
+        int32_t mic_laeq = metering_db_x10(&meters[k], minute_power[k] / minute_stats.blocks);
+        if (k == 0 || mic_laeq > laeq) laeq = mic_laeq;
+        minute_power[k] = 0;
+    }
+    log_minute.minute.laeq_db_x10 = (int16_t)laeq;
+    log_minute.minute.lafmax_db_x10 = (int16_t)minute_lafmax;
+    log_minute.minute.l10_db_x10 = (int16_t)level_stats_exceeded_db_x10(&minute_stats, 10);
+    log_minute.minute.l50_db_x10 = (int16_t)level_stats_exceeded_db_x10(&minute_stats, 50);
+    log_minute.minute.l90_db_x10 = (int16_t)level_stats_exceeded_db_x10(&minute_stats, 90);
+    log_minute.minute.peak_max = minute_stats.peak_max;
+    log_minute.minute.loud_blocks = (uint16_t)minute_stats.loud_blocks;
+    __mem_fence_release();
+    log_minute_ready = true;
+
+    level_stats_reset(&minute_stats);
+    minute_samples -= LOG_MINUTE_SAMPLES;
+}
+
+// Os alertas ficam na fila até a gravação do minuto
+void log_alert(uint32_t rules, uint32_t now) {
+    event_log_record_t record = { .type = EVENT_LOG_ALERT, .time_s = now / 1000 };
+    record.alert.rules = rules;
+    record.alert.laf_db_x10 = (int16_t)laf_db_x10;
+    event_log_append(&event_log, &record);
+    log_minute_alerts++;
+}
+
+// Prazo fixo: o escalonador avança em múltiplos exatos de DELAY_UART_MS. A janela
+// é fechada pela análise no próximo bloco e impressa pela tarefa de monitoramento.
+void report_task(uint32_t now) {
+    if (dma_enabled) report_requested = true;
+    else close_report_window();  // Sem captura não há blocos para fechar a janela
+}
+
+// Envia a captura bruta enquanto ativa e aplica o pedido feito pelos botões
+void stream_task(uint32_t now) {
+    if (raw_stream_toggle) {
+        raw_stream_toggle = false;
+        set_raw_stream(!raw_stream_on, now);
+    }
+    if (!raw_stream_on) return;
+    raw_stream_service(&raw_stream, usb_stream_write);
+    uint32_t irq_state = save_and_disable_interrupts();
+    tud_cdc_write_flush();
+    restore_interrupts(irq_state);
+}
+
+// O texto de início sai antes do primeiro quadro; o de fim, depois do último
+// (que pode ficar incompleto e é descartado pelo gravador)
+void set_raw_stream(bool on, uint32_t now) {
+    if (on == raw_stream_on) return;
+    if (on) {
+        printf("\n--> Captura bruta iniciada: %u microfone(s), %u Hz, análise %s\n", MIC_CHANNELS, ADC_SAMPLE_RATE_HZ,
+               RAW_STREAM_KEEP_ANALYSIS ? "mantida" : "suspensa");
+        raw_stream_start(&raw_stream);
+        raw_stream_on = true;
+        sched_every(&scheduler, task_stream, now, STREAM_INTERVAL_MS);
+    } else {
+        raw_stream_on = false;
+        sched_cancel(&scheduler, task_stream);
+        printf("\n--> Captura bruta encerrada: %u blocos enviados, %u pulados, %u sobrescritos\n",
+               (uint)raw_stream.frames, (uint)raw_stream.skipped, (uint)raw_stream.overwritten);
+    }
+}
+
+// Entrega ao FIFO do CDC só o que cabe nele. A pilha do USB também roda na IRQ
+// de baixa prioridade do stdio_usb, então as chamadas ficam com as interrupções
+// desligadas. Sem terminal aberto os bytes são descartados, para o anel não parar.
+size_t usb_stream_write(const uint8_t *data, size_t len) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    size_t accepted = len;
+    if (tud_cdc_connected()) {
+        uint32_t space = tud_cdc_write_available();
+        accepted = tud_cdc_write(data, len < space ? len : space);
+    }
+    restore_interrupts(irq_state);
+    return accepted;
+}
+
+// Copia as estatísticas da janela e reinicia a acumulação. Roda entre dois blocos
+// no core da análise, então a cópia é consistente.
+void close_report_window() {
+    report_stats = window_stats;
+    for (uint8_t k = 0; k < MIC_CHANNELS; k++) {
+        report_mic_laeq_db_x10[k] = metering_laeq_db_x10(&meters[k]);
+        report_mic_lafmax_db_x10[k] = metering_lafmax_db_x10(&meters[k]);
+        report_dc_x10[k] = (dc_tracker_level(&dc_trackers[k]) * 10) >> SAMPLE_SHIFT;
+        if (k == 0 || report_mic_laeq_db_x10[k] > report_laeq_db_x10) report_laeq_db_x10 = report_mic_laeq_db_x10[k];
+        if (k == 0 || report_mic_lafmax_db_x10[k] > report_lafmax_db_x10) report_lafmax_db_x10 = report_mic_lafmax_db_x10[k];
+        metering_reset_window(&meters[k]);
+    }
+#if CAPTURE_TEMPERATURE
+    // Sensor do RP2040: 0,706 V a 27 °C e -1,721 mV/°C, com referência de 3,3 V
+    if (temperature_samples) {
+        float volts = (float)temperature_sum / temperature_samples * 3.3f / 4096.f;
+        report_temperature_x10 = (int32_t)lroundf(270.f - (volts - 0.706f) / 0.0001721f);
+    }
+    temperature_sum = 0;
+    temperature_samples = 0;
+#endif
+    level_stats_reset(&window_stats);
+    for (uint8_t c = 0; c < SOUND_CLASS_COUNT; c++) {
+        report_class_blocks[c] = window_class_blocks[c];
+        window_class_blocks[c] = 0;
+    }
+    report_requested = false;
+    __mem_fence_release();
+    report_ready = true;
+}
+
+void print_report() {
+    if (!serial_on || raw_stream_on) return;
+    const level_stats_t *st = &report_stats;
+    int32_t l10 = level_stats_exceeded_db_x10(st, 10);
+    int32_t l50 = level_stats_exceeded_db_x10(st, 50);
+    int32_t l90 = level_stats_exceeded_db_x10(st, 90);
+    int32_t las = las_db_x10;
+
+    printf("\n");
+    printf("RELATÓRIO GERADO A CADA -- %ims --:\n", DELAY_UART_MS);
+    printf("Nível da Amplitude Máxima -- %u\n", st->peak_max);
+    printf("Nível Médio de Amplitudes maiores que %i -- %u\n", AMPL_LEVEL_5, (uint)level_stats_mean_loud_peak(st));
+    printf("Quantidade de blocos com pico maior que %i -- %u\n", AMPL_LEVEL_5, (uint)st->loud_blocks);
+    printf("Nível Médio de Amplitude -- %u\n", (uint)level_stats_mean_amplitude(st));
+    printf("Amplitude RMS -- %u\n", (uint)level_stats_rms_amplitude(st));
+    printf("Quantidade de amostras: -- %llu\n", (unsigned long long)st->samples);
+    printf("LAeq da janela -- %i.%i dB\n", report_laeq_db_x10 / 10, abs(report_laeq_db_x10 % 10));
+    printf("LAF máximo da janela -- %i.%i dB\n", report_lafmax_db_x10 / 10, abs(report_lafmax_db_x10 % 10));
+    if (MIC_CHANNELS > 1) {
+        for (uint8_t k = 0; k < MIC_CHANNELS; k++) {
+            printf("Microfone ADC%u: LAeq / LAFmax -- %i.%i / %i.%i dB\n", mic_inputs[k],
+                   report_mic_laeq_db_x10[k] / 10, abs(report_mic_laeq_db_x10[k] % 10),
+                   report_mic_lafmax_db_x10[k] / 10, abs(report_mic_lafmax_db_x10[k] % 10));
+        }
+    }
+    printf("L10 / L50 / L90 -- %i.%i / %i.%i / %i.%i dB\n", l10 / 10, abs(l10 % 10), l50 / 10, abs(l50 % 10), l90 / 10, abs(l90 % 10));
+    printf("LAS atual -- %i.%i dB\n", las / 10, abs(las % 10));
+    printf("Blocos por classe (silêncio / contínuo / fala / impulso) -- %u / %u / %u / %u\n",
+           (uint)report_class_blocks[SOUND_CLASS_QUIET], (uint)report_class_blocks[SOUND_CLASS_STEADY],
+           (uint)report_class_blocks[SOUND_CLASS_SPEECH], (uint)report_class_blocks[SOUND_CLASS_IMPULSE]);
+    printf("Impulsos detectados (total) -- %u\n", (uint)sound_class.impulses);
+    printf("Alertas disparados (picos / LAeq %is / conversa) -- %u / %u / %u\n", LEQ_RULE_WINDOW_MS / 1000,
+           (uint)alert_rules.rules[rule_peaks].fired, (uint)alert_rules.rules[rule_leq].fired,
+           (uint)alert_rules.rules[rule_talk].fired);
+    for (uint8_t k = 0; k < MIC_CHANNELS; k++) {
+        printf("Nível DC estimado do microfone ADC%u -- %i.%i (nominal %i)\n", mic_inputs[k], report_dc_x10[k] / 10, report_dc_x10[k] % 10, SILENCE_LEVEL);
+    }
+#if CAPTURE_TEMPERATURE
+    printf("Temperatura do chip -- %i.%i °C\n", report_temperature_x10 / 10, abs(report_temperature_x10 % 10));
+#endif
+    printf("Blocos perdidos por overrun (total) -- %u\n", (uint)capture_ring_overruns(&capture_ring));
+    printf("Blocos descartados com a fila cheia (total) -- %u\n", (uint)block_queue_dropped(&block_queue));
 }
 
 void setup() {
+#if PROFILING_ENABLED
+    profiling_reset();
+    profiling_init();
+#endif
+    init_scheduler();
+    isr_log_init(&isr_log);
     init_buttons();
-    void init_buzzers();
+    init_buzzers();
     init_matrix_leds();
+    init_event_log();
+    if (ANALYSIS_ON_CORE1) multicore_launch_core1(core1_main);
     setup_adc_dma();
     init_i2c_display(&ssd);
+    init_telemetry();
+    alert_init(&alert);
+}
+
+// Antes dos periféricos, pois a ISR do DMA já sinaliza a tarefa de análise
+void init_scheduler() {
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    sched_init(&scheduler);
+    task_analysis = sched_add(&scheduler, analysis_task, PRIO_ANALYSIS);
+    task_alert = sched_add(&scheduler, alert_task, PRIO_ALERT);
+    task_display = sched_add(&scheduler, display_task, PRIO_DISPLAY);
+    task_monitor = sched_add(&scheduler, monitor_task, PRIO_MONITOR);
+    task_report = sched_add(&scheduler, report_task, PRIO_REPORT);
+    task_stream = sched_add(&scheduler, stream_task, PRIO_STREAM);
+    sched_every(&scheduler, task_monitor, now, MONITOR_INTERVAL_MS);
+    sched_every(&scheduler, task_report, now, DELAY_UART_MS);
 }
 
 void init_buttons() {
@@ -149,7 +874,8 @@ void init_buttons() {
         gpio_init(buttons[i]);
         gpio_set_dir(buttons[i], GPIO_IN);
         gpio_pull_up(buttons[i]);
-        gpio_set_irq_enabled_with_callback(buttons[i], GPIO_IRQ_EDGE_FALL, true, button_irq_handler);
+        uint32_t edges = buttons[i] == BUTTON_B_PIN ? GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+        gpio_set_irq_enabled_with_callback(buttons[i], edges, true, button_irq_handler);
     }
 }
 
@@ -170,6 +896,43 @@ void init_matrix_leds() {
     uint offset = pio_add_program(pio, &pio_matrix_program);
     pio_matrix_program_init(pio, sm, offset, MATRIZ_LEDS_PIN);
     pio_sm_set_enabled(pio, sm, true);
+    set_led_brightness(LED_BRIGHTNESS);
+
+    // Um word de 32 bits por LED, no ritmo do FIFO de TX da máquina de estados
+    led_dma = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(led_dma);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(led_dma, &cfg, &pio->txf[sm], led_frame, NUM_LEDS, false);
+}
+
+void init_telemetry() {
+    uart_init(TELEMETRY_UART, TELEMETRY_BAUD);
+    gpio_set_function(TELEMETRY_TX_PIN, GPIO_FUNC_UART);
+    telemetry_queue_init(&telemetry_queue);
+
+    telemetry_dma = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(telemetry_dma);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, uart_get_dreq(TELEMETRY_UART, true));
+    dma_channel_configure(telemetry_dma, &cfg, &uart_get_hw(TELEMETRY_UART)->dr, telemetry_tx, 0, false);
+}
+
+// Com o DMA da UART livre, codifica os registros pendentes e inicia o próximo envio
+void telemetry_service() {
+    if (dma_channel_is_busy(telemetry_dma)) return;
+
+    telemetry_record_t record;
+    uint16_t dropped = telemetry_queue_dropped(&telemetry_queue);
+    size_t len = 0;
+    for (uint8_t i = 0; i < TELEMETRY_TX_FRAMES && telemetry_queue_pop(&telemetry_queue, &record); i++) {
+        len += telemetry_encode_frame(&record, dropped, &telemetry_tx[len]);
+    }
+    if (len > 0) dma_channel_transfer_from_buffer_now(telemetry_dma, telemetry_tx, len);
 }
 
 void init_i2c_display(ssd1306_t *ssd) {
@@ -181,165 +944,421 @@ void init_i2c_display(ssd1306_t *ssd) {
 
     ssd1306_init(ssd, SSD_WIDTH, SSD_HEIGHT, false, SSD_ADDR, I2C_PORT);
     ssd1306_config(ssd);
+    level_graph_init(&level_graph, GRAPH_X0, SSD_WIDTH - GRAPH_X0, GRAPH_MIN_DB_X10, GRAPH_MAX_DB_X10, DB_LEVEL_5);
     ssd1306_fill(ssd, false);
     ssd1306_send_data(ssd);
 }
 
 void dma_irq_handler() {
-    if (dma_channel_get_irq0_status(dma_channel) && dma_enabled) {
-        dma_channel_acknowledge_irq0(dma_channel);
-        uint16_t peak_amplitude = 0;
-        for (uint i = 0; i < DMA_BUFFER_SIZE; i++) {
-            int16_t adjusted = (int16_t)mic_buffer[i] - SILENCE_LEVEL;
-            uint16_t amplitude = (adjusted >= 0) ? adjusted : -adjusted;
+    PROF_BEGIN(PROF_STAGE_DMA_IRQ);
+#if PROFILING_ENABLED
+    // Bit de erro do FIFO: o DMA não acompanhou o ADC (escrever 1 limpa)
+    if (adc_hw->fcs & ADC_FCS_OVER_BITS) {
+        hw_set_bits(&adc_hw->fcs, ADC_FCS_OVER_BITS);
+        profiling_count_adc_overrun();
+    }
+#endif
+    // Os canais se alternam; trata na ordem de término caso os dois estejam pendentes
+    while (dma_channel_get_irq0_status(dma_channels[next_dma])) {
+        uint ch = dma_channels[next_dma];
+        dma_channel_acknowledge_irq0(ch);
+        uint32_t seq;
+        uint32_t slot = capture_ring_block_done(&capture_ring, &seq);
+        dma_channel_set_write_addr(ch, mic_buffer[slot], false);
+        next_dma ^= 1;
+        block_queue_push(&block_queue, mic_buffer[seq % CAPTURE_BLOCKS], seq);
+    }
+    wake_analysis();
+    PROF_END(PROF_STAGE_DMA_IRQ);
+}
 
-            sum_sounds += amplitude;
-            count_sounds++;
+// Chamada das ISRs do core 0 para o core da análise consumir a fila e os pedidos
+void wake_analysis() {
+    if (ANALYSIS_ON_CORE1) __sev();  // Acorda o core 1 do __wfe()
+    else sched_post(&scheduler, task_analysis);
+}
 
-            if (amplitude > peak_amplitude) peak_amplitude = amplitude;
+// Consome os blocos publicados pela ISR, descartando os que o DMA já sobrescreveu
+void analysis_drain() {
+    capture_block_t block;
+    while (block_queue_pop(&block_queue, &block)) {
+        if (!capture_ring_validate(&capture_ring, block.seq)) continue;
+        PROF_BEGIN(PROF_STAGE_ANALYSIS);
+        const volatile uint16_t *lanes = block.samples;  // Entrada k em lanes[k * CAPTURE_CHANNEL_SAMPLES]
+#if ADC_INPUTS > 1
+        deinterleave(block.samples, CAPTURE_CHANNEL_SAMPLES, ADC_INPUTS, adc_lanes);
+        lanes = adc_lanes;
+#endif
+        bool analyze = !raw_stream_on || RAW_STREAM_KEEP_ANALYSIS;
+#if OVERSAMPLE_FACTOR > 1
+        // Decima direto no anel da captura bruta, antes de analisar, para só usar
+        // o bloco bruto se o DMA não o alcançou; o envio lê o mesmo buffer
+        uint16_t *decimated = raw_stream_slot(&raw_stream);
+        for (uint8_t k = 0; k < MIC_CHANNELS; k++) {
+            decimator_process(&decimators[k], lanes + k * CAPTURE_CHANNEL_SAMPLES, CAPTURE_CHANNEL_SAMPLES, decimated + k * DMA_BUFFER_SIZE);
+        }
+        if (capture_ring_validate(&capture_ring, block.seq)) {
+#if CAPTURE_TEMPERATURE
+            temperature_collect(adc_lanes + MIC_CHANNELS * CAPTURE_CHANNEL_SAMPLES);
+#endif
+            if (analyze) process_block(decimated, block.seq);
+            raw_stream_publish(&raw_stream, block.seq);
         }
+#else
+        // Sem decimador as amostras vêm do anel do DMA, que não pode esperar o
+        // USB; só durante a captura bruta elas são copiadas para o anel do envio
+        bool streaming = raw_stream_on;
+        if (analyze) process_block(lanes, block.seq);
+        if (streaming) {
+            uint16_t *out = raw_stream_slot(&raw_stream);
+            for (uint32_t i = 0; i < MIC_CHANNELS * DMA_BUFFER_SIZE; i++) out[i] = lanes[i];
+        }
+        if (capture_ring_validate(&capture_ring, block.seq)) {
+#if CAPTURE_TEMPERATURE
+            temperature_collect(adc_lanes + MIC_CHANNELS * CAPTURE_CHANNEL_SAMPLES);
+#endif
+            if (streaming) raw_stream_publish(&raw_stream, block.seq);
+        }
+#endif
+        PROF_END(PROF_STAGE_ANALYSIS);
+    }
+    // Depois dos blocos que já estavam na fila, para nenhum deles reacender a matriz
+    if (leds_clear_requested) {
+        leds_clear_requested = false;
+        clear_leds();
+    }
+}
 
-        max_peak = peak_amplitude > max_peak ? peak_amplitude : max_peak;
+#if CAPTURE_TEMPERATURE
+void temperature_collect(const uint16_t *samples) {
+    for (uint32_t i = 0; i < CAPTURE_CHANNEL_SAMPLES; i++) temperature_sum += samples[i];
+    temperature_samples += CAPTURE_CHANNEL_SAMPLES;
+}
+#endif
+
+void core1_main() {
+#if PROFILING_ENABLED
+    profiling_init();
+#endif
+    multicore_lockout_victim_init();  // Permite reter este core durante a gravação da flash
+    while (true) {
+        analysis_drain();
+        __wfe();
+    }
+}
 
-        uint8_t height = 0;
-        if (peak_amplitude >= AMPL_LEVEL_1) {
-            if (peak_amplitude < AMPL_LEVEL_2) height = 1;
-            else if (peak_amplitude < AMPL_LEVEL_3) height = 2;
-            else if (peak_amplitude < AMPL_LEVEL_4) height = 3;
-            else if (peak_amplitude < AMPL_LEVEL_5) height = 4;
-            else {height = 5; sum_peaks += peak_amplitude; count_peaks++;}
+// `samples` traz DMA_BUFFER_SIZE amostras de cada microfone, uma entrada após a outra.
+// Cada microfone tem seu nível DC e seu medidor; o de maior LAF no bloco define
+// o nível, as estatísticas e os alertas.
+void process_block(const volatile uint16_t *samples, uint32_t seq) {
+    // A janela fecha antes do bloco: o relatório tem exatamente os blocos processados
+    // até o pedido, e este entra inteiro na janela nova (medidores, histograma e classes)
+    if (report_requested) close_report_window();
+
+    block_stats_t blocks[MIC_CHANNELS];
+    bool settled = true;  // Enquanto algum microfone calibra o nível DC não há estatísticas nem alertas
+    for (uint8_t k = 0; k < MIC_CHANNELS; k++) {
+        const volatile uint16_t *mic = samples + k * DMA_BUFFER_SIZE;
+        block_stats_compute(mic, DMA_BUFFER_SIZE, (uint16_t)dc_tracker_level(&dc_trackers[k]), SAMPLE_SHIFT, AMPL_LEVEL_5, &blocks[k]);
+        dc_tracker_process(&dc_trackers[k], mic, DMA_BUFFER_SIZE);
+        meters[k].offset = dc_tracker_level(&dc_trackers[k]);
+        settled &= dc_tracker_settled(&dc_trackers[k]);
+        metering_process_block(&meters[k], mic, DMA_BUFFER_SIZE);
+        if (k == 0 || meters[k].fast_ms > meters[loud_mic].fast_ms) loud_mic = k;
+    }
+    const block_stats_t block = blocks[loud_mic];
+    spectrum.offset = dc_tracker_level(&dc_trackers[PRIMARY_MIC]);
+
+    int32_t level = metering_laf_db_x10(&meters[loud_mic]);
+    laf_db_x10 = level;
+    las_db_x10 = metering_las_db_x10(&meters[loud_mic]);
+    if (settled) level_stats_add_block(&window_stats, level, block.sum, block.square_sum, DMA_BUFFER_SIZE, block.peak, block.peak >= AMPL_LEVEL_5);
+
+    uint8_t height = level_to_height(level);
+    if (settled) {
+        PROF_BEGIN(PROF_STAGE_CLASSIFY);
+        sound_class_label_t label = sound_class_process_block(&sound_class, samples + loud_mic * DMA_BUFFER_SIZE,
+                                                              DMA_BUFFER_SIZE, &meters[loud_mic], &block);
+        PROF_END(PROF_STAGE_CLASSIFY);
+        window_class_blocks[label]++;
+        uint32_t fired = alert_rules_update(&alert_rules, &meters[loud_mic], label);
+        if (fired) {
+            alert_fired_rules = fired;
+            __mem_fence_release();
+            alert_fired_seq++;
         }
+        log_collect(level, &block);
+        graph_collect(level);
+    }
+    if (serial_on) telemetry_collect(seq, block.peak, block.sum, block.loud);
 
-        if (height == 5) amplitude_peak_count++;
+    if (display_mode == MODE_SPECTRUM) spectrum_feed(&spectrum, samples + PRIMARY_MIC * DMA_BUFFER_SIZE, DMA_BUFFER_SIZE);
 
-        uint32_t current_time = to_ms_since_boot(get_absolute_time());
-        if (current_time - last_update_time >= UPDATE_INTERVAL_MS) {
+    uint32_t current_time = to_ms_since_boot(get_absolute_time());
+    if (dma_enabled && current_time - last_update_time >= UPDATE_INTERVAL_MS) {  // Não reacende a matriz após parar a captura
+        if (display_mode == MODE_SPECTRUM) {
+            for (uint8_t i = 0; i < SPECTRUM_BANDS; i++) {
+                heights[i] = level_to_height(spectrum_band_db_x10(&spectrum, i, METER_CAL_DB_X10));
+            }
+        } else {
             for (uint8_t i = 0; i < 4; i++) {
                 heights[i] = heights[i + 1];
             }
             heights[4] = height;
-            update_leds();
-            last_update_time = current_time;
         }
+        PROF_BEGIN(PROF_STAGE_LEDS);
+        update_leds();
+        PROF_END(PROF_STAGE_LEDS);
+        last_update_time = current_time;
+    }
+}
+
+// Publica o maior LAF de cada GRAPH_BLOCKS_PER_COLUMN blocos para o gráfico do display
+void graph_collect(int32_t level) {
+    if (graph_blocks == 0 || level > graph_peak) graph_peak = level;
+    if (++graph_blocks < GRAPH_BLOCKS_PER_COLUMN) return;
+    graph_blocks = 0;
+    graph_column_db_x10 = (int16_t)graph_peak;
+    __mem_fence_release();
+    graph_column_seq++;
+}
 
-        dma_channel_set_write_addr(dma_channel, mic_buffer, true);
+// Acumula TELEMETRY_BLOCKS_PER_RECORD blocos em um registro e o publica para o
+// laço principal. Pico e contagens cobrem todos os blocos; o nível RMS é o do último.
+void telemetry_collect(uint32_t seq, uint16_t peak, uint32_t sum, uint16_t peak_samples) {
+    if (telemetry_acc_blocks == 0) {
+        telemetry_acc.peak = 0;
+        telemetry_acc.peak_samples = 0;
+        telemetry_acc_sum = 0;
     }
+    if (peak > telemetry_acc.peak) telemetry_acc.peak = peak;
+    telemetry_acc.peak_samples += peak_samples;
+    telemetry_acc_sum += sum;
+    if (++telemetry_acc_blocks < TELEMETRY_BLOCKS_PER_RECORD) return;
+
+    telemetry_acc.seq = seq;
+    telemetry_acc.timestamp_us = time_us_32();
+    telemetry_acc.mean = telemetry_acc_sum / (telemetry_acc_blocks * DMA_BUFFER_SIZE);
+    telemetry_acc.block_db_x10 = metering_db_x10(&meters[loud_mic], meters[loud_mic].block_ms);
+    telemetry_acc.laf_db_x10 = laf_db_x10;
+    telemetry_acc.alert_peaks = (uint16_t)alert_rules.rules[rule_peaks].value;
+    telemetry_acc.overruns = capture_ring_overruns(&capture_ring);
+    telemetry_acc.dropped_blocks = block_queue_dropped(&block_queue);
+    telemetry_queue_push(&telemetry_queue, &telemetry_acc);
+    telemetry_acc_blocks = 0;
+}
+
+uint8_t level_to_height(int32_t level) {
+    if (level < DB_LEVEL_1) return 0;
+    if (level < DB_LEVEL_2) return 1;
+    if (level < DB_LEVEL_3) return 2;
+    if (level < DB_LEVEL_4) return 3;
+    if (level < DB_LEVEL_5) return 4;
+    return 5;
 }
 
 void setup_adc_dma() {
     adc_init();
-    adc_gpio_init(MICROPHONE_PIN);
-    adc_select_input(MIC_CHANNEL);
+    for (uint8_t input = 0, k = 0; input < 4; input++) {
+        if (!(MIC_CHANNEL_MASK & (1u << input))) continue;
+        adc_gpio_init(26 + input);
+        mic_inputs[k] = input;
+        metering_init(&meters[k], ADC_SAMPLE_RATE_HZ, DMA_BUFFER_SIZE, SAMPLE_OFFSET, SAMPLE_SHIFT, METER_CAL_DB_X10);
+        dc_tracker_init(&dc_trackers[k], SAMPLE_OFFSET, DC_SETTLE_MS * ADC_SAMPLE_RATE_HZ / 1000);
+#if OVERSAMPLE_FACTOR > 1
+        decimator_init(&decimators[k], OVERSAMPLE_FACTOR, SILENCE_LEVEL);
+#endif
+        k++;
+    }
+    adc_set_temp_sensor_enabled(CAPTURE_TEMPERATURE);
+    adc_set_round_robin(ADC_INPUTS > 1 ? ADC_ROUND_ROBIN_MASK : 0);
+    adc_select_input(__builtin_ctz(ADC_ROUND_ROBIN_MASK));
     adc_fifo_setup(true, true, 1, false, false);
     adc_set_clkdiv(ADC_CLK_DIV);
+    level_stats_reset(&window_stats);
+    spectrum_init(&spectrum, SAMPLE_OFFSET, SAMPLE_SHIFT);
+    alert_rules_init(&alert_rules, ADC_SAMPLE_RATE_HZ, DMA_BUFFER_SIZE);
+    rule_peaks = alert_rules_add(&alert_rules, &peak_rule);
+    rule_leq = alert_rules_add(&alert_rules, &leq_rule);
+    rule_talk = alert_rules_add(&alert_rules, &talk_rule);
+    sound_class_init(&sound_class, &sound_class_config, ADC_SAMPLE_RATE_HZ, DMA_BUFFER_SIZE, SAMPLE_SHIFT,
+                     METER_CAL_DB_X10);
 
-    dma_channel = dma_claim_unused_channel(true);
-    dma_cfg = dma_channel_get_default_config(dma_channel);
-    channel_config_set_transfer_data_size(&dma_cfg, DMA_SIZE_16);
-    channel_config_set_read_increment(&dma_cfg, false);
-    channel_config_set_write_increment(&dma_cfg, true);
-    channel_config_set_dreq(&dma_cfg, DREQ_ADC);
-    dma_channel_set_irq0_enabled(dma_channel, true);
+    // Dois canais encadeados em ping-pong: quando um termina, o outro já está
+    // armado e dispara sozinho, então o FIFO do ADC nunca fica sem leitor.
+    dma_channels[0] = dma_claim_unused_channel(true);
+    dma_channels[1] = dma_claim_unused_channel(true);
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_cfgs[i] = dma_channel_get_default_config(dma_channels[i]);
+        channel_config_set_transfer_data_size(&dma_cfgs[i], DMA_SIZE_16);
+        channel_config_set_read_increment(&dma_cfgs[i], false);
+        channel_config_set_write_increment(&dma_cfgs[i], true);
+        channel_config_set_dreq(&dma_cfgs[i], DREQ_ADC);
+        channel_config_set_chain_to(&dma_cfgs[i], dma_channels[i ^ 1]);
+        dma_channel_set_irq0_enabled(dma_channels[i], true);
+    }
 
     irq_set_exclusive_handler(DMA_IRQ_0, dma_irq_handler);
     irq_set_enabled(DMA_IRQ_0, true);
 
-    dma_channel_configure(dma_channel, &dma_cfg, mic_buffer, &adc_hw->fifo, DMA_BUFFER_SIZE, true);
+    capture_ring_init(&capture_ring, CAPTURE_BLOCKS);
+    block_queue_init(&block_queue);
+    raw_stream_init(&raw_stream, stream_blocks[0], ADC_SAMPLE_RATE_HZ, DMA_BUFFER_SIZE, MIC_CHANNELS, SAMPLE_SHIFT, SAMPLE_OFFSET);
+    start_capture();
+}
+
+// Retoma a captura de onde o anel parou, para que as sequências continuem válidas
+// para blocos que ainda estejam na fila do core 1.
+void start_capture() {
+    uint8_t first = next_dma, second = next_dma ^ 1;
+    adc_select_input(__builtin_ctz(ADC_ROUND_ROBIN_MASK));  // O rodízio recomeça junto com o bloco
+    adc_fifo_drain();
+    dma_channel_configure(dma_channels[second], &dma_cfgs[second], mic_buffer[capture_ring_slot(&capture_ring, 1)], &adc_hw->fifo, CAPTURE_BLOCK_SAMPLES, false);
+    dma_channel_configure(dma_channels[first], &dma_cfgs[first], mic_buffer[capture_ring_slot(&capture_ring, 0)], &adc_hw->fifo, CAPTURE_BLOCK_SAMPLES, true);
     adc_run(true);
 }
 
+void stop_capture() {
+    adc_run(false);
+    // Os canais encadeados precisam ser abortados juntos para um não religar o
+    // outro, e com a IRQ desligada, pois o abort pode sinalizar término espúrio.
+    for (uint8_t i = 0; i < 2; i++) dma_channel_set_irq0_enabled(dma_channels[i], false);
+    dma_hw->abort = (1u << dma_channels[0]) | (1u << dma_channels[1]);
+    while (dma_hw->abort) tight_loop_contents();
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_acknowledge_irq0(dma_channels[i]);
+        dma_channel_set_irq0_enabled(dma_channels[i], true);
+    }
+}
+
+// As mensagens vão para a fila isr_log e são impressas pela tarefa de monitoramento,
+// pois o printf aqui poderia bloquear e atrasar a ISR do DMA
 void button_irq_handler(uint gpio, uint32_t events) {
     uint32_t current_time = to_ms_since_boot(get_absolute_time());
+
+    // Botão B age ao soltar: clique curto alterna os buzzers, clique longo o modo da matriz
+    if (gpio == BUTTON_B_PIN) {
+        if ((events & GPIO_IRQ_EDGE_FALL) && button_b_pressed_at == 0 && current_time - event_time > 200) {
+            button_b_pressed_at = current_time;
+        } else if ((events & GPIO_IRQ_EDGE_RISE) && button_b_pressed_at != 0 && current_time - button_b_pressed_at > 50) {
+            if (current_time - button_b_pressed_at >= LONG_PRESS_MS) {
+                display_mode = display_mode == MODE_HISTORY ? MODE_SPECTRUM : MODE_HISTORY;
+                if (serial_on) isr_log_push(&isr_log, time_us_32(), ISR_MSG_MATRIX_MODE, display_mode);
+            } else {
+                buzzers_enable = !buzzers_enable;
+                if (serial_on) isr_log_push(&isr_log, time_us_32(), ISR_MSG_BUZZERS, buzzers_enable);
+            }
+            button_b_pressed_at = 0;
+            event_time = current_time;
+        }
+        return;
+    }
+
     if (current_time - event_time > 200) {
         event_time = current_time;
 
         if (gpio == BUTTON_A_PIN) {
             dma_enabled = !dma_enabled;
             if (dma_enabled) {
-                adc_run(true);
-                dma_channel_set_irq0_enabled(dma_channel, true);
-                dma_channel_configure(dma_channel, &dma_cfg, mic_buffer, &adc_hw->fifo, DMA_BUFFER_SIZE, true);
+                start_capture();
             } else {
-                adc_run(false);
-                dma_channel_set_irq0_enabled(dma_channel, false);
-                for (uint8_t i = 0; i < NUM_LEDS; i++) {
-                    pio_sm_put_blocking(pio, sm, matrix_led_color(0.0, 0.0, 0.0));
-                }
+                stop_capture();
+                leds_clear_requested = true;  // A matriz é do core da análise
+                wake_analysis();
             }
-            if (serial_on) printf("\n--> Captação de Som foi: %s\n", dma_enabled ? "Ativada" : "Desativada");
-        }
-
-        if (gpio == BUTTON_B_PIN) {
-            buzzers_enable = !buzzers_enable;
-            if (serial_on) printf("\n--> Buzzers Passivos foram: %s\n", buzzers_enable ? "Ativados" : "Desativados");
+            if (serial_on) isr_log_push(&isr_log, time_us_32(), ISR_MSG_CAPTURE, dma_enabled);
         }
 
-        if (gpio == BUTTON_JOY_PIN) {
+        // Com o Botão B pressionado o Joystick alterna a captura bruta, e o B solto depois não age
+        if (gpio == BUTTON_JOY_PIN && !gpio_get(BUTTON_B_PIN)) {
+            button_b_pressed_at = 0;
+            raw_stream_toggle = true;
+            sched_post(&scheduler, task_stream);
+        } else if (gpio == BUTTON_JOY_PIN) {
             serial_on = !serial_on;
-            if (serial_on) printf("\n-- COMUNICAÇÃO ATIVADA --\n");
+            if (serial_on) isr_log_push(&isr_log, time_us_32(), ISR_MSG_SERIAL_ON, 0);
         }
     }
 }
 
+// Monta o quadro a partir da paleta e entrega ao DMA, que alimenta o FIFO do PIO
+// sozinho. Se o quadro anterior ainda estiver saindo, este é pulado.
 void update_leds() {
-    uint32_t colors[NUM_LEDS] = {0};
-    for (uint index_1 = 0; index_1 < 5; index_1++) {
-        if (heights[index_1] > 0) {
-            float red = 0.0, green = 0.0, blue = 0.0;
-            switch (heights[index_1]) {
-                case 1: red = 0.0; green = 1.0; blue = 0.0; break;
-                case 2: red = 0.5; green = 0.75; blue = 0.0; break;
-                case 3: red = 1.0; green = 1.0; blue = 0.0; break;
-                case 4: red = 1.0; green = 0.5; blue = 0.0; break;
-                case 5: red = 1.0; green = 0.0; blue = 0.0; break;
-                default: red = 0.0; green = 0.0; blue = 0.0; break;
-            }
-            uint32_t color = matrix_led_color(red, green, blue);
-            for (uint index_2 = 0; index_2 < heights[index_1]; index_2++) {
-                colors[coluns_index[index_1][index_2]] = color;
-            }
+    if (dma_channel_is_busy(led_dma)) return;
+    for (uint8_t i = 0; i < NUM_LEDS; i++) led_frame[i] = 0;
+    for (uint8_t column = 0; column < 5; column++) {
+        uint32_t color = led_palette[heights[column]];
+        for (uint8_t row = 0; row < heights[column]; row++) {
+            led_frame[coluns_index[column][row]] = color;
         }
     }
+    dma_channel_transfer_from_buffer_now(led_dma, led_frame, NUM_LEDS);
+}
+
+// Só no core da análise: espera o quadro em andamento (no máximo ~1 ms) para não
+// sobrescrever o led_frame que o DMA ainda está lendo
+void clear_leds() {
+    dma_channel_wait_for_finish_blocking(led_dma);
+    for (uint8_t i = 0; i < NUM_LEDS; i++) led_frame[i] = 0;
+    dma_channel_transfer_from_buffer_now(led_dma, led_frame, NUM_LEDS);
+}
 
-    for (uint8_t i = 0; i < NUM_LEDS; i++) {
-        pio_sm_put_blocking(pio, sm, colors[i]);
+// Escala cada canal da paleta por brightness/256, só com inteiros
+void set_led_brightness(uint16_t brightness) {
+    if (brightness > 256) brightness = 256;
+    for (uint8_t i = 0; i < 6; i++) {
+        uint32_t color = 0;
+        for (uint8_t shift = 8; shift <= 24; shift += 8) {
+            uint32_t channel = (level_palette[i] >> shift) & 0xFF;
+            color |= ((channel * brightness) >> 8) << shift;
+        }
+        led_palette[i] = color;
     }
 }
 
+// Agenda o alerta de ruído. A tarefa do alerta cuida dos buzzers e da borda sem
+// bloquear o laço principal; alertas durante outro em andamento são ignorados.
 void noise_alert() {
-    uint buzzer_slice = pwm_gpio_to_slice_num(BUZZER_A_PIN);
-
-    if (buzzers_enable) {
-        pwm_set_chan_level(buzzer_slice, PWM_CHAN_A, BUZZER_WRAP / 2);
-        pwm_set_chan_level(buzzer_slice, PWM_CHAN_B, BUZZER_WRAP / 2);
-        pwm_set_enabled(buzzer_slice, true);
-    }
+    if (alert_busy(&alert)) return;
+    alert_schedule(&alert, &noise_alert_pattern);
+    sched_in(&scheduler, task_alert, to_ms_since_boot(get_absolute_time()), 0);
+}
 
-    ssd1306_fill(&ssd, false);
-    ssd1306_draw_string(&ssd, "SILENCIO", (SSD_WIDTH/2) - ((sizeof("SILENCIO") * 8) / 2), 31);
+void set_buzzers(bool on) {
+    uint buzzer_slice = pwm_gpio_to_slice_num(BUZZER_A_PIN);
+    pwm_set_chan_level(buzzer_slice, PWM_CHAN_A, on ? BUZZER_WRAP / 2 : 0);
+    pwm_set_chan_level(buzzer_slice, PWM_CHAN_B, on ? BUZZER_WRAP / 2 : 0);
+    pwm_set_enabled(buzzer_slice, on);
+}
 
-    last_buzzer_on = to_ms_since_boot(get_absolute_time());
-    while (to_ms_since_boot(get_absolute_time()) - last_buzzer_on < BUZZER_DURATION_MS) {
-        if ((to_ms_since_boot(get_absolute_time()) - last_border_blink) >= BORDER_DUR_MS) {
-          border_on = !border_on;
-          ssd1306_rect(&ssd, 3, 3, 122, 60, border_on, 0);
-          ssd1306_send_data(&ssd);
-          last_border_blink = to_ms_since_boot(get_absolute_time());
-        }
-    }
+// Colunas novas do gráfico. Fora do modo gráfico, ou com o alerta na tela, só a
+// RAM do gráfico é atualizada e o quadro é redesenhado quando ele voltar.
+// Colunas perdidas (laço principal atrasado) repetem o último nível.
+void graph_update(uint32_t columns, int16_t level) {
+    bool visible = oled_graph && !alert_busy(&alert);
+    if (columns > level_graph.width) columns = level_graph.width;
+    for (uint32_t i = 0; i < columns; i++) level_graph_push(&level_graph, visible ? &ssd : NULL, level);
+    if (visible) display_update();
+}
 
-    if (buzzers_enable) {
-        pwm_set_enabled(buzzer_slice, false);
-        pwm_set_chan_level(buzzer_slice, PWM_CHAN_A, 0);
-        pwm_set_chan_level(buzzer_slice, PWM_CHAN_B, 0);
+void show_monitor_screen() {
+    if (oled_graph) {
+        level_graph_draw(&level_graph, &ssd);
+        return;
     }
+    ssd1306_load_frame(&ssd, screen_monitor);
 }
 
+void show_alert_screen() {
+    ssd1306_load_frame(&ssd, screen_alert);
+}
 
-uint32_t matrix_led_color(float red, float green, float blue) {
-    unsigned char G = green * 255;
-    unsigned char R = red * 255;
-    unsigned char B = blue * 255;
-    return (G << 24) | (R << 16) | (B << 8);  // Ordem GRB
+// Marca o framebuffer para envio; a transferência sai por DMA assim que o barramento estiver livre
+void display_update() {
+    display_pending = true;
+    sched_in(&scheduler, task_display, to_ms_since_boot(get_absolute_time()), 0);
 }
 
+void display_service() {
+    if (display_pending && ssd1306_send_data_async(&ssd)) display_pending = false;
+}
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+"""Gera a fonte e as telas fixas do display como tabelas const (executado pelo CMake).
+
+Uso:
+    gen_display_assets.py --font inc/font.txt --screens inc/screens.txt --out-dir build/generated
+
+Produz display_assets.h e display_assets.c com:
+- font_glyphs: um glifo de 8 bytes de coluna por código, de FONT_FIRST (espaço) a
+  FONT_LAST, indexado pelo código Latin-1 (ssd1306_draw_string converte o UTF-8);
+- screen_<nome>: cada tela de screens.txt já desenhada no formato da RAM do
+  ssd1306 (8 bytes por coluna, bit 0 na linha de cima), para ssd1306_load_frame.
+
+Formato de screens.txt (coordenadas em pixels, linhas começando com '#' são comentários):
+    size 128 64              dimensões do display, antes da primeira tela
+    screen nome              começa a tela screen_nome, toda apagada
+    rect x y largura altura  contorno, com os mesmos pixels de ssd1306_rect
+    text x y TEXTO           texto até o fim da linha, células de 8x8 como ssd1306_draw_char
+"""
+
+import argparse
+import os
+
+FONT_FIRST = 0x20
+GLYPH_SIZE = 8
+
+
+def fail(path, line_no, message):
+    raise SystemExit(f"{path}:{line_no}: {message}")
+
+
+def read_font(path):
+    """Retorna {código: [8 bytes de coluna]}."""
+    glyphs = {}
+    code = None
+    rows = []
+    with open(path, encoding="utf-8") as f:
+        for line_no, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line or line.startswith("#") and code is None:
+                continue
+            if line.startswith("char "):
+                if code is not None:
+                    fail(path, line_no, f"glifo U+{code:04X} com {len(rows)} linhas")
+                name = line[5:]
+                ch = " " if name == "space" else name
+                if len(ch) != 1:
+                    fail(path, line_no, f"esperado um caractere: {name!r}")
+                code = ord(ch)
+                if not FONT_FIRST <= code <= 0xFF:
+                    fail(path, line_no, f"{name!r} fora do Latin-1 imprimível")
+                if code in glyphs:
+                    fail(path, line_no, f"{name!r} repetido")
+                rows = []
+                continue
+            if code is None or len(line) != GLYPH_SIZE or set(line) - set("#."):
+                fail(path, line_no, "esperadas 8 linhas de 8 pixels ('#' ou '.') após 'char X'")
+            rows.append(line)
+            if len(rows) == GLYPH_SIZE:
+                glyphs[code] = [sum(1 << r for r in range(GLYPH_SIZE) if rows[r][c] == "#")
+                                for c in range(GLYPH_SIZE)]
+                code = None
+    if code is not None:
+        fail(path, line_no, f"glifo U+{code:04X} incompleto")
+    if glyphs.get(FONT_FIRST) != [0] * GLYPH_SIZE:
+        raise SystemExit(f"{path}: o espaço precisa existir e ser vazio (é o glifo dos códigos sem desenho)")
+    return glyphs
+
+
+class Frame:
+    """Quadro no formato da RAM do ssd1306: byte (x * páginas + página)."""
+
+    def __init__(self, width, height):
+        self.width, self.height, self.pages = width, height, height // 8
+        self.data = bytearray(width * self.pages)
+
+    def pixel(self, x, y, value=True):
+        if 0 <= x < self.width and 0 <= y < self.height:
+            index, bit = x * self.pages + (y >> 3), 1 << (y & 7)
+            self.data[index] = self.data[index] | bit if value else self.data[index] & ~bit
+
+    def rect(self, x, y, w, h):
+        # Como ssd1306_rect: bordas em (x + w - 1) e (y + h - 1) truncadas para 8 bits
+        right, bottom = (x + w - 1) & 0xFF, (y + h - 1) & 0xFF
+        for i in range(x, x + w):
+            self.pixel(i, y)
+            self.pixel(i, bottom)
+        for j in range(y, y + h):
+            self.pixel(x, j)
+            self.pixel(right, j)
+
+    def glyph(self, columns, x, y):
+        # A célula inteira é substituída, como em ssd1306_draw_char
+        for i, bits in enumerate(columns):
+            for r in range(GLYPH_SIZE):
+                self.pixel(x + i, y + r, bits >> r & 1)
+
+
+def read_screens(path, glyphs):
+    """Retorna (largura, altura, [(nome, Frame)]) na ordem do arquivo."""
+    size = None
+    screens = []
+    with open(path, encoding="utf-8") as f:
+        for line_no, raw in enumerate(f, 1):
+            line = raw.rstrip("\n")
+            words = line.split()
+            if not words or words[0].startswith("#"):
+                continue
+            op = words[0]
+            try:
+                if op == "size":
+                    size = int(words[1]), int(words[2])
+                    if size[1] % 8:
+                        fail(path, line_no, "a altura deve ser múltipla de 8")
+                elif op == "screen":
+                    if size is None:
+                        fail(path, line_no, "'size' deve vir antes da primeira tela")
+                    if not words[1].isidentifier() or any(n == words[1] for n, _ in screens):
+                        fail(path, line_no, f"nome inválido ou repetido: {words[1]}")
+                    screens.append((words[1], Frame(*size)))
+                elif not screens:
+                    fail(path, line_no, f"'{op}' fora de uma tela")
+                elif op == "rect":
+                    screens[-1][1].rect(*(int(w) for w in words[1:5]))
+                elif op == "text":
+                    x, y = int(words[1]), int(words[2])
+                    text = line.split(None, 3)[3]
+                    if x < 0 or y < 0 or x + GLYPH_SIZE * len(text) > size[0] or y + GLYPH_SIZE > size[1]:
+                        fail(path, line_no, f"texto não cabe na tela: {text!r}")
+                    for i, ch in enumerate(text):
+                        if ord(ch) not in glyphs:
+                            fail(path, line_no, f"sem glifo para {ch!r}")
+                        screens[-1][1].glyph(glyphs[ord(ch)], x + GLYPH_SIZE * i, y)
+                else:
+                    fail(path, line_no, f"comando desconhecido: {op}")
+            except (IndexError, ValueError):
+                fail(path, line_no, f"argumentos inválidos para '{op}'")
+    if size is None:
+        raise SystemExit(f"{path}: nenhuma tela")
+    return size[0], size[1], screens
+
+
+def c_bytes(data, indent="    ", per_line=16):
+    return "\n".join(indent + ", ".join(f"0x{b:02x}" for b in data[i:i + per_line]) + ","
+                     for i in range(0, len(data), per_line))
+
+
+def glyph_comment(code):
+    ch = chr(code)
+    if code == 0x20:
+        return "espaço"
+    if ch.isprintable() and ch not in "\\":
+        return ch
+    return f"U+{code:04X}"
+
+
+def write(path, text):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--font", required=True)
+    parser.add_argument("--screens", required=True)
+    parser.add_argument("--out-dir", required=True)
+    args = parser.parse_args()
+
+    glyphs = read_font(args.font)
+    width, height, screens = read_screens(args.screens, glyphs)
+    last = max(glyphs)
+    frame_bytes = width * height // 8
+    source = f"inc/{os.path.basename(args.font)} e inc/{os.path.basename(args.screens)}"
+    banner = f"// Gerado por tools/gen_display_assets.py a partir de {source}. Não editar.\n"
+
+    header = [banner, "#ifndef DISPLAY_ASSETS_H", "#define DISPLAY_ASSETS_H", "", "#include <stdint.h>", "",
+              f"#define FONT_FIRST 0x{FONT_FIRST:02X}  // Espaço; códigos abaixo usam o glifo dele",
+              f"#define FONT_LAST 0x{last:02X}",
+              f"#define FONT_GLYPH_BYTES {GLYPH_SIZE}", "",
+              "extern const uint8_t font_glyphs[FONT_LAST - FONT_FIRST + 1][FONT_GLYPH_BYTES];", "",
+              f"#define SCREEN_WIDTH {width}",
+              f"#define SCREEN_HEIGHT {height}",
+              f"#define SCREEN_FRAME_BYTES {frame_bytes}", ""]
+    header += [f"extern const uint8_t screen_{name}[SCREEN_FRAME_BYTES];" for name, _ in screens]
+    header += ["", "#endif", ""]
+
+    body = [banner, '#include "display_assets.h"', "",
+            "const uint8_t font_glyphs[FONT_LAST - FONT_FIRST + 1][FONT_GLYPH_BYTES] = {"]
+    for code in range(FONT_FIRST, last + 1):
+        columns = glyphs.get(code, [0] * GLYPH_SIZE)
+        body.append("    {" + ", ".join(f"0x{b:02x}" for b in columns) + "},"
+                    + (f"  // {glyph_comment(code)}" if code in glyphs else ""))
+    body.append("};")
+    for name, frame in screens:
+        body += ["", f"const uint8_t screen_{name}[SCREEN_FRAME_BYTES] = {{", c_bytes(frame.data), "};"]
+    body.append("")
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    write(os.path.join(args.out_dir, "display_assets.h"), "\n".join(header))
+    write(os.path.join(args.out_dir, "display_assets.c"), "\n".join(body))
+
+
+if __name__ == "__main__":
+    main()
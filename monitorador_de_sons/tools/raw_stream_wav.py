@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""Grava em WAV a captura bruta do monitorador de sons (USB CDC).
+
+Uso:
+    raw_stream_wav.py /dev/ttyACM0 gravacao.wav --seconds 60   # envia 's' para iniciar e parar
+    raw_stream_wav.py captura.bin gravacao.wav                 # arquivo gravado antes (--stream da simulação)
+    raw_stream_wav.py - gravacao.wav < captura.bin             # stdin
+
+O formato dos quadros está documentado em inc/raw_stream.h. Texto do firmware
+entre os quadros é ignorado; quadros com a sequência final inválida (bloco
+sobrescrito durante o envio) são descartados e contados como perdidos. O WAV
+tem 16 bits por amostra, um canal por microfone, com o silêncio nominal em 0.
+"""
+
+import argparse
+import array
+import os
+import struct
+import sys
+import time
+import wave
+
+RAW_STREAM_MAGIC = b"MRAW"
+RAW_STREAM_VERSION = 1
+HEADER = struct.Struct("<4sIIHBBHBB")
+TRAILER = struct.Struct("<I")
+DEFAULT_BAUD = 115200  # Ignorado pelo CDC, que sempre roda na velocidade do USB
+MAX_CHANNELS = 4
+MAX_SAMPLES = 4096
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer
+    if os.path.exists(path) and not path.startswith("/dev/") and not path.upper().startswith("COM"):
+        return open(path, "rb")
+    import serial  # pyserial, só necessário para ler da porta
+    return serial.Serial(path, baud, timeout=0.2)
+
+
+class Parser:
+    """Separa os quadros do fluxo de bytes e os converte em amostras do WAV."""
+
+    def __init__(self, fill_gaps):
+        self.pending = bytearray()
+        self.fill_gaps = fill_gaps
+        self.format = None       # (taxa, amostras por canal, canais, bits fracionários, silêncio)
+        self.last_seq = None
+        self.frames = self.lost = self.invalid = 0
+        self.peak = 0            # Maior |amostra - silêncio|, em LSB do ADC
+
+    def feed(self, data):
+        """Retorna a lista de blocos do WAV (bytes little-endian) completos em `data`."""
+        self.pending += data
+        out = []
+        while True:
+            start = self.pending.find(RAW_STREAM_MAGIC)
+            if start < 0:
+                keep = len(RAW_STREAM_MAGIC) - 1  # O início do marcador pode estar no fim
+                del self.pending[:max(0, len(self.pending) - keep)]
+                return out
+            del self.pending[:start]
+            if len(self.pending) < HEADER.size:
+                return out
+
+            magic, seq, rate, samples, channels, shift, center, version, _ = HEADER.unpack_from(self.pending)
+            if version != RAW_STREAM_VERSION or not 1 <= channels <= MAX_CHANNELS or not 1 <= samples <= MAX_SAMPLES:
+                del self.pending[:1]  # Falso marcador; procura o próximo
+                continue
+            payload = samples * channels * 2
+            size = HEADER.size + payload + TRAILER.size
+            if len(self.pending) < size:
+                return out
+            (trailer,) = TRAILER.unpack_from(self.pending, HEADER.size + payload)
+            if trailer not in (seq, ~seq & 0xFFFFFFFF):
+                del self.pending[:1]  # Quadro truncado ou desalinhado
+                self.invalid += 1
+                continue
+
+            block = array.array("H", bytes(self.pending[HEADER.size:HEADER.size + payload]))
+            del self.pending[:size]
+            if sys.byteorder != "little":
+                block.byteswap()
+            fmt = (rate, samples, channels, shift, center)
+            if self.format is None:
+                self.format = fmt
+            elif fmt != self.format:
+                raise SystemExit(f"formato mudou no meio da captura: {fmt} != {self.format}")
+
+            gap = 0 if self.last_seq is None else (seq - self.last_seq - 1) & 0xFFFFFFFF
+            self.last_seq = seq
+            if trailer != seq:
+                self.invalid += 1
+                gap += 1
+            self.lost += gap
+            if self.fill_gaps and gap:
+                out.append(bytes(gap * samples * channels * 2))
+            if trailer == seq:
+                out.append(self.convert(block))
+                self.frames += 1
+
+    def convert(self, block):
+        rate, samples, channels, shift, center = self.format
+        scale = 4 - shift  # Saída com 16 bits: 12 do ADC + 4 fracionários
+        pcm = array.array("h", bytes(len(block) * 2))
+        for c in range(channels):
+            lane = block[c * samples:(c + 1) * samples]
+            for i, x in enumerate(lane):
+                d = x - center
+                if abs(d) >> shift > self.peak:
+                    self.peak = abs(d) >> shift
+                v = d << scale if scale >= 0 else d >> -scale
+                pcm[i * channels + c] = max(-32768, min(32767, v))
+        if sys.byteorder != "little":
+            pcm.byteswap()
+        return pcm.tobytes()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="porta serial, arquivo binário ou - para stdin")
+    parser.add_argument("output", help="arquivo WAV")
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--seconds", type=float, help="encerra após este tempo de áudio")
+    parser.add_argument("--fill-gaps", action="store_true", help="preenche blocos perdidos com silêncio")
+    parser.add_argument("--no-control", action="store_true", help="não envia 's' à porta para iniciar e parar")
+    parser.add_argument("--raw", help="também grava os bytes recebidos neste arquivo")
+    args = parser.parse_args()
+
+    source = open_input(args.input, args.baud)
+    is_port = hasattr(source, "is_open")
+    control = is_port and not args.no_control
+    raw_out = open(args.raw, "wb") if args.raw else None
+    stream = Parser(args.fill_gaps)
+    wav = None
+    written = 0  # Quadros do WAV (uma amostra por canal)
+
+    if control:
+        source.reset_input_buffer()
+        source.write(b"s")
+    started = time.monotonic()
+    try:
+        while True:
+            # read1 devolve o que já chegou; read esperaria 4096 bytes de um pipe ou pty
+            chunk = source.read1(4096) if hasattr(source, "read1") else source.read(4096)
+            if not chunk:
+                if is_port:
+                    if stream.format is None and time.monotonic() - started > 3:
+                        raise SystemExit("nenhum quadro recebido; o firmware tem a captura bruta?")
+                    continue  # Porta serial: timeout sem dados
+                break
+            if raw_out:
+                raw_out.write(chunk)
+            for pcm in stream.feed(chunk):
+                if wav is None:
+                    rate, _, channels, _, _ = stream.format
+                    wav = wave.open(args.output, "wb")
+                    wav.setnchannels(channels)
+                    wav.setsampwidth(2)
+                    wav.setframerate(rate)
+                wav.writeframes(pcm)
+                written += len(pcm) // (2 * stream.format[2])
+            if args.seconds and stream.format and written >= args.seconds * stream.format[0]:
+                break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if control:
+            source.write(b"s")
+        if wav:
+            wav.close()
+        rate = stream.format[0] if stream.format else 1
+        print(f"{stream.frames} blocos, {written / rate:.2f} s de áudio, {stream.lost} blocos perdidos, "
+              f"{stream.invalid} quadros inválidos, pico de {stream.peak} LSB", file=sys.stderr)
+    if wav is None:
+        raise SystemExit("nenhum quadro válido na entrada")
+
+
+if __name__ == "__main__":
+    main()
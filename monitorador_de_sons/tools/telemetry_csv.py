@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""Decodifica a telemetria binária do monitorador de sons e grava em CSV.
+
+Uso:
+    telemetry_csv.py /dev/ttyUSB0 saida.csv          # porta serial (requer pyserial)
+    telemetry_csv.py captura.bin saida.csv           # arquivo gravado antes
+    telemetry_csv.py - -  < captura.bin              # stdin -> stdout
+
+O formato dos quadros está documentado em inc/telemetry.h.
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+TELEMETRY_VERSION = 1
+TELEMETRY_TYPE_BLOCK = 1
+RECORD = struct.Struct("<BBIIHHHhhHHHH")
+DEFAULT_BAUD = 921600
+
+FIELDS = [
+    "seq", "timestamp_us", "peak", "mean", "peak_samples", "block_db",
+    "laf_db", "alert_peaks", "overruns", "dropped_blocks", "dropped_records",
+]
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame) + 1:
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_record(frame):
+    """Retorna o dicionário do registro, ou None se o quadro for inválido."""
+    raw = cobs_decode(frame)
+    if raw is None or len(raw) != RECORD.size + 2:
+        return None
+    payload, (crc,) = raw[:-2], struct.unpack("<H", raw[-2:])
+    if crc16(payload) != crc:
+        return None
+    values = RECORD.unpack(payload)
+    if values[0] != TELEMETRY_VERSION or values[1] != TELEMETRY_TYPE_BLOCK:
+        return None
+    record = dict(zip(FIELDS, values[2:]))
+    record["block_db"] /= 10
+    record["laf_db"] /= 10
+    return record
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer
+    if os.path.exists(path) and not path.startswith("/dev/") and not path.upper().startswith("COM"):
+        return open(path, "rb")
+    import serial  # pyserial, só necessário para ler da porta
+    return serial.Serial(path, baud, timeout=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="porta serial, arquivo binário ou - para stdin")
+    parser.add_argument("output", help="arquivo CSV ou - para stdout")
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--raw", help="também grava os bytes recebidos neste arquivo")
+    args = parser.parse_args()
+
+    source = open_input(args.input, args.baud)
+    sink = sys.stdout if args.output == "-" else open(args.output, "w", newline="")
+    raw_out = open(args.raw, "wb") if args.raw else None
+    writer = csv.DictWriter(sink, fieldnames=FIELDS)
+    writer.writeheader()
+
+    pending = bytearray()
+    good = bad = 0
+    try:
+        while True:
+            chunk = source.read(4096)
+            if not chunk:
+                if hasattr(source, "is_open"):
+                    continue  # Porta serial: timeout sem dados
+                break
+            if raw_out:
+                raw_out.write(chunk)
+            pending += chunk
+            *frames, pending = pending.split(b"\x00")
+            pending = bytearray(pending)
+            for frame in frames:
+                if not frame:
+                    continue
+                record = decode_record(frame)
+                if record is None:
+                    bad += 1
+                    continue
+                writer.writerow(record)
+                good += 1
+            sink.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print(f"{good} registros, {bad} quadros inválidos", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()